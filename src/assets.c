@@ -0,0 +1,547 @@
+// Generated from the files under "assets/" by "make assets.c". Do not edit.
+
+#include "assets.h"
+
+static const unsigned char assets_panels_air_panel_png[] = {
+  0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d,
+  0x49, 0x48, 0x44, 0x52, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00, 0x20,
+  0x08, 0x06, 0x00, 0x00, 0x00, 0x73, 0x7a, 0x7a, 0xf4, 0x00, 0x00, 0x00,
+  0x01, 0x73, 0x52, 0x47, 0x42, 0x00, 0xae, 0xce, 0x1c, 0xe9, 0x00, 0x00,
+  0x01, 0xf9, 0x49, 0x44, 0x41, 0x54, 0x58, 0x47, 0xed, 0x97, 0xd1, 0x4f,
+  0xda, 0x40, 0x1c, 0xc7, 0xbf, 0xd7, 0x41, 0x67, 0x8b, 0x41, 0xa2, 0xc2,
+  0xb0, 0xb5, 0x6a, 0x25, 0x66, 0x28, 0x59, 0xa2, 0x89, 0x59, 0x36, 0xb3,
+  0x64, 0x71, 0x4f, 0x7b, 0xdb, 0xff, 0xbb, 0xff, 0x00, 0x12, 0xa3, 0x46,
+  0x8d, 0x2c, 0x8b, 0x8b, 0x83, 0x8d, 0x3a, 0x30, 0x2b, 0xa0, 0x1e, 0xad,
+  0x56, 0x6a, 0x7a, 0xa4, 0x45, 0xd8, 0x24, 0x25, 0x45, 0x79, 0xb0, 0xf7,
+  0x74, 0x77, 0xfd, 0xde, 0x7d, 0x3f, 0xf7, 0xed, 0xc3, 0xdd, 0x8f, 0xa0,
+  0xaf, 0x7d, 0xce, 0xc6, 0xed, 0x97, 0x46, 0x77, 0x92, 0xe7, 0xf9, 0x7e,
+  0xc9, 0xc0, 0xf1, 0x8d, 0xcd, 0x3d, 0xf8, 0x9d, 0x9a, 0x55, 0x7c, 0x2d,
+  0x81, 0xdc, 0x17, 0xf4, 0x0c, 0xde, 0xa5, 0x61, 0x27, 0x12, 0x71, 0xac,
+  0xad, 0x29, 0x9e, 0x66, 0xa6, 0x47, 0x01, 0xb4, 0x89, 0x35, 0x14, 0x50,
+  0xab, 0x15, 0x61, 0xfa, 0x73, 0x2b, 0x86, 0xd3, 0xe3, 0x02, 0x1a, 0x96,
+  0x88, 0x7c, 0x85, 0x7a, 0xbb, 0x7a, 0x1d, 0xc7, 0xdc, 0x11, 0x6e, 0x6d,
+  0xe5, 0x70, 0x56, 0xfd, 0xc3, 0x16, 0xf1, 0x46, 0x37, 0x8a, 0x89, 0xe1,
+  0x7c, 0x3d, 0xc8, 0x56, 0x34, 0xca, 0xfa, 0x35, 0x33, 0x82, 0xf9, 0x39,
+  0x15, 0xfb, 0x07, 0x87, 0x6c, 0xec, 0x42, 0x30, 0x00, 0x27, 0xf6, 0x7a,
+  0xbd, 0x89, 0x8d, 0xdc, 0x32, 0x1a, 0x66, 0x13, 0x07, 0xf9, 0xf3, 0xa1,
+  0x4e, 0xe9, 0x57, 0xac, 0xac, 0x26, 0xc1, 0x93, 0x28, 0xb4, 0x5a, 0x1d,
+  0x53, 0x11, 0xca, 0x7e, 0x07, 0xf9, 0x92, 0x9b, 0xb4, 0xcd, 0x5b, 0x0e,
+  0xaa, 0x3c, 0xfb, 0xa8, 0xe6, 0x2e, 0xa4, 0x30, 0x0b, 0x48, 0x29, 0x09,
+  0x54, 0xaf, 0xb0, 0x29, 0x06, 0x20, 0xa5, 0x53, 0x4f, 0x62, 0xee, 0x42,
+  0x24, 0xd7, 0xe7, 0x90, 0x22, 0x4d, 0xe8, 0x97, 0xb7, 0x1d, 0x00, 0x41,
+  0x4c, 0xe0, 0x68, 0xef, 0x97, 0xdf, 0x24, 0x03, 0xeb, 0x24, 0x05, 0xc8,
+  0x2c, 0x4b, 0x38, 0xa9, 0xfc, 0x05, 0xf9, 0x98, 0x9d, 0xb6, 0x63, 0x9c,
+  0x88, 0xf2, 0xf7, 0x67, 0x04, 0xa0, 0x66, 0x04, 0xa8, 0x4b, 0x69, 0x14,
+  0x4b, 0xda, 0x78, 0x12, 0x08, 0x01, 0xc2, 0x04, 0xc2, 0x04, 0xc2, 0x04,
+  0xc2, 0x04, 0xc6, 0x9e, 0x80, 0xf2, 0x06, 0x50, 0x52, 0x71, 0x9c, 0x96,
+  0xae, 0x3b, 0x77, 0x41, 0x62, 0x52, 0xc0, 0x8f, 0xfd, 0xdf, 0x81, 0xaf,
+  0x59, 0xbf, 0x1b, 0xf4, 0x00, 0xbc, 0x97, 0x61, 0xcb, 0xca, 0x22, 0xbe,
+  0xed, 0xfc, 0xf4, 0xbb, 0x3e, 0xb0, 0xee, 0xbf, 0x00, 0xe4, 0x85, 0x85,
+  0x62, 0xe1, 0x69, 0x52, 0x58, 0xd9, 0x8c, 0x41, 0x14, 0x66, 0x50, 0x3b,
+  0xab, 0x82, 0x38, 0x09, 0x38, 0x47, 0x9a, 0x5f, 0x92, 0x01, 0xb4, 0x51,
+  0x2c, 0x68, 0x81, 0x4f, 0x38, 0x68, 0x83, 0xcd, 0x0f, 0x19, 0xe8, 0x94,
+  0x82, 0x6a, 0x1d, 0x1f, 0xf6, 0x2a, 0xde, 0x7e, 0x1d, 0x65, 0x10, 0x0b,
+  0xf2, 0x34, 0xa8, 0xc9, 0x3d, 0x1a, 0x84, 0x6b, 0xae, 0x95, 0x1b, 0xdd,
+  0x57, 0xb1, 0x4b, 0xeb, 0x40, 0x90, 0xb6, 0x8d, 0xd5, 0x6c, 0x1a, 0x17,
+  0xfa, 0x15, 0x76, 0xf3, 0xfa, 0x48, 0x93, 0x50, 0xdf, 0x66, 0xc0, 0x59,
+  0x14, 0x8e, 0xf9, 0x3f, 0x75, 0x81, 0xeb, 0xf4, 0x69, 0x25, 0xc2, 0x92,
+  0xe0, 0x27, 0xe2, 0x6c, 0xea, 0x55, 0x52, 0x0a, 0x04, 0x71, 0x81, 0x1b,
+  0x6f, 0xbd, 0x65, 0x5a, 0x30, 0xca, 0x27, 0x0f, 0x57, 0x46, 0xf7, 0x21,
+  0xae, 0x8d, 0x4e, 0x39, 0x35, 0xea, 0x26, 0x12, 0x63, 0x70, 0x6d, 0x38,
+  0x6a, 0x43, 0x3f, 0xfb, 0xf5, 0x95, 0x9e, 0x7e, 0x96, 0x8c, 0x56, 0x33,
+  0x76, 0x80, 0x3b, 0x8a, 0x26, 0x16, 0xde, 0xe3, 0x12, 0xe8, 0x8a, 0x00,
+  0x00, 0x00, 0x00, 0x49, 0x45, 0x4e, 0x44, 0xae, 0x42, 0x60, 0x82, 0x00
+};
+
+static const unsigned char assets_panels_fire_panel_png[] = {
+  0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d,
+  0x49, 0x48, 0x44, 0x52, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00, 0x20,
+  0x08, 0x06, 0x00, 0x00, 0x00, 0x73, 0x7a, 0x7a, 0xf4, 0x00, 0x00, 0x00,
+  0x01, 0x73, 0x52, 0x47, 0x42, 0x00, 0xae, 0xce, 0x1c, 0xe9, 0x00, 0x00,
+  0x03, 0x32, 0x49, 0x44, 0x41, 0x54, 0x58, 0x47, 0xe5, 0x97, 0x4b, 0x4f,
+  0x13, 0x51, 0x14, 0xc7, 0xff, 0x33, 0x7d, 0x17, 0xac, 0x4d, 0x0b, 0xb5,
+  0xb4, 0x1d, 0xa1, 0x54, 0xe4, 0x15, 0x6a, 0x9b, 0x54, 0xa2, 0xc4, 0x68,
+  0x74, 0xe5, 0xce, 0xc4, 0xc8, 0x37, 0x70, 0xe5, 0xda, 0x85, 0xaf, 0xc4,
+  0x10, 0x1f, 0x31, 0xd1, 0xad, 0x0b, 0x3f, 0x08, 0x1b, 0x37, 0x24, 0xee,
+  0xa8, 0x28, 0x05, 0x54, 0x8a, 0x04, 0x03, 0x54, 0x69, 0xa5, 0x40, 0xcb,
+  0xc3, 0xe9, 0x6b, 0xa6, 0x63, 0xee, 0x94, 0x99, 0x3e, 0x94, 0x96, 0xb6,
+  0x03, 0x2e, 0x3c, 0xab, 0xb9, 0x77, 0xce, 0x3d, 0xe7, 0x77, 0xce, 0x9c,
+  0x39, 0xf7, 0x5e, 0x0a, 0x15, 0x72, 0xbd, 0xcf, 0x24, 0xe8, 0xd2, 0xc5,
+  0x49, 0xad, 0x56, 0x5b, 0xa9, 0x52, 0x75, 0x9c, 0x13, 0xe8, 0x03, 0xdf,
+  0xb3, 0x99, 0x75, 0xbc, 0x5d, 0x05, 0x55, 0xaa, 0x50, 0x36, 0xb8, 0x60,
+  0x87, 0x60, 0x36, 0x9b, 0x30, 0x30, 0xc0, 0xc8, 0x3a, 0xd6, 0x32, 0x0d,
+  0x20, 0x4f, 0x71, 0x75, 0x01, 0xa5, 0x52, 0x6a, 0x51, 0x7f, 0x83, 0x6b,
+  0xc1, 0xf2, 0x7c, 0x10, 0xdb, 0x9c, 0x11, 0x93, 0x6b, 0xac, 0x6c, 0x55,
+  0x7e, 0x20, 0xce, 0x89, 0xe2, 0xc8, 0xc8, 0x20, 0x62, 0xeb, 0x3f, 0xc5,
+  0x45, 0xda, 0x74, 0x31, 0x15, 0xfa, 0xfa, 0xfc, 0xca, 0x90, 0x29, 0x8d,
+  0x46, 0x7c, 0x8e, 0x67, 0xd4, 0x70, 0x75, 0xb8, 0x31, 0x33, 0xf7, 0x49,
+  0x1c, 0x4b, 0x10, 0x22, 0x00, 0x49, 0x7b, 0x32, 0xb9, 0x03, 0xff, 0x60,
+  0x37, 0xb6, 0x33, 0x3b, 0x98, 0x9b, 0xdc, 0xa8, 0x2b, 0xca, 0xc3, 0x2a,
+  0x33, 0xfd, 0xed, 0xd0, 0x52, 0x1a, 0x44, 0xe3, 0x49, 0x9c, 0x54, 0xb3,
+  0xe2, 0xe7, 0xa0, 0x6e, 0x0c, 0xb6, 0x0a, 0x19, 0x9e, 0x86, 0xdb, 0xd9,
+  0x76, 0xa4, 0xce, 0x25, 0x48, 0x43, 0x1b, 0xe0, 0xb0, 0x39, 0xc0, 0x26,
+  0xd6, 0xc4, 0x29, 0x11, 0xc0, 0x61, 0xb7, 0x1d, 0x8b, 0x73, 0x09, 0xa2,
+  0xdd, 0xd7, 0x01, 0x1b, 0xb5, 0x83, 0xc4, 0x1e, 0x5f, 0x00, 0x30, 0x18,
+  0xcd, 0xf8, 0x1c, 0xfa, 0x7e, 0xd8, 0x4c, 0x36, 0xad, 0xe7, 0x60, 0x00,
+  0x4f, 0xb7, 0x03, 0x4b, 0x6b, 0x5b, 0xa0, 0xae, 0xf4, 0x59, 0x84, 0x16,
+  0xda, 0x88, 0xc8, 0xe2, 0x7f, 0x04, 0xe0, 0xf6, 0x18, 0xe0, 0xee, 0xb2,
+  0x23, 0xbc, 0x1a, 0x6d, 0x3c, 0x03, 0xb3, 0x59, 0x01, 0x3c, 0xcf, 0x43,
+  0xa5, 0x52, 0x21, 0x9f, 0xcf, 0xc3, 0xa7, 0x57, 0x1d, 0xfa, 0xd3, 0x34,
+  0x05, 0x20, 0x39, 0xf6, 0x1b, 0x0a, 0x0d, 0x46, 0x92, 0xa9, 0xbd, 0x0c,
+  0x04, 0x41, 0xc0, 0xf9, 0x13, 0xfa, 0x9a, 0x20, 0x0d, 0x03, 0x10, 0xe7,
+  0x5e, 0x6d, 0xb1, 0x35, 0xbe, 0xcb, 0x01, 0x97, 0x0b, 0x7d, 0x46, 0x96,
+  0xa7, 0xd3, 0x0b, 0x78, 0xe4, 0xef, 0xad, 0x0a, 0xa1, 0x18, 0xc0, 0x2c,
+  0x34, 0x00, 0xc7, 0xc1, 0xab, 0x16, 0x9b, 0xa8, 0x28, 0xcf, 0x42, 0x5f,
+  0xf1, 0xd0, 0x77, 0x56, 0x79, 0x80, 0xca, 0xe8, 0x27, 0x6e, 0x02, 0xa9,
+  0x14, 0xe0, 0x62, 0x28, 0xf0, 0xaf, 0x05, 0xf8, 0x4b, 0x32, 0x51, 0x2b,
+  0x0b, 0x0d, 0x65, 0xa0, 0x14, 0x60, 0x96, 0xd6, 0x01, 0x77, 0x80, 0xcd,
+  0x5b, 0x19, 0x58, 0xc7, 0xcd, 0xc8, 0x6f, 0x25, 0x41, 0x8f, 0x33, 0xf0,
+  0xc6, 0x22, 0x62, 0xe4, 0xcf, 0x67, 0x16, 0xf1, 0xe0, 0x5c, 0xcf, 0x81,
+  0x59, 0x68, 0x08, 0x20, 0xb8, 0x93, 0xc2, 0xb0, 0xc9, 0x20, 0x1a, 0x15,
+  0x01, 0x6e, 0x67, 0x11, 0x1b, 0x15, 0x60, 0x77, 0xa9, 0xc1, 0xbf, 0xe4,
+  0x90, 0x7b, 0x03, 0x0c, 0xef, 0x67, 0xe1, 0xc5, 0xdc, 0x12, 0xee, 0x0d,
+  0x79, 0x94, 0x05, 0x78, 0xbf, 0x9b, 0x96, 0x2b, 0x3c, 0x94, 0x03, 0x36,
+  0x47, 0x01, 0x9a, 0x06, 0xac, 0x0e, 0x1d, 0x60, 0xb1, 0x00, 0x63, 0x71,
+  0x78, 0xf7, 0xb7, 0xea, 0xb1, 0xa9, 0x2f, 0x78, 0x1c, 0x18, 0x50, 0x16,
+  0x80, 0x58, 0x0b, 0xa5, 0x79, 0xf9, 0x7f, 0x9f, 0xc8, 0x01, 0x29, 0x00,
+  0x76, 0x00, 0xe4, 0x08, 0xe2, 0xdb, 0x8f, 0xfe, 0xd5, 0xfc, 0x0a, 0xee,
+  0xf6, 0x77, 0x2a, 0x5f, 0x84, 0xc4, 0x22, 0xf9, 0xd7, 0x03, 0xad, 0xba,
+  0xaa, 0xc6, 0x6b, 0x15, 0x20, 0x59, 0xdc, 0x50, 0x0d, 0x48, 0x5e, 0x49,
+  0x81, 0x11, 0xa9, 0x2c, 0x32, 0x32, 0x4f, 0x51, 0x14, 0xee, 0x7b, 0xcf,
+  0x1c, 0x5d, 0x23, 0x2a, 0xb5, 0xfc, 0xe4, 0x63, 0x18, 0xe4, 0xbc, 0x48,
+  0xda, 0x30, 0x71, 0x5c, 0xad, 0xe8, 0x2a, 0x89, 0x98, 0x21, 0x80, 0xb1,
+  0x99, 0xb0, 0xbc, 0x9a, 0x2d, 0xec, 0x05, 0xe6, 0x56, 0x03, 0xbe, 0xcd,
+  0xfc, 0xa8, 0x49, 0xae, 0x94, 0x42, 0x19, 0xc0, 0x45, 0x27, 0x04, 0x27,
+  0xd3, 0x89, 0x85, 0x0f, 0x2b, 0x4a, 0xd9, 0xaf, 0x69, 0xe7, 0xaf, 0x00,
+  0x94, 0x8a, 0x43, 0x38, 0x78, 0x3c, 0x59, 0xe8, 0x09, 0xb4, 0xc0, 0x68,
+  0xb0, 0x22, 0x1e, 0x5b, 0x07, 0x45, 0x32, 0x40, 0x90, 0x5d, 0x5d, 0x4e,
+  0x00, 0x79, 0x84, 0x83, 0xd1, 0x9a, 0x11, 0x34, 0xa3, 0x10, 0xb8, 0xe4,
+  0x41, 0x82, 0x65, 0xc1, 0x46, 0x0b, 0x7e, 0xc4, 0xad, 0xed, 0x6a, 0xaf,
+  0x46, 0x84, 0x38, 0xed, 0xb4, 0x80, 0xcd, 0xd0, 0x47, 0x06, 0x21, 0x39,
+  0x8f, 0x46, 0xb6, 0x8b, 0xa7, 0x62, 0x29, 0x1a, 0x02, 0x41, 0xe5, 0x05,
+  0xf4, 0xf7, 0xd9, 0xb1, 0x9b, 0xf8, 0x85, 0xe9, 0xc9, 0x44, 0x33, 0x81,
+  0xfe, 0xb1, 0xd6, 0x3d, 0xec, 0x01, 0xcd, 0xb1, 0x20, 0xce, 0x89, 0x94,
+  0xdd, 0x0b, 0x24, 0xed, 0x6b, 0x3d, 0x85, 0x7d, 0x55, 0xab, 0x37, 0x89,
+  0x53, 0xa7, 0xda, 0x1d, 0x4d, 0x41, 0xec, 0x22, 0x27, 0xaf, 0xe7, 0x32,
+  0x1c, 0xd2, 0x91, 0xa5, 0x83, 0x6f, 0x46, 0xa5, 0x10, 0xd9, 0x74, 0xf9,
+  0x69, 0xa7, 0x29, 0x8a, 0x92, 0xc5, 0x46, 0x2a, 0x5d, 0xfd, 0x6e, 0xa8,
+  0x94, 0xa3, 0x7a, 0xec, 0x54, 0x5c, 0x3d, 0xeb, 0x59, 0xaa, 0x8c, 0xee,
+  0x3f, 0x07, 0xf8, 0x0d, 0x24, 0xa2, 0x8f, 0xde, 0x6e, 0x3b, 0xd9, 0x1d,
+  0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4e, 0x44, 0xae, 0x42, 0x60, 0x82
+};
+
+static const unsigned char assets_panels_sand_panel_png[] = {
+  0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d,
+  0x49, 0x48, 0x44, 0x52, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00, 0x20,
+  0x08, 0x06, 0x00, 0x00, 0x00, 0x73, 0x7a, 0x7a, 0xf4, 0x00, 0x00, 0x00,
+  0x01, 0x73, 0x52, 0x47, 0x42, 0x00, 0xae, 0xce, 0x1c, 0xe9, 0x00, 0x00,
+  0x03, 0x68, 0x49, 0x44, 0x41, 0x54, 0x58, 0x47, 0xe5, 0x97, 0xcd, 0x4f,
+  0x13, 0x41, 0x18, 0xc6, 0x9f, 0xd9, 0x76, 0x97, 0xb6, 0x94, 0x5a, 0x8a,
+  0xc5, 0xd2, 0x52, 0xa0, 0x54, 0xa4, 0x80, 0x1f, 0x90, 0xa0, 0x51, 0x62,
+  0x34, 0x1a, 0x13, 0xbd, 0x79, 0x32, 0xc6, 0xf8, 0x6f, 0x78, 0xf0, 0x33,
+  0x26, 0x6a, 0x4c, 0xbc, 0x78, 0xf6, 0x68, 0xbc, 0xe8, 0xd5, 0xab, 0x17,
+  0x0f, 0xc4, 0x44, 0x10, 0x85, 0xfa, 0x11, 0xab, 0x7c, 0x55, 0x40, 0xca,
+  0x77, 0x4b, 0x29, 0xdb, 0xdd, 0x76, 0xb7, 0x6b, 0x66, 0x48, 0x4b, 0x8b,
+  0x50, 0x28, 0x6d, 0xf1, 0xe0, 0x9c, 0x76, 0x67, 0xdf, 0x79, 0x9f, 0xdf,
+  0xfb, 0xec, 0xec, 0xec, 0x0c, 0xc1, 0x86, 0x76, 0xc9, 0x67, 0xd1, 0x2a,
+  0xa4, 0xf5, 0x4e, 0x41, 0x10, 0x36, 0x86, 0xe4, 0xbd, 0x4f, 0x6a, 0xdc,
+  0x96, 0xcf, 0x45, 0x79, 0x0e, 0x6f, 0x26, 0x40, 0xb2, 0x03, 0x72, 0x6e,
+  0x4e, 0x3a, 0xa0, 0x59, 0xad, 0x16, 0xb4, 0xb7, 0xbb, 0x33, 0x31, 0x35,
+  0x39, 0x11, 0x40, 0x8a, 0x28, 0x05, 0x01, 0xc5, 0xe3, 0x7a, 0x16, 0xbf,
+  0xa0, 0x54, 0x22, 0xf8, 0xbd, 0x1f, 0xcb, 0x8a, 0x09, 0x7d, 0xd3, 0x62,
+  0x26, 0x6b, 0xe6, 0x82, 0x8a, 0xd3, 0xc0, 0x9e, 0x9e, 0x0e, 0xcc, 0xcc,
+  0xcd, 0xb2, 0x41, 0x82, 0xb4, 0x6e, 0x85, 0xa1, 0x30, 0xdd, 0x0c, 0x64,
+  0x9c, 0xe7, 0xd9, 0xf5, 0xbc, 0xac, 0x47, 0x7d, 0x9d, 0x07, 0xfe, 0x2f,
+  0x5f, 0xd9, 0x7d, 0x1a, 0x82, 0x01, 0x50, 0xdb, 0x23, 0x91, 0x28, 0xba,
+  0x3a, 0x9a, 0xb1, 0x2c, 0x47, 0xf1, 0xa5, 0x6f, 0xa1, 0xa0, 0x2a, 0x77,
+  0x1a, 0xec, 0x6e, 0xb3, 0x43, 0x20, 0x3c, 0x42, 0xf3, 0x11, 0xec, 0xd3,
+  0x8b, 0xec, 0x75, 0x90, 0xcb, 0x1d, 0x66, 0x4d, 0x56, 0x39, 0x78, 0x5c,
+  0xfb, 0xcb, 0x2a, 0x9e, 0x86, 0x34, 0xee, 0x07, 0x9c, 0xb5, 0x4e, 0x88,
+  0xe1, 0x69, 0xd6, 0xc5, 0x00, 0x9c, 0x8e, 0xda, 0x3d, 0x11, 0x4f, 0x43,
+  0xd8, 0x3b, 0xeb, 0x50, 0x4b, 0xa2, 0x08, 0xc7, 0xd4, 0x35, 0x00, 0xa3,
+  0xc9, 0x8a, 0x6f, 0x43, 0x53, 0x3b, 0x75, 0xb2, 0xe8, 0x38, 0xa7, 0x1b,
+  0xf0, 0x36, 0x3b, 0x31, 0x3a, 0xbd, 0x04, 0x72, 0xd6, 0x67, 0xd3, 0x2a,
+  0x39, 0x13, 0x26, 0x87, 0xff, 0x23, 0x00, 0x8f, 0xd7, 0x08, 0x4f, 0x93,
+  0x03, 0x81, 0x89, 0xd0, 0xee, 0x1d, 0xf8, 0x9c, 0xd0, 0xa0, 0xaa, 0x2a,
+  0x74, 0x3a, 0x1d, 0x52, 0xa9, 0x14, 0x3a, 0x0d, 0xba, 0x1d, 0xbf, 0x9a,
+  0xa2, 0x00, 0xd2, 0xc2, 0x5d, 0xc6, 0xb5, 0x05, 0x26, 0xdd, 0x06, 0x62,
+  0x32, 0x34, 0x4d, 0xc3, 0xf1, 0x2a, 0xc3, 0xb6, 0x20, 0xbb, 0x06, 0xa0,
+  0xe2, 0x47, 0x85, 0x0d, 0x4b, 0x63, 0x96, 0xdc, 0x8b, 0xde, 0x47, 0x98,
+  0x30, 0x5f, 0xc1, 0xdd, 0xae, 0xd6, 0xbc, 0x10, 0x65, 0x01, 0x78, 0xf5,
+  0xfe, 0x09, 0xcc, 0xc6, 0x2a, 0xf8, 0xb5, 0x0b, 0xb8, 0xd3, 0x79, 0xa8,
+  0xf4, 0x00, 0x9b, 0x55, 0xff, 0xda, 0xff, 0x94, 0x09, 0xc5, 0xe3, 0x49,
+  0xc4, 0x56, 0x57, 0x31, 0x32, 0x12, 0x84, 0xcf, 0x77, 0x10, 0x53, 0x96,
+  0xab, 0x79, 0x5d, 0xd8, 0x95, 0x03, 0x14, 0x20, 0x38, 0xf4, 0x0c, 0xd3,
+  0x8b, 0x53, 0x30, 0x99, 0x8d, 0xe0, 0x75, 0x3c, 0x08, 0x07, 0x44, 0xc2,
+  0x51, 0xe8, 0x05, 0x1d, 0x34, 0x15, 0xe0, 0x2b, 0xf4, 0xe0, 0x38, 0x8e,
+  0x01, 0xdc, 0x3e, 0xd6, 0xb2, 0xa5, 0x0b, 0xbb, 0x02, 0xe8, 0x8f, 0xc6,
+  0x31, 0x13, 0x78, 0x8e, 0x88, 0xbc, 0x08, 0x39, 0x9e, 0xc0, 0xe8, 0x78,
+  0x10, 0x4d, 0x0d, 0x6e, 0x58, 0xab, 0x2d, 0xcc, 0x7a, 0x47, 0x9d, 0x09,
+  0xe3, 0xc3, 0x31, 0x2c, 0x2d, 0x45, 0x10, 0x6e, 0xba, 0x86, 0x9b, 0x47,
+  0xbc, 0xa5, 0x05, 0xf8, 0xb0, 0x22, 0xe1, 0xe7, 0xe7, 0xa7, 0xa8, 0xe2,
+  0xab, 0x33, 0x10, 0x5d, 0x9d, 0xcd, 0x18, 0x19, 0x9b, 0x85, 0x24, 0xcb,
+  0x50, 0x15, 0x15, 0x16, 0x83, 0x1d, 0x15, 0xbc, 0x1e, 0x83, 0xdc, 0x19,
+  0xdc, 0xef, 0x6e, 0x2f, 0x2d, 0x00, 0xcd, 0x36, 0x24, 0xa9, 0x78, 0xf7,
+  0xf6, 0x1e, 0xaa, 0x4c, 0x95, 0x90, 0x24, 0x19, 0x84, 0x80, 0x39, 0x71,
+  0xb8, 0xbd, 0x15, 0x56, 0x4b, 0x35, 0x96, 0x63, 0x11, 0x84, 0x6c, 0xd7,
+  0x71, 0xa3, 0xad, 0xb1, 0xf4, 0x93, 0x90, 0x66, 0xa4, 0xdf, 0xfa, 0x40,
+  0xef, 0x03, 0xd4, 0x39, 0x6b, 0xd8, 0xc4, 0xd3, 0x52, 0x60, 0xf3, 0x20,
+  0x91, 0x4c, 0x22, 0x91, 0x48, 0xb0, 0x79, 0x30, 0x6b, 0xbf, 0x5e, 0xbe,
+  0xcf, 0x90, 0x42, 0x3c, 0xf6, 0x0f, 0xb3, 0xea, 0x9c, 0x91, 0x97, 0x48,
+  0xca, 0x0a, 0x52, 0xb2, 0x00, 0x9b, 0xcd, 0x8a, 0x61, 0xf3, 0x45, 0x10,
+  0x42, 0x70, 0xeb, 0xe8, 0xc1, 0xf2, 0x2d, 0x44, 0xd9, 0x99, 0x1f, 0x7e,
+  0x0a, 0x80, 0xee, 0x17, 0xe9, 0x32, 0x4c, 0x85, 0xf3, 0x4d, 0xba, 0x8d,
+  0x44, 0xee, 0x23, 0x80, 0xbb, 0xd6, 0x82, 0xe0, 0x44, 0x62, 0xed, 0x5f,
+  0x60, 0x35, 0x1b, 0x31, 0xe6, 0xff, 0xbd, 0x2d, 0x79, 0xa9, 0x02, 0x72,
+  0x00, 0x4e, 0xb9, 0xa0, 0xb9, 0xdc, 0x8d, 0xf8, 0xf1, 0xf1, 0x57, 0xa9,
+  0xf2, 0x6f, 0x9b, 0x67, 0x53, 0x00, 0xa2, 0x53, 0x10, 0xe8, 0xdf, 0x1b,
+  0x17, 0x5a, 0xba, 0x2b, 0x61, 0x32, 0xd6, 0x60, 0x7e, 0x66, 0x0e, 0x84,
+  0x3a, 0x40, 0x91, 0xeb, 0x9b, 0x5c, 0x00, 0x52, 0x08, 0xf4, 0x87, 0xb6,
+  0xad, 0xa0, 0x98, 0x80, 0xee, 0xd3, 0x5e, 0x84, 0x45, 0x11, 0x62, 0x68,
+  0x4d, 0x87, 0xfd, 0xda, 0xce, 0xb5, 0xf2, 0x0c, 0xa2, 0xc1, 0x65, 0x83,
+  0x28, 0x73, 0x65, 0x83, 0x48, 0x8b, 0x87, 0x26, 0x97, 0xd7, 0x77, 0xc5,
+  0xe9, 0x6a, 0x28, 0x04, 0x49, 0x69, 0x68, 0xf3, 0x39, 0xb0, 0x12, 0x5e,
+  0xc5, 0x60, 0x5f, 0xb8, 0x98, 0x42, 0xff, 0x1a, 0xeb, 0x39, 0xe1, 0x05,
+  0xa7, 0x88, 0xa0, 0xe2, 0xb4, 0xe5, 0x9c, 0x0b, 0xd2, 0xd1, 0xe7, 0x5b,
+  0xf4, 0xcc, 0x09, 0xc1, 0x60, 0x61, 0x5d, 0x07, 0xec, 0xce, 0xa2, 0x20,
+  0x56, 0x90, 0xcc, 0x8c, 0x57, 0x64, 0x05, 0xd2, 0xe4, 0xe8, 0xd6, 0x27,
+  0xa3, 0x6c, 0x88, 0x84, 0x94, 0xbb, 0xdb, 0x29, 0x8a, 0x22, 0x6b, 0xb0,
+  0x89, 0x48, 0xf9, 0xcf, 0x86, 0xa5, 0x12, 0x2a, 0x24, 0xcf, 0xd6, 0xfb,
+  0xab, 0x42, 0xb2, 0x14, 0x11, 0xfb, 0xcf, 0x01, 0xfe, 0x00, 0x98, 0xd1,
+  0xba, 0xde, 0x59, 0xcb, 0x78, 0x6a, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45,
+  0x4e, 0x44, 0xae, 0x42, 0x60, 0x82
+};
+
+static const unsigned char assets_panels_steam_panel_png[] = {
+  0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d,
+  0x49, 0x48, 0x44, 0x52, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00, 0x20,
+  0x08, 0x06, 0x00, 0x00, 0x00, 0x73, 0x7a, 0x7a, 0xf4, 0x00, 0x00, 0x00,
+  0x01, 0x73, 0x52, 0x47, 0x42, 0x00, 0xae, 0xce, 0x1c, 0xe9, 0x00, 0x00,
+  0x03, 0x34, 0x49, 0x44, 0x41, 0x54, 0x58, 0x47, 0xe5, 0x97, 0xcb, 0x4f,
+  0x13, 0x51, 0x14, 0xc6, 0xbf, 0xe9, 0x8b, 0xb6, 0x60, 0x6d, 0x28, 0x94,
+  0xa1, 0x0f, 0xdb, 0xa1, 0xb6, 0x14, 0x08, 0x58, 0x62, 0x21, 0x48, 0x4c,
+  0x8c, 0x46, 0x13, 0x5d, 0x18, 0xfd, 0x07, 0x4c, 0xfc, 0x23, 0x5c, 0xf8,
+  0x4a, 0x8c, 0xf1, 0x11, 0x17, 0xae, 0xdd, 0xb8, 0x74, 0xe5, 0xce, 0xc4,
+  0x9d, 0x31, 0x6e, 0xd8, 0x48, 0x41, 0x69, 0x45, 0xa1, 0x48, 0x10, 0x4a,
+  0xb1, 0x45, 0x20, 0x16, 0x0a, 0x4e, 0x5b, 0x68, 0x3b, 0xe6, 0x4e, 0x33,
+  0x43, 0x67, 0x94, 0x96, 0x3e, 0xc0, 0x85, 0x77, 0x35, 0x73, 0xe6, 0xbb,
+  0xe7, 0xfb, 0xdd, 0x33, 0x67, 0xee, 0xcc, 0x50, 0x90, 0x8d, 0x8b, 0x5e,
+  0x03, 0xd7, 0x90, 0xde, 0x0d, 0x6a, 0x34, 0x1a, 0xb9, 0xa4, 0xe4, 0xf9,
+  0x0e, 0xa7, 0xd8, 0xf3, 0x3a, 0x9b, 0x59, 0xc1, 0x9b, 0x45, 0x50, 0xc5,
+  0x02, 0xc9, 0xc9, 0x10, 0x0d, 0xce, 0x68, 0x34, 0xa0, 0xbb, 0xdb, 0x2e,
+  0x6a, 0x4c, 0x12, 0x05, 0x90, 0xa7, 0xb2, 0x15, 0x01, 0xa5, 0x52, 0x2a,
+  0x5e, 0xbf, 0x96, 0x6d, 0xc4, 0xc2, 0x74, 0x00, 0x1b, 0x59, 0x3d, 0x46,
+  0x63, 0xac, 0x98, 0x55, 0x3c, 0x20, 0xe6, 0x44, 0x38, 0x3c, 0xdc, 0x83,
+  0xe5, 0x95, 0x1f, 0xfc, 0x24, 0x4d, 0x7a, 0xb7, 0x14, 0xda, 0xca, 0x7c,
+  0x45, 0xc8, 0x94, 0x5a, 0xcd, 0x1f, 0xaf, 0x66, 0x54, 0xb0, 0xb5, 0x33,
+  0x08, 0x4d, 0x7e, 0xe6, 0xcf, 0x05, 0x08, 0x1e, 0x80, 0x94, 0x7d, 0x7d,
+  0x3d, 0x89, 0xfe, 0x9e, 0x0e, 0x6c, 0x64, 0x92, 0x98, 0x1c, 0x5d, 0xab,
+  0x68, 0x95, 0xfb, 0x15, 0xdb, 0xbb, 0x5a, 0xa1, 0xa1, 0xd4, 0x88, 0xaf,
+  0xae, 0xe3, 0xa8, 0x8a, 0xe5, 0x6f, 0x07, 0x75, 0xa5, 0xa7, 0x89, 0xcb,
+  0xe4, 0x14, 0x60, 0xac, 0x2d, 0x07, 0x6a, 0x2e, 0x40, 0xea, 0x5a, 0x00,
+  0x8b, 0xd9, 0x02, 0x36, 0x11, 0xe3, 0x43, 0x3c, 0x80, 0x85, 0x36, 0x1f,
+  0x8a, 0xb9, 0x00, 0xd1, 0xea, 0x6b, 0x87, 0x99, 0x4a, 0x22, 0xb1, 0x95,
+  0x2b, 0x00, 0xe8, 0xf4, 0x46, 0x7c, 0x09, 0x2e, 0xed, 0xb7, 0x92, 0x35,
+  0xeb, 0x2c, 0x76, 0xc0, 0xd5, 0x61, 0xc1, 0x5c, 0xec, 0x27, 0xa8, 0x33,
+  0xde, 0x66, 0xae, 0x51, 0xa1, 0x47, 0x74, 0xf6, 0x3f, 0x02, 0x60, 0x5c,
+  0x3a, 0x30, 0x4e, 0x1a, 0xe1, 0xc5, 0x78, 0xf5, 0x15, 0xf8, 0xb4, 0xcd,
+  0x21, 0x97, 0xcb, 0x41, 0xa9, 0x54, 0x22, 0x9f, 0xcf, 0xc3, 0xa7, 0x55,
+  0xee, 0xfb, 0xd6, 0xd4, 0x04, 0x20, 0x18, 0xf7, 0xeb, 0x0a, 0x1b, 0x8c,
+  0x30, 0xc6, 0xb7, 0x32, 0xe0, 0x38, 0x0e, 0x03, 0x47, 0xb4, 0x65, 0x41,
+  0xaa, 0x06, 0x20, 0xe6, 0x7d, 0x1a, 0xd9, 0xd6, 0x28, 0xb3, 0x7b, 0x38,
+  0x31, 0x83, 0xbb, 0xfd, 0x9d, 0x25, 0x21, 0x6a, 0x06, 0x78, 0x31, 0x16,
+  0xc4, 0xb5, 0x01, 0x9f, 0xc4, 0xe4, 0xed, 0xd2, 0x0f, 0x9c, 0xb7, 0xb5,
+  0xe1, 0x51, 0xf0, 0x2b, 0xee, 0xf8, 0x3c, 0xf5, 0x07, 0x90, 0xaf, 0xfe,
+  0xd9, 0xbb, 0x11, 0x78, 0x3c, 0x1e, 0x44, 0xa3, 0x51, 0xd0, 0x34, 0x8d,
+  0x4b, 0x8c, 0x4d, 0x34, 0x2d, 0x57, 0x85, 0xaa, 0x2a, 0x20, 0x07, 0x78,
+  0x3e, 0xf2, 0x1e, 0x0c, 0xc3, 0x60, 0x7e, 0x7e, 0x1e, 0x4e, 0xa7, 0x13,
+  0x17, 0xec, 0xb4, 0x08, 0xf0, 0x38, 0x34, 0x8b, 0xdb, 0x27, 0xdc, 0x7b,
+  0x56, 0xa1, 0x2a, 0x80, 0x40, 0x32, 0x85, 0x41, 0x83, 0x8e, 0x4f, 0x4a,
+  0xca, 0x4d, 0x06, 0x31, 0x27, 0x10, 0xe4, 0x29, 0x88, 0xc5, 0x62, 0xb8,
+  0x3e, 0x74, 0x92, 0x8f, 0x3f, 0x99, 0x9c, 0xc3, 0xcd, 0x5e, 0x57, 0x7d,
+  0x01, 0xc6, 0x36, 0xd3, 0x92, 0x0e, 0x7f, 0x19, 0x9a, 0x82, 0xc9, 0x64,
+  0x42, 0x24, 0x12, 0x81, 0xc3, 0xe1, 0xe0, 0xef, 0xbf, 0x30, 0xee, 0x8f,
+  0x4f, 0xe1, 0x9e, 0xbf, 0xbb, 0xbe, 0x00, 0x24, 0x5b, 0x30, 0x9d, 0xe3,
+  0x9f, 0x77, 0xa1, 0xe1, 0x48, 0xec, 0x55, 0x78, 0x0e, 0x57, 0xbd, 0x2e,
+  0x31, 0xf6, 0x74, 0x3a, 0x82, 0x1b, 0x5d, 0x8e, 0xfa, 0x37, 0x21, 0xc9,
+  0x48, 0x9e, 0x75, 0x7f, 0x53, 0x83, 0x98, 0xfc, 0xf5, 0xec, 0x02, 0x2e,
+  0xbb, 0x9d, 0x12, 0xb3, 0x72, 0x0d, 0x48, 0xc4, 0x55, 0xf5, 0x80, 0xe0,
+  0x42, 0x1a, 0x8c, 0x0c, 0x79, 0x93, 0x91, 0x38, 0x45, 0x51, 0xb8, 0xd5,
+  0x77, 0xfc, 0xe0, 0x36, 0xa2, 0xe2, 0xcc, 0x0f, 0x3e, 0x86, 0xa1, 0x52,
+  0x15, 0x76, 0x43, 0x62, 0x5c, 0xaa, 0xe9, 0xe4, 0x44, 0xf6, 0x5e, 0xc0,
+  0x6e, 0x36, 0x60, 0x61, 0x71, 0xbb, 0xf0, 0x2e, 0x30, 0x36, 0xe9, 0xf0,
+  0x2d, 0xf4, 0xbd, 0x2c, 0x79, 0xbd, 0x04, 0x12, 0x80, 0x53, 0x56, 0x70,
+  0x56, 0xbb, 0x03, 0x33, 0x1f, 0x22, 0xf5, 0xca, 0x5f, 0x36, 0xcf, 0x5f,
+  0x01, 0x28, 0x65, 0x16, 0xe1, 0xc0, 0xe1, 0x54, 0xc1, 0xed, 0x6f, 0x84,
+  0x5e, 0x67, 0xc2, 0xea, 0xf2, 0x0a, 0x28, 0x52, 0x01, 0x82, 0x6c, 0x73,
+  0x5a, 0x01, 0xe4, 0x11, 0x0e, 0xc4, 0xcb, 0xae, 0xa0, 0x16, 0x81, 0xff,
+  0xb4, 0x0b, 0x09, 0x96, 0x05, 0x1b, 0x2f, 0xf8, 0xf0, 0xaf, 0xb6, 0xb3,
+  0x9d, 0x6a, 0x1e, 0xe2, 0x98, 0xb5, 0x19, 0x6c, 0x46, 0x71, 0x60, 0x10,
+  0x82, 0x79, 0x3c, 0xba, 0xb1, 0xfb, 0x55, 0x2c, 0xac, 0x86, 0x40, 0x50,
+  0x79, 0x0e, 0x5d, 0x5e, 0x1a, 0x9b, 0x89, 0x5f, 0x98, 0x18, 0x4d, 0xd4,
+  0xb2, 0xd0, 0x3f, 0xe6, 0x32, 0x83, 0x2e, 0x28, 0xb2, 0x2c, 0x88, 0x39,
+  0x19, 0x92, 0xff, 0x02, 0x41, 0x7d, 0xce, 0xad, 0xe2, 0x2b, 0xa1, 0xd1,
+  0x1a, 0xf8, 0x50, 0x5b, 0xab, 0xa5, 0x26, 0x88, 0x4d, 0xec, 0x88, 0xf3,
+  0xb3, 0x99, 0x2c, 0xd2, 0xd1, 0xb9, 0xbd, 0xff, 0x8c, 0x8a, 0x21, 0xb6,
+  0xd3, 0xd2, 0xaf, 0x9d, 0x9a, 0x28, 0x8a, 0x26, 0xeb, 0xa9, 0x74, 0xe9,
+  0x7f, 0xc3, 0x7a, 0x19, 0x55, 0x92, 0xa7, 0xf4, 0xf7, 0x55, 0x25, 0x99,
+  0xaa, 0xd4, 0xfe, 0x73, 0x80, 0xdf, 0xcd, 0x0b, 0x94, 0xde, 0x64, 0x86,
+  0x04, 0xea, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4e, 0x44, 0xae, 0x42,
+  0x60, 0x82, 0x00
+};
+
+static const unsigned char assets_panels_water_panel_png[] = {
+  0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d,
+  0x49, 0x48, 0x44, 0x52, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00, 0x20,
+  0x08, 0x06, 0x00, 0x00, 0x00, 0x73, 0x7a, 0x7a, 0xf4, 0x00, 0x00, 0x00,
+  0x01, 0x73, 0x52, 0x47, 0x42, 0x00, 0xae, 0xce, 0x1c, 0xe9, 0x00, 0x00,
+  0x03, 0x2c, 0x49, 0x44, 0x41, 0x54, 0x58, 0x47, 0xe5, 0x97, 0x5b, 0x4f,
+  0x13, 0x41, 0x18, 0x86, 0xdf, 0xd9, 0x6e, 0x97, 0x6e, 0x5b, 0xa1, 0xa1,
+  0x50, 0xa0, 0xa5, 0x42, 0x29, 0x08, 0xb4, 0x01, 0x4b, 0x02, 0x46, 0x89,
+  0xd1, 0xe0, 0x95, 0x77, 0xfe, 0x19, 0x63, 0x3c, 0x25, 0x86, 0x78, 0x88,
+  0xd7, 0xfa, 0x6f, 0x8c, 0xf7, 0xca, 0x41, 0x01, 0xf1, 0x50, 0x20, 0x18,
+  0x68, 0x85, 0x72, 0xd2, 0xd2, 0x82, 0x7b, 0xa0, 0x7b, 0x30, 0xb3, 0x4d,
+  0x4b, 0x5b, 0x69, 0x4b, 0x0f, 0xe0, 0x85, 0x73, 0xb5, 0x33, 0xfb, 0xce,
+  0xf7, 0x3e, 0xf3, 0xcd, 0xec, 0xec, 0x0c, 0x41, 0x41, 0xb9, 0x3d, 0xd0,
+  0xa8, 0x37, 0x48, 0xc7, 0x8d, 0x1c, 0xc7, 0x15, 0x4a, 0x4a, 0xd6, 0x53,
+  0x3a, 0x53, 0xf4, 0xbd, 0x20, 0xef, 0xe0, 0x4d, 0x04, 0x24, 0x57, 0x90,
+  0x57, 0xb9, 0xda, 0x0e, 0xdd, 0xe1, 0x68, 0x44, 0x20, 0xe0, 0xcd, 0x6a,
+  0x9c, 0x79, 0x0a, 0x40, 0x23, 0x4a, 0x45, 0x40, 0xa2, 0xc8, 0x1a, 0xfa,
+  0x3d, 0xc5, 0x86, 0xb5, 0x6f, 0xd3, 0x48, 0x28, 0x56, 0x4c, 0x6d, 0x0a,
+  0xd9, 0xa8, 0xd9, 0x07, 0x6a, 0x4e, 0x85, 0xe3, 0xe3, 0x41, 0x6c, 0xed,
+  0x6c, 0x1b, 0x9d, 0x38, 0xe9, 0x38, 0x15, 0x96, 0xca, 0x7c, 0xb3, 0x90,
+  0xa2, 0xd9, 0x6c, 0x3c, 0xef, 0xca, 0x2c, 0x3a, 0x3b, 0x7c, 0x58, 0x58,
+  0xfc, 0x6c, 0xd4, 0x33, 0x10, 0x06, 0x00, 0x4d, 0xfb, 0xfe, 0x7e, 0x12,
+  0x23, 0xc1, 0x1e, 0x24, 0xe4, 0x24, 0x16, 0xa7, 0xf6, 0x2a, 0x1a, 0xe5,
+  0x69, 0xc5, 0xde, 0xc1, 0x56, 0x70, 0xc4, 0x8c, 0xd8, 0xee, 0x3e, 0x9a,
+  0x58, 0xc1, 0x98, 0x0e, 0x72, 0x27, 0x68, 0xd7, 0x65, 0x95, 0x81, 0xcf,
+  0xd3, 0x72, 0xa6, 0xe6, 0x19, 0x48, 0xbe, 0x05, 0x70, 0xbb, 0xdc, 0x10,
+  0xe2, 0x9b, 0x46, 0x93, 0x01, 0xe0, 0x6e, 0x77, 0x9d, 0x8b, 0x79, 0x06,
+  0xa2, 0x35, 0xd4, 0x01, 0x17, 0x49, 0x22, 0x7e, 0xa8, 0xa6, 0x01, 0x78,
+  0xab, 0x03, 0x5f, 0xe6, 0x7f, 0x9c, 0x36, 0x93, 0x35, 0xeb, 0xdc, 0x5e,
+  0xc0, 0xdf, 0xe3, 0xc6, 0xea, 0xe6, 0x2f, 0x90, 0x9b, 0x03, 0xcd, 0xba,
+  0x8d, 0xb1, 0x22, 0xba, 0xf2, 0x1f, 0x01, 0xf8, 0xfc, 0x3c, 0x7c, 0xdd,
+  0xed, 0x08, 0x47, 0x62, 0xd5, 0x67, 0xe0, 0xd3, 0x91, 0x0e, 0x55, 0x55,
+  0x61, 0x32, 0x99, 0xa0, 0x69, 0x1a, 0x42, 0x16, 0xd3, 0xa9, 0xa7, 0xa6,
+  0x26, 0x80, 0x8c, 0xf1, 0x08, 0x9f, 0xde, 0x60, 0x32, 0x65, 0xf6, 0x50,
+  0x86, 0xae, 0xeb, 0x18, 0xbb, 0x60, 0x29, 0x0b, 0x52, 0x35, 0x00, 0x35,
+  0x1f, 0xe6, 0x0a, 0xb6, 0xc6, 0x02, 0xbb, 0x67, 0x73, 0x4b, 0x78, 0x3c,
+  0xd2, 0x5f, 0x12, 0xa2, 0x26, 0x80, 0xc0, 0x7b, 0x80, 0xbd, 0x51, 0x1c,
+  0xe2, 0xf9, 0xfc, 0x32, 0x1e, 0x85, 0x2e, 0xd5, 0x1f, 0x80, 0x8e, 0x7e,
+  0x70, 0x01, 0x20, 0x22, 0x90, 0x52, 0x35, 0xf0, 0x13, 0xc5, 0xe7, 0xbc,
+  0x5c, 0x16, 0xaa, 0xca, 0x00, 0x05, 0xa0, 0xa3, 0xa7, 0xff, 0x3a, 0x33,
+  0x01, 0x54, 0x00, 0xa2, 0x72, 0x32, 0xc8, 0x8b, 0x85, 0x15, 0x3c, 0xbc,
+  0xdc, 0x57, 0x34, 0x0b, 0x55, 0x01, 0x4c, 0x27, 0x45, 0x84, 0xde, 0x5a,
+  0xa0, 0x3b, 0x01, 0xc6, 0x0a, 0xb0, 0x22, 0x40, 0x08, 0xa0, 0xe9, 0x80,
+  0xca, 0x03, 0xe6, 0xb1, 0xe3, 0x69, 0x79, 0xb9, 0xb8, 0x8a, 0xfb, 0x43,
+  0xfe, 0xfa, 0x02, 0xcc, 0x1c, 0x48, 0x08, 0x85, 0x1b, 0xa0, 0x1c, 0x6a,
+  0x50, 0xb6, 0x15, 0x34, 0x81, 0x83, 0xec, 0x87, 0x51, 0xe7, 0x59, 0x26,
+  0x2f, 0x1b, 0x93, 0xb3, 0x5f, 0xf1, 0x64, 0x34, 0x50, 0x5f, 0x00, 0x1a,
+  0x6d, 0x5e, 0x52, 0xd1, 0xff, 0x2e, 0x1d, 0x97, 0x61, 0x18, 0x88, 0xa2,
+  0x08, 0x9b, 0x93, 0x87, 0x1e, 0x05, 0xd8, 0x16, 0x20, 0xa5, 0x03, 0xaf,
+  0x5d, 0x11, 0xdc, 0x1d, 0xec, 0xaa, 0xff, 0x22, 0xa4, 0x11, 0xe9, 0xb7,
+  0x1e, 0x9c, 0x61, 0x21, 0x6d, 0x48, 0x68, 0xba, 0x68, 0x85, 0x3d, 0x09,
+  0x24, 0xda, 0x00, 0xe6, 0x27, 0x90, 0xdc, 0x13, 0xd0, 0xd2, 0x65, 0xc5,
+  0xa4, 0x7d, 0xf9, 0xec, 0x3e, 0x43, 0x0a, 0x41, 0x17, 0x18, 0x2d, 0xf7,
+  0x12, 0xbd, 0x90, 0x62, 0x29, 0x23, 0x13, 0x74, 0x27, 0x7c, 0x35, 0xb0,
+  0x0e, 0x42, 0x08, 0x1e, 0x0c, 0xf7, 0x9e, 0xdd, 0x46, 0x94, 0x1b, 0xf9,
+  0xe9, 0xc7, 0x30, 0xe8, 0x79, 0x91, 0x9a, 0x53, 0xe3, 0x52, 0x8b, 0xae,
+  0x90, 0xc8, 0x3b, 0x04, 0x78, 0x5d, 0x8d, 0x58, 0x8b, 0x1c, 0xa5, 0xff,
+  0x05, 0x0e, 0x3b, 0x8f, 0xef, 0x0b, 0x1b, 0x65, 0xc9, 0xeb, 0x25, 0xc8,
+  0x03, 0xb8, 0xe6, 0x81, 0xee, 0xf1, 0x76, 0x61, 0xe9, 0xc3, 0x7a, 0xbd,
+  0xe2, 0x97, 0x8d, 0x73, 0x22, 0x00, 0x31, 0x29, 0x08, 0x4f, 0x9f, 0x4f,
+  0x16, 0xfa, 0x46, 0x6d, 0xb0, 0xf2, 0x4e, 0xec, 0x6e, 0xed, 0x80, 0xd0,
+  0x0c, 0x50, 0xe4, 0xce, 0x6e, 0x0f, 0x00, 0x0d, 0xe1, 0xe9, 0x58, 0xd9,
+  0x11, 0xd4, 0x22, 0x18, 0xbd, 0xee, 0x47, 0x5c, 0x10, 0x20, 0xc4, 0xd2,
+  0x3e, 0xc6, 0xf6, 0x35, 0xd1, 0x6f, 0x36, 0x20, 0x2e, 0x7a, 0x9a, 0x21,
+  0xc8, 0xcc, 0x99, 0x41, 0x64, 0xcc, 0x63, 0xd1, 0xc4, 0xf1, 0xa9, 0x38,
+  0x33, 0x1a, 0x0a, 0x41, 0x34, 0x1d, 0x83, 0x03, 0xed, 0x38, 0x88, 0xff,
+  0xc6, 0xdc, 0x54, 0xbc, 0x96, 0x81, 0xfe, 0xd5, 0xd7, 0x77, 0xc5, 0x0f,
+  0x46, 0x11, 0x40, 0xcd, 0x69, 0xc9, 0xbb, 0x17, 0x64, 0xd4, 0xb7, 0xfa,
+  0x58, 0x23, 0x13, 0x9c, 0xa5, 0xd1, 0x68, 0x6a, 0x6b, 0x75, 0xd7, 0x04,
+  0x71, 0x80, 0x54, 0xb6, 0xbf, 0x22, 0x2b, 0x90, 0xa2, 0xab, 0xc5, 0x6f,
+  0x46, 0xb9, 0x10, 0x47, 0x52, 0xfe, 0x69, 0xa7, 0x26, 0x8a, 0x9c, 0xce,
+  0x56, 0x22, 0x95, 0xbe, 0x1b, 0xd6, 0xcb, 0xa8, 0x92, 0x38, 0xa5, 0xcf,
+  0x57, 0x95, 0x44, 0xaa, 0x52, 0xfb, 0xcf, 0x01, 0xfe, 0x00, 0x52, 0xcb,
+  0x9c, 0xde, 0x59, 0xa1, 0x3e, 0x1b, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45,
+  0x4e, 0x44, 0xae, 0x42, 0x60, 0x82
+};
+
+static const unsigned char assets_panels_wood_panel_png[] = {
+  0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d,
+  0x49, 0x48, 0x44, 0x52, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00, 0x20,
+  0x08, 0x06, 0x00, 0x00, 0x00, 0x73, 0x7a, 0x7a, 0xf4, 0x00, 0x00, 0x00,
+  0x01, 0x73, 0x52, 0x47, 0x42, 0x00, 0xae, 0xce, 0x1c, 0xe9, 0x00, 0x00,
+  0x03, 0x41, 0x49, 0x44, 0x41, 0x54, 0x58, 0x47, 0xe5, 0x97, 0x49, 0x4c,
+  0x13, 0x51, 0x18, 0xc7, 0xff, 0xd3, 0x65, 0xe8, 0x82, 0xb5, 0x61, 0x29,
+  0xa5, 0xa5, 0x42, 0xa9, 0x58, 0x96, 0x80, 0x90, 0x54, 0x22, 0xc4, 0x84,
+  0xe8, 0x89, 0x93, 0xc6, 0xbb, 0x07, 0xe3, 0xdd, 0x03, 0x09, 0x26, 0x6e,
+  0x09, 0x21, 0x2e, 0x31, 0x91, 0x84, 0x83, 0xf1, 0x6a, 0x3c, 0xa8, 0x57,
+  0x13, 0x4f, 0x2e, 0x27, 0x0f, 0xc6, 0x50, 0x51, 0xc0, 0xaa, 0xb4, 0x12,
+  0x0c, 0x8b, 0xb4, 0x6c, 0x52, 0x28, 0x30, 0x5d, 0x98, 0x76, 0xcc, 0x7b,
+  0xcd, 0x74, 0x53, 0x5a, 0xda, 0x0e, 0x78, 0xf0, 0xbb, 0xb4, 0xf3, 0xe6,
+  0x7b, 0xdf, 0xff, 0xf7, 0x7d, 0xef, 0x7b, 0xf3, 0x66, 0x18, 0x64, 0x58,
+  0x6f, 0xa3, 0x4e, 0x28, 0x09, 0x25, 0x07, 0x59, 0x96, 0xcd, 0x74, 0xc9,
+  0x7a, 0xbd, 0x23, 0xc8, 0x76, 0xbd, 0xcf, 0x85, 0x97, 0xf1, 0x7a, 0x0e,
+  0x4c, 0xaa, 0x43, 0xda, 0xc5, 0x49, 0x23, 0x04, 0xbd, 0x5e, 0x87, 0xe6,
+  0x66, 0x4b, 0xc2, 0xa7, 0x3c, 0xcd, 0x03, 0x88, 0x31, 0x7c, 0x5e, 0x40,
+  0xc1, 0xa0, 0x82, 0xfa, 0xaf, 0xf2, 0x5a, 0xcc, 0x4c, 0x3a, 0xb1, 0xc1,
+  0x6b, 0x30, 0xe2, 0xe5, 0x12, 0x51, 0x13, 0x7f, 0x88, 0x38, 0x71, 0xec,
+  0xee, 0x6e, 0xc1, 0xe2, 0xf2, 0x12, 0x9d, 0xc4, 0x86, 0x92, 0xa5, 0x50,
+  0xe5, 0xa7, 0x9b, 0x80, 0x0c, 0x2a, 0x95, 0xf4, 0xff, 0x4a, 0x58, 0x81,
+  0x9a, 0x6a, 0x2b, 0x26, 0x5c, 0x5f, 0xe8, 0xb5, 0x08, 0x41, 0x01, 0x48,
+  0xd9, 0xd7, 0xd7, 0x03, 0xe8, 0x68, 0xa9, 0xc7, 0x46, 0x38, 0x00, 0xd7,
+  0xc8, 0x6a, 0x5e, 0x59, 0xee, 0xd5, 0xd9, 0xd2, 0x54, 0x09, 0x96, 0x51,
+  0xc2, 0xb7, 0xb2, 0x8e, 0xc3, 0x0a, 0x8e, 0x2e, 0x07, 0x73, 0xae, 0xa5,
+  0x54, 0x08, 0x47, 0x65, 0xb0, 0x9a, 0x2b, 0xf6, 0x55, 0x5c, 0x84, 0x54,
+  0x57, 0x00, 0x26, 0x83, 0x09, 0x9c, 0xdf, 0x4b, 0x87, 0x28, 0x80, 0xc9,
+  0x68, 0x38, 0x10, 0x71, 0x11, 0xa2, 0xb2, 0xbd, 0x1a, 0x06, 0x26, 0x00,
+  0xff, 0x56, 0x34, 0x0e, 0xa0, 0xd6, 0xe8, 0xf1, 0x75, 0xfc, 0xe7, 0x5e,
+  0x2b, 0x59, 0xb4, 0x9f, 0xc9, 0x02, 0xd8, 0xea, 0x4d, 0x98, 0xf6, 0xae,
+  0x81, 0xe9, 0x69, 0x2c, 0x13, 0xb4, 0x32, 0x0d, 0xe6, 0xa7, 0xfe, 0x23,
+  0x00, 0xab, 0x4d, 0x0d, 0x6b, 0x9d, 0x11, 0xee, 0x39, 0x5f, 0xe1, 0x15,
+  0xf8, 0x1c, 0x11, 0x10, 0x8d, 0x46, 0x21, 0x97, 0xcb, 0x11, 0x8b, 0xc5,
+  0xd0, 0xae, 0x92, 0xef, 0x79, 0x69, 0x8a, 0x02, 0x10, 0x85, 0x3b, 0xd4,
+  0xf1, 0x07, 0x8c, 0x68, 0xa3, 0x5b, 0x61, 0x08, 0x82, 0x80, 0x13, 0x87,
+  0x54, 0x39, 0x41, 0x0a, 0x06, 0x20, 0xe2, 0x6d, 0x6c, 0xfc, 0xd9, 0x35,
+  0xfc, 0xe0, 0x12, 0x16, 0xd6, 0x56, 0x61, 0x2e, 0xab, 0xa0, 0xbf, 0x43,
+  0x03, 0x2f, 0xe8, 0xf8, 0xed, 0x31, 0x0f, 0x6e, 0x76, 0xd8, 0xb3, 0x42,
+  0x14, 0x0d, 0x70, 0x7f, 0xf8, 0x02, 0x14, 0x0a, 0x96, 0x0a, 0x57, 0xe9,
+  0x74, 0x09, 0xb1, 0x2b, 0x7d, 0x4f, 0x70, 0x67, 0xfc, 0x3b, 0x6e, 0xb4,
+  0x1f, 0x93, 0x1e, 0x40, 0xcc, 0x9e, 0x64, 0x2e, 0x1a, 0x01, 0x10, 0xcd,
+  0xe5, 0xf9, 0x85, 0xde, 0x2e, 0x3b, 0xfa, 0x2e, 0x3f, 0xca, 0x59, 0x85,
+  0x82, 0x2a, 0x20, 0x02, 0x9c, 0xbf, 0xd8, 0x93, 0x10, 0xd5, 0x68, 0x93,
+  0x27, 0x25, 0xb7, 0x1d, 0xa1, 0xe3, 0xcf, 0x1f, 0xbf, 0xc5, 0xdd, 0x89,
+  0x29, 0x5c, 0x3f, 0xde, 0xb0, 0x6b, 0x15, 0x0a, 0x02, 0x70, 0x06, 0x82,
+  0xe8, 0xd4, 0xa9, 0xe9, 0xda, 0xbf, 0x7c, 0xef, 0x41, 0xab, 0xbd, 0x9c,
+  0xae, 0x3f, 0x31, 0x9e, 0x8f, 0x8b, 0x13, 0x23, 0xcb, 0x70, 0xcf, 0x35,
+  0x8d, 0xab, 0xad, 0x36, 0x69, 0x01, 0x3e, 0x6c, 0x86, 0x68, 0x87, 0xf7,
+  0x0f, 0x9e, 0xa5, 0xc2, 0xa2, 0xe8, 0x52, 0x20, 0x90, 0xb6, 0x0c, 0xaf,
+  0x9e, 0xbd, 0xc3, 0xe0, 0xe8, 0x37, 0x0c, 0x38, 0x9a, 0xa5, 0x05, 0x20,
+  0xd1, 0xc6, 0x43, 0x51, 0xba, 0xdf, 0xc5, 0x1d, 0x90, 0xaa, 0x40, 0x9a,
+  0x91, 0x64, 0x3f, 0x34, 0x39, 0x8b, 0xfe, 0xa6, 0x5a, 0xe9, 0x9b, 0x90,
+  0x44, 0x24, 0x7b, 0xdd, 0x51, 0x5a, 0x42, 0x83, 0x93, 0x5e, 0x48, 0xed,
+  0x81, 0xa7, 0x0f, 0xdf, 0xec, 0xff, 0x36, 0x24, 0x0a, 0xa4, 0xc1, 0x88,
+  0x65, 0x36, 0x19, 0x19, 0x67, 0x18, 0x06, 0xd7, 0xda, 0x8e, 0x66, 0xcd,
+  0x9e, 0xdc, 0x2c, 0xa8, 0x09, 0x33, 0xa3, 0xde, 0xfa, 0xe4, 0x06, 0x79,
+  0x5f, 0x24, 0x8f, 0x61, 0x22, 0x9c, 0xad, 0xe9, 0x32, 0xe7, 0x5a, 0x5a,
+  0x01, 0x8b, 0x41, 0x87, 0x99, 0xb9, 0x48, 0xfc, 0x2c, 0xd0, 0x97, 0xaa,
+  0xf1, 0x63, 0x62, 0x21, 0x27, 0xb9, 0x54, 0x0e, 0x69, 0x00, 0x5d, 0x66,
+  0x08, 0x66, 0x4b, 0x2d, 0x3c, 0x1f, 0x67, 0xa5, 0x8a, 0x9f, 0x33, 0xce,
+  0x5f, 0x01, 0x18, 0x39, 0x0f, 0xb7, 0xf3, 0x60, 0xaa, 0xd0, 0xe0, 0xd0,
+  0x42, 0xa3, 0x2e, 0xc7, 0xca, 0xe2, 0x32, 0x18, 0x52, 0x01, 0x82, 0x5c,
+  0x53, 0x67, 0x06, 0x10, 0x83, 0xdb, 0xe9, 0xcb, 0x99, 0x41, 0x31, 0x0e,
+  0x8e, 0x53, 0x36, 0xf8, 0x39, 0x0e, 0x9c, 0x2f, 0xae, 0x43, 0x8f, 0xb6,
+  0xd3, 0x76, 0x25, 0x85, 0x38, 0x62, 0x2e, 0x03, 0x17, 0x96, 0xed, 0x1b,
+  0x84, 0x28, 0xee, 0x9b, 0xdf, 0x48, 0xbe, 0x15, 0x8b, 0xd9, 0x10, 0x08,
+  0x26, 0x26, 0xa0, 0xa9, 0xd1, 0x88, 0x4d, 0xff, 0x36, 0xc6, 0x46, 0xfc,
+  0xc5, 0x24, 0xfa, 0xc7, 0x5c, 0x6b, 0xa7, 0x0d, 0x32, 0x9e, 0x03, 0x11,
+  0x27, 0x96, 0xf6, 0x5d, 0x20, 0x7a, 0x9f, 0x69, 0x50, 0xd0, 0x4a, 0xb0,
+  0xaa, 0xf8, 0x11, 0x5b, 0x55, 0x69, 0x2a, 0x0a, 0x62, 0x13, 0x3b, 0x89,
+  0xf9, 0x7c, 0x98, 0x47, 0x68, 0x7e, 0x7a, 0xf7, 0x2f, 0xa3, 0x54, 0x88,
+  0x48, 0x28, 0xfd, 0x6d, 0xa7, 0x28, 0x8a, 0x94, 0xc9, 0x1a, 0x26, 0x94,
+  0xfd, 0xdb, 0x50, 0x2a, 0xa1, 0x7c, 0xe2, 0x64, 0x7c, 0x7a, 0xe6, 0x33,
+  0x55, 0x1a, 0xdf, 0x7f, 0x0e, 0xf0, 0x1b, 0xb0, 0x8d, 0xa3, 0xde, 0x22,
+  0x61, 0x9b, 0xc2, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4e, 0x44, 0xae,
+  0x42, 0x60, 0x82
+};
+
+static const unsigned char assets_tiles_air_png[] = {
+  0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d,
+  0x49, 0x48, 0x44, 0x52, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x08,
+  0x08, 0x02, 0x00, 0x00, 0x00, 0x4b, 0x6d, 0x29, 0xdc, 0x00, 0x00, 0x00,
+  0x01, 0x73, 0x52, 0x47, 0x42, 0x00, 0xae, 0xce, 0x1c, 0xe9, 0x00, 0x00,
+  0x00, 0x04, 0x67, 0x41, 0x4d, 0x41, 0x00, 0x00, 0xb1, 0x8f, 0x0b, 0xfc,
+  0x61, 0x05, 0x00, 0x00, 0x00, 0x09, 0x70, 0x48, 0x59, 0x73, 0x00, 0x00,
+  0x12, 0x74, 0x00, 0x00, 0x12, 0x74, 0x01, 0xde, 0x66, 0x1f, 0x78, 0x00,
+  0x00, 0x00, 0x0d, 0x49, 0x44, 0x41, 0x54, 0x18, 0x57, 0x63, 0x18, 0x16,
+  0x80, 0x81, 0x01, 0x00, 0x00, 0xc8, 0x00, 0x01, 0x98, 0x38, 0xc2, 0x47,
+  0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4e, 0x44, 0xae, 0x42, 0x60, 0x82
+};
+
+static const unsigned char assets_tiles_fire_png[] = {
+  0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d,
+  0x49, 0x48, 0x44, 0x52, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x08,
+  0x08, 0x06, 0x00, 0x00, 0x00, 0xc4, 0x0f, 0xbe, 0x8b, 0x00, 0x00, 0x00,
+  0x01, 0x73, 0x52, 0x47, 0x42, 0x00, 0xae, 0xce, 0x1c, 0xe9, 0x00, 0x00,
+  0x00, 0x13, 0x49, 0x44, 0x41, 0x54, 0x28, 0x53, 0x63, 0xfc, 0x9f, 0xcd,
+  0xf8, 0x9f, 0x01, 0x0f, 0x60, 0x1c, 0x19, 0x0a, 0x00, 0x0b, 0x99, 0x13,
+  0x59, 0xe8, 0xd3, 0x35, 0x98, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4e,
+  0x44, 0xae, 0x42, 0x60, 0x82, 0x00
+};
+
+static const unsigned char assets_tiles_sand_png[] = {
+  0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d,
+  0x49, 0x48, 0x44, 0x52, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x08,
+  0x08, 0x06, 0x00, 0x00, 0x00, 0xc4, 0x0f, 0xbe, 0x8b, 0x00, 0x00, 0x00,
+  0x01, 0x73, 0x52, 0x47, 0x42, 0x00, 0xae, 0xce, 0x1c, 0xe9, 0x00, 0x00,
+  0x00, 0x14, 0x49, 0x44, 0x41, 0x54, 0x28, 0x53, 0x63, 0xfc, 0x7f, 0x2f,
+  0xfb, 0x3f, 0x03, 0x1e, 0xc0, 0x38, 0x32, 0x14, 0x00, 0x00, 0xfc, 0x3a,
+  0x1a, 0x41, 0x72, 0x08, 0xeb, 0xbb, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45,
+  0x4e, 0x44, 0xae, 0x42, 0x60, 0x82
+};
+
+static const unsigned char assets_tiles_steam_png[] = {
+  0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d,
+  0x49, 0x48, 0x44, 0x52, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x08,
+  0x08, 0x06, 0x00, 0x00, 0x00, 0xc4, 0x0f, 0xbe, 0x8b, 0x00, 0x00, 0x00,
+  0x01, 0x73, 0x52, 0x47, 0x42, 0x00, 0xae, 0xce, 0x1c, 0xe9, 0x00, 0x00,
+  0x00, 0x14, 0x49, 0x44, 0x41, 0x54, 0x28, 0x53, 0x63, 0x7c, 0xf9, 0xf2,
+  0xe5, 0x7f, 0x06, 0x3c, 0x80, 0x71, 0x64, 0x28, 0x00, 0x00, 0x06, 0x43,
+  0x1d, 0xd9, 0xbe, 0x60, 0xd4, 0xb1, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45,
+  0x4e, 0x44, 0xae, 0x42, 0x60, 0x82
+};
+
+static const unsigned char assets_tiles_water_png[] = {
+  0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d,
+  0x49, 0x48, 0x44, 0x52, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x08,
+  0x08, 0x06, 0x00, 0x00, 0x00, 0xc4, 0x0f, 0xbe, 0x8b, 0x00, 0x00, 0x00,
+  0x01, 0x73, 0x52, 0x47, 0x42, 0x00, 0xae, 0xce, 0x1c, 0xe9, 0x00, 0x00,
+  0x00, 0x14, 0x49, 0x44, 0x41, 0x54, 0x28, 0x53, 0x63, 0x74, 0x38, 0xfa,
+  0xff, 0x3f, 0x03, 0x1e, 0xc0, 0x38, 0x32, 0x14, 0x00, 0x00, 0xba, 0x43,
+  0x18, 0x21, 0x8d, 0xfd, 0x13, 0xbf, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45,
+  0x4e, 0x44, 0xae, 0x42, 0x60, 0x82
+};
+
+static const unsigned char assets_tiles_wood_png[] = {
+  0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d,
+  0x49, 0x48, 0x44, 0x52, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x08,
+  0x08, 0x06, 0x00, 0x00, 0x00, 0xc4, 0x0f, 0xbe, 0x8b, 0x00, 0x00, 0x00,
+  0x01, 0x73, 0x52, 0x47, 0x42, 0x00, 0xae, 0xce, 0x1c, 0xe9, 0x00, 0x00,
+  0x00, 0x14, 0x49, 0x44, 0x41, 0x54, 0x28, 0x53, 0x63, 0xdc, 0x33, 0x23,
+  0xe9, 0x3f, 0x03, 0x1e, 0xc0, 0x38, 0x32, 0x14, 0x00, 0x00, 0x5d, 0xe4,
+  0x15, 0xb1, 0x5f, 0x3b, 0x25, 0xdf, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45,
+  0x4e, 0x44, 0xae, 0x42, 0x60, 0x82
+};
+
+const struct Asset ASSETS[] =
+{
+    {"assets/panels/air_panel.png", assets_panels_air_panel_png, sizeof(assets_panels_air_panel_png)},
+    {"assets/panels/fire_panel.png", assets_panels_fire_panel_png, sizeof(assets_panels_fire_panel_png)},
+    {"assets/panels/sand_panel.png", assets_panels_sand_panel_png, sizeof(assets_panels_sand_panel_png)},
+    {"assets/panels/steam_panel.png", assets_panels_steam_panel_png, sizeof(assets_panels_steam_panel_png)},
+    {"assets/panels/water_panel.png", assets_panels_water_panel_png, sizeof(assets_panels_water_panel_png)},
+    {"assets/panels/wood_panel.png", assets_panels_wood_panel_png, sizeof(assets_panels_wood_panel_png)},
+    {"assets/tiles/air.png", assets_tiles_air_png, sizeof(assets_tiles_air_png)},
+    {"assets/tiles/fire.png", assets_tiles_fire_png, sizeof(assets_tiles_fire_png)},
+    {"assets/tiles/sand.png", assets_tiles_sand_png, sizeof(assets_tiles_sand_png)},
+    {"assets/tiles/steam.png", assets_tiles_steam_png, sizeof(assets_tiles_steam_png)},
+    {"assets/tiles/water.png", assets_tiles_water_png, sizeof(assets_tiles_water_png)},
+    {"assets/tiles/wood.png", assets_tiles_wood_png, sizeof(assets_tiles_wood_png)},
+};
+
+const unsigned int NUM_ASSETS = sizeof(ASSETS) / sizeof(ASSETS[0]);
+
+
+const struct Asset *get_asset(const char *path)
+{
+    for (unsigned int i = 0; i < NUM_ASSETS; i++)
+    {
+        if (strcmp(ASSETS[i].path, path) == 0)
+        {
+            return &ASSETS[i];
+        }
+    }
+
+    return NULL;
+}
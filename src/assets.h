@@ -0,0 +1,42 @@
+#ifndef ASSETS_H
+#define ASSETS_H
+
+/*
+ * Visual assets compiled into the binary, so that they load without touching
+ * the disk, wherever the binary is started from.
+ *
+ * "assets.c" is generated from the PNG files under "assets/" by running
+ * "make assets.c", and holds each file's bytes as they are on disk.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+// An asset file compiled into the binary.
+struct Asset
+{
+    // Path of the file the asset was compiled from, relative to "src/".
+    const char *path;
+
+    const unsigned char *data;
+    unsigned int size;
+};
+
+// Every asset compiled into the binary.
+extern const struct Asset ASSETS[];
+extern const unsigned int NUM_ASSETS;
+
+
+/*
+ * Find the asset compiled from the file at the given path.
+ *
+ * @param path - Path of file, relative to "src/", such as
+ * "assets/tiles/air.png".
+ *
+ * @return - Asset compiled from path, or NULL if there is none.
+ */
+const struct Asset *get_asset(const char *path);
+
+
+#endif
@@ -0,0 +1,155 @@
+/*
+ * Implementation of chunk_cache.h interface.
+ *
+ */
+
+#include "chunk_cache.h"
+
+
+// A single slot of the cache.
+struct ChunkCacheEntry
+{
+    bool is_used;
+    unsigned int hash;
+    struct ChunkCacheKey key;
+    unsigned char window[CHUNK_WINDOW_AREA];
+    unsigned char result[CHUNK_WINDOW_AREA];
+};
+
+
+// Slots of the cache, NULL while the cache is disabled.
+static struct ChunkCacheEntry *CACHE_ENTRIES = NULL;
+
+static struct ChunkCacheStats CACHE_STATS;
+
+// Whether enabling the cache set SANDBOX_RNG_PERIOD, to be undone when it
+// is disabled.
+static bool HAS_SET_RNG_PERIOD = false;
+
+
+// ----- PRIVATE FUNCTIONS -----
+
+
+/*
+ * Hash a chunk window together with its key using FNV-1a.
+ *
+ * @param key - Key of window to hash.
+ * @param window - Window contents to hash.
+ *
+ * @return - 32 bit hash of both key and window.
+ */
+static unsigned int _hash_window(const struct ChunkCacheKey *key, const unsigned char *window)
+{
+    unsigned int hash = 2166136261u;
+    const unsigned char *key_bytes = (const unsigned char *) key;
+
+    for (unsigned int i = 0; i < sizeof(struct ChunkCacheKey); i++)
+    {
+        hash = (hash ^ key_bytes[i]) * 16777619u;
+    }
+
+    for (unsigned int i = 0; i < CHUNK_WINDOW_AREA; i++)
+    {
+        hash = (hash ^ window[i]) * 16777619u;
+    }
+
+    return hash;
+}
+
+
+// ----- PUBLIC FUNCTIONS -----
+
+
+void set_chunk_cache_enabled(bool should_enable)
+{
+    if (should_enable == is_chunk_cache_enabled())
+    {
+        return;
+    }
+
+    memset(&CACHE_STATS, 0, sizeof(CACHE_STATS));
+
+    if (!should_enable)
+    {
+        release_memory(MEMORY_CHUNK_CACHE, CACHE_ENTRIES, CHUNK_CACHE_CAPACITY * sizeof(struct ChunkCacheEntry));
+        CACHE_ENTRIES = NULL;
+
+        if (HAS_SET_RNG_PERIOD && SANDBOX_RNG_PERIOD == CHUNK_CACHE_RNG_PERIOD)
+        {
+            SANDBOX_RNG_PERIOD = SANDBOX_UNBOUNDED_RNG_PERIOD;
+        }
+
+        HAS_SET_RNG_PERIOD = false;
+        return;
+    }
+
+    // Keys never repeating would make every entry miss.
+    if (SANDBOX_RNG_PERIOD == SANDBOX_UNBOUNDED_RNG_PERIOD)
+    {
+        SANDBOX_RNG_PERIOD = CHUNK_CACHE_RNG_PERIOD;
+        HAS_SET_RNG_PERIOD = true;
+    }
+
+    CACHE_STATS.bytes_allocated = CHUNK_CACHE_CAPACITY * sizeof(struct ChunkCacheEntry);
+    CACHE_ENTRIES = (struct ChunkCacheEntry *) allocate_memory(MEMORY_CHUNK_CACHE, CACHE_STATS.bytes_allocated);
+}
+
+
+bool is_chunk_cache_enabled(void)
+{
+    return CACHE_ENTRIES != NULL;
+}
+
+
+bool chunk_cache_lookup(const struct ChunkCacheKey *key,
+        const unsigned char *window,
+        unsigned char *result)
+{
+    CACHE_STATS.lookups++;
+
+    unsigned int hash = _hash_window(key, window);
+    struct ChunkCacheEntry *entry = &CACHE_ENTRIES[hash % CHUNK_CACHE_CAPACITY];
+
+    // The full key and window are compared, so a hash collision never
+    // replays the wrong result.
+    if (!entry -> is_used
+            || entry -> hash != hash
+            || memcmp(&entry -> key, key, sizeof(struct ChunkCacheKey)) != 0
+            || memcmp(entry -> window, window, CHUNK_WINDOW_AREA) != 0)
+    {
+        return false;
+    }
+
+    memcpy(result, entry -> result, CHUNK_WINDOW_AREA);
+    CACHE_STATS.hits++;
+
+    return true;
+}
+
+
+void chunk_cache_store(const struct ChunkCacheKey *key,
+        const unsigned char *window,
+        const unsigned char *result)
+{
+    unsigned int hash = _hash_window(key, window);
+    struct ChunkCacheEntry *entry = &CACHE_ENTRIES[hash % CHUNK_CACHE_CAPACITY];
+
+    if (!entry -> is_used)
+    {
+        CACHE_STATS.entries_used++;
+    }
+
+    entry -> is_used = true;
+    entry -> hash = hash;
+    entry -> key = *key;
+    memcpy(entry -> window, window, CHUNK_WINDOW_AREA);
+    memcpy(entry -> result, result, CHUNK_WINDOW_AREA);
+
+    CACHE_STATS.stores++;
+}
+
+
+struct ChunkCacheStats get_chunk_cache_stats(void)
+{
+    return CACHE_STATS;
+}
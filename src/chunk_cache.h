@@ -0,0 +1,121 @@
+#ifndef CHUNK_CACHE_H
+#define CHUNK_CACHE_H
+
+/*
+ * A memoization cache for the evolution of single sandbox chunks.
+ *
+ * Processing a chunk only ever reads and writes the chunk itself and the ring
+ * of tiles bordering it, and its coin flips depend only on the frame's RNG key
+ * and tile positions. A chunk's window (the chunk plus its border) together
+ * with that key therefore fully determines the window after processing, so
+ * recurring configurations can be replayed rather than recomputed.
+ *
+ * Within a window, tiles that have already moved during the frame carry
+ * WINDOW_MOVED_FLAG, as processing depends on that too.
+ *
+ * The cache is direct-mapped with a fixed number of entries. Entries store
+ * their full input window, so a hit is always exact.
+ *
+ */
+
+#include "sandbox.h"
+
+// Maximum number of chunk windows held in the cache at once.
+#define CHUNK_CACHE_CAPACITY 4096
+
+// Period of the per-frame RNG key set by enabling the cache, when none was
+// set already. Entries can only be hit again by frames of the same place in
+// the period.
+#define CHUNK_CACHE_RNG_PERIOD 64
+
+// Side length and area of a chunk window, being a chunk plus its border.
+#define CHUNK_WINDOW_SIZE (CHUNK_SIZE + 2)
+#define CHUNK_WINDOW_AREA (CHUNK_WINDOW_SIZE * CHUNK_WINDOW_SIZE)
+
+// Unused tile flag bit, set on window tiles that have moved this frame.
+#define WINDOW_MOVED_FLAG 0x80
+
+
+// Everything besides the window contents that a chunk's evolution depends on.
+struct ChunkCacheKey
+{
+    unsigned int seed;
+    unsigned int rng_phase;
+    unsigned int chunk_row;
+    unsigned int chunk_column;
+    unsigned int height;
+    unsigned int width;
+};
+
+
+// Counters describing how well the cache is doing.
+struct ChunkCacheStats
+{
+    unsigned long lookups;
+    unsigned long hits;
+    unsigned long stores;
+    unsigned long entries_used;
+    unsigned long bytes_allocated;
+};
+
+
+/*
+ * Turn the chunk cache on or off.
+ *
+ * Enabling the cache allocates its entries, disabling it frees them and
+ * resets its statistics.
+ *
+ * With SANDBOX_RNG_PERIOD unbounded, enabling the cache also sets it to
+ * CHUNK_CACHE_RNG_PERIOD, and disabling the cache unbounds it again, unless
+ * it was changed meanwhile. Either changes the random choices of every
+ * frame after it.
+ *
+ * @param should_enable - Whether the cache should be used by process_sandbox().
+ */
+void set_chunk_cache_enabled(bool should_enable);
+
+
+/*
+ * Return whether the chunk cache is currently in use.
+ *
+ * @return - True if the cache is enabled, false otherwise.
+ */
+bool is_chunk_cache_enabled(void);
+
+
+/*
+ * Look up the result of processing the given chunk window.
+ *
+ * @param key - Frame and position data the window was taken under.
+ * @param window - CHUNK_WINDOW_AREA tiles of chunk and border, row by row.
+ * @param result - Filled with the window after processing on a hit.
+ *
+ * @return - True on a cache hit, false otherwise.
+ */
+bool chunk_cache_lookup(const struct ChunkCacheKey *key,
+        const unsigned char *window,
+        unsigned char *result);
+
+
+/*
+ * Record the result of processing the given chunk window, replacing whatever
+ * entry previously occupied its slot.
+ *
+ * @param key - Frame and position data the window was taken under.
+ * @param window - Window before processing.
+ * @param result - Window after processing.
+ */
+void chunk_cache_store(const struct ChunkCacheKey *key,
+        const unsigned char *window,
+        const unsigned char *result);
+
+
+/*
+ * Obtain the current statistics of the chunk cache.
+ *
+ * @return - Copy of the cache's counters. All zero if the cache is disabled.
+ */
+struct ChunkCacheStats get_chunk_cache_stats(void);
+
+
+#endif
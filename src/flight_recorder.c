@@ -0,0 +1,347 @@
+/*
+ * Implementation of flight_recorder.h interface.
+ *
+ */
+
+#include "flight_recorder.h"
+
+// Values stored per edit: progress, row, column and tile.
+#define EDIT_VALUES 4
+
+double SLOW_FRAME_BUDGET_MS = 50;
+
+// Copy of the sandbox from the start of the frame, NULL until initialized.
+static unsigned char **SNAPSHOT = NULL;
+static unsigned int SNAPSHOT_HEIGHT;
+static unsigned int SNAPSHOT_WIDTH;
+
+// Sandbox being recorded, as of the start of the current frame.
+static unsigned char **FRAME_SANDBOX = NULL;
+
+// RNG state and view the frame is processed with.
+static unsigned int FRAME_LIFETIME;
+static unsigned int FRAME_SEED;
+static unsigned int FRAME_RNG_PERIOD;
+static struct SandboxView FRAME_VIEW;
+
+// Edits made during the frame, each stored as EDIT_VALUES values.
+static unsigned int FRAME_EDITS[FLIGHT_RECORDER_MAX_EDITS * EDIT_VALUES];
+static unsigned int NUM_FRAME_EDITS = 0;
+static bool HAS_DROPPED_EDITS = false;
+
+// Milliseconds spent simulating the frame so far.
+static double FRAME_SIMULATION_MS = 0;
+
+// Phase timings of the last displayed frames, with NEXT_TIMING the oldest
+// once the ring has filled up.
+static double TIMINGS[FLIGHT_RECORDER_FRAMES][NUM_FRAME_PHASES];
+static unsigned int NEXT_TIMING = 0;
+static unsigned int NUM_TIMINGS = 0;
+
+static unsigned int NUM_DUMPS = 0;
+
+// Sections written out by a dump, packed as stored, so dumping never
+// allocates. Timings are preceded by the number of phases per frame.
+static unsigned char EDIT_BYTES[FLIGHT_RECORDER_MAX_EDITS * EDIT_VALUES * 4];
+static unsigned char TIMING_BYTES[(1 + FLIGHT_RECORDER_FRAMES * NUM_FRAME_PHASES) * 4];
+
+
+// ----- PRIVATE FUNCTIONS -----
+
+
+/*
+ * Write the recorded frame out to a new save file.
+ *
+ * @param path - Path of file to write.
+ *
+ * @return - True if the whole file was written, false otherwise.
+ */
+static bool _write_frame(const char *path)
+{
+    // The snapshot is saved with the RNG state from the start of its frame.
+    unsigned int current_lifetime = SANDBOX_LIFETIME;
+    unsigned int current_seed = SANDBOX_SEED;
+    unsigned int current_rng_period = SANDBOX_RNG_PERIOD;
+
+    SANDBOX_LIFETIME = FRAME_LIFETIME;
+    SANDBOX_SEED = FRAME_SEED;
+    SANDBOX_RNG_PERIOD = FRAME_RNG_PERIOD;
+
+    bool is_written = save_sandbox(path, SNAPSHOT, SNAPSHOT_HEIGHT, SNAPSHOT_WIDTH);
+
+    SANDBOX_LIFETIME = current_lifetime;
+    SANDBOX_SEED = current_seed;
+    SANDBOX_RNG_PERIOD = current_rng_period;
+
+    unsigned char view_bytes[4 * 4];
+    pack_save_u32(&view_bytes[0], FRAME_VIEW.row);
+    pack_save_u32(&view_bytes[4], FRAME_VIEW.column);
+    pack_save_u32(&view_bytes[8], FRAME_VIEW.height);
+    pack_save_u32(&view_bytes[12], FRAME_VIEW.width);
+
+    unsigned int edit_length = NUM_FRAME_EDITS * EDIT_VALUES * 4;
+
+    for (unsigned int i = 0; i < NUM_FRAME_EDITS * EDIT_VALUES; i++)
+    {
+        pack_save_u32(&EDIT_BYTES[i * 4], FRAME_EDITS[i]);
+    }
+
+    // Timings are stored oldest first, in whole microseconds.
+    unsigned int timing_length = (1 + NUM_TIMINGS * NUM_FRAME_PHASES) * 4;
+    unsigned int oldest = NUM_TIMINGS < FLIGHT_RECORDER_FRAMES ? 0 : NEXT_TIMING;
+
+    pack_save_u32(TIMING_BYTES, NUM_FRAME_PHASES);
+
+    for (unsigned int frame = 0; frame < NUM_TIMINGS; frame++)
+    {
+        for (unsigned int phase = 0; phase < NUM_FRAME_PHASES; phase++)
+        {
+            double phase_ms = TIMINGS[(oldest + frame) % FLIGHT_RECORDER_FRAMES][phase];
+            pack_save_u32(&TIMING_BYTES[(1 + frame * NUM_FRAME_PHASES + phase) * 4], (unsigned int) (phase_ms * 1000));
+        }
+    }
+
+    // The frame has just completed, so the sandbox holds its outcome.
+    unsigned char hash_bytes[8];
+    pack_save_u64(hash_bytes, get_world_hash(FRAME_SANDBOX));
+
+    is_written = is_written
+        && append_save_section(path, "VIEW", view_bytes, sizeof(view_bytes))
+        && append_save_section(path, "EDIT", EDIT_BYTES, edit_length)
+        && append_save_section(path, "TIME", TIMING_BYTES, timing_length)
+        && append_save_section(path, "DONE", hash_bytes, sizeof(hash_bytes));
+
+    return is_written;
+}
+
+
+// ----- PUBLIC FUNCTIONS -----
+
+
+void init_flight_recorder(unsigned int height, unsigned int width)
+{
+    SNAPSHOT = create_sandbox(height, width);
+    SNAPSHOT_HEIGHT = height;
+    SNAPSHOT_WIDTH = width;
+
+    set_sandbox_memory_subsystem(SNAPSHOT, MEMORY_CAPTURE);
+    track_memory(MEMORY_CAPTURE, FRAME_EDITS, sizeof(FRAME_EDITS));
+    track_memory(MEMORY_CAPTURE, TIMINGS, sizeof(TIMINGS));
+    track_memory(MEMORY_CAPTURE, EDIT_BYTES, sizeof(EDIT_BYTES));
+    track_memory(MEMORY_CAPTURE, TIMING_BYTES, sizeof(TIMING_BYTES));
+}
+
+
+void free_flight_recorder(void)
+{
+    if (SNAPSHOT != NULL)
+    {
+        sandbox_free(SNAPSHOT, SNAPSHOT_HEIGHT, SNAPSHOT_WIDTH);
+        SNAPSHOT = NULL;
+
+        untrack_memory(MEMORY_CAPTURE, FRAME_EDITS, sizeof(FRAME_EDITS));
+        untrack_memory(MEMORY_CAPTURE, TIMINGS, sizeof(TIMINGS));
+        untrack_memory(MEMORY_CAPTURE, EDIT_BYTES, sizeof(EDIT_BYTES));
+        untrack_memory(MEMORY_CAPTURE, TIMING_BYTES, sizeof(TIMING_BYTES));
+    }
+}
+
+
+void flight_recorder_begin_frame(unsigned char **sandbox, const struct SandboxView *view)
+{
+    copy_sandbox(SNAPSHOT, sandbox, SNAPSHOT_HEIGHT, SNAPSHOT_WIDTH);
+    FRAME_SANDBOX = sandbox;
+
+    FRAME_LIFETIME = SANDBOX_LIFETIME;
+    FRAME_SEED = SANDBOX_SEED;
+    FRAME_RNG_PERIOD = SANDBOX_RNG_PERIOD;
+
+    // An empty view stands in for no view at all.
+    struct SandboxView no_view = {0, 0, 0, 0};
+    FRAME_VIEW = view != NULL ? *view : no_view;
+
+    NUM_FRAME_EDITS = 0;
+    HAS_DROPPED_EDITS = false;
+    FRAME_SIMULATION_MS = 0;
+}
+
+
+void flight_recorder_record_edit(unsigned int row_index, unsigned int column_index, unsigned char tile)
+{
+    if (NUM_FRAME_EDITS == FLIGHT_RECORDER_MAX_EDITS)
+    {
+        HAS_DROPPED_EDITS = true;
+        return;
+    }
+
+    unsigned int *edit = &FRAME_EDITS[NUM_FRAME_EDITS++ * EDIT_VALUES];
+    edit[0] = FRAME_SANDBOX != NULL ? get_sandbox_frame_progress(FRAME_SANDBOX) : 0;
+    edit[1] = row_index;
+    edit[2] = column_index;
+    edit[3] = tile;
+}
+
+
+void flight_recorder_record_phases(const double phase_ms[NUM_FRAME_PHASES])
+{
+    memcpy(TIMINGS[NEXT_TIMING], phase_ms, sizeof(TIMINGS[NEXT_TIMING]));
+    NEXT_TIMING = (NEXT_TIMING + 1) % FLIGHT_RECORDER_FRAMES;
+
+    if (NUM_TIMINGS < FLIGHT_RECORDER_FRAMES)
+    {
+        NUM_TIMINGS++;
+    }
+
+    FRAME_SIMULATION_MS += phase_ms[PHASE_SIMULATION];
+}
+
+
+bool flight_recorder_end_frame(void)
+{
+    if (SNAPSHOT == NULL || SLOW_FRAME_BUDGET_MS < 0 || FRAME_SIMULATION_MS <= SLOW_FRAME_BUDGET_MS)
+    {
+        return false;
+    }
+
+    if (HAS_DROPPED_EDITS || NUM_DUMPS == FLIGHT_RECORDER_MAX_DUMPS)
+    {
+        return false;
+    }
+
+    char path[64];
+    snprintf(path, sizeof(path), "slow_frame_%u.sand", FRAME_LIFETIME);
+
+    if (!_write_frame(path))
+    {
+        fprintf(stderr, "Frame %u took %.1f ms, but could not be written to %s\n", FRAME_LIFETIME, FRAME_SIMULATION_MS, path);
+        return false;
+    }
+
+    NUM_DUMPS++;
+    fprintf(stderr, "Frame %u took %.1f ms, written to %s\n", FRAME_LIFETIME, FRAME_SIMULATION_MS, path);
+
+    return true;
+}
+
+
+unsigned char **replay_flight_record(const char *path,
+        unsigned int *height,
+        unsigned int *width,
+        double *elapsed_ms)
+{
+    unsigned int view_length;
+    unsigned int edit_length;
+    unsigned char *view_bytes = load_save_section(path, "VIEW", &view_length);
+    unsigned char *edit_bytes = load_save_section(path, "EDIT", &edit_length);
+    unsigned char **sandbox = NULL;
+
+    if (view_bytes != NULL && view_length == 4 * 4 && edit_bytes != NULL)
+    {
+        sandbox = load_sandbox(path, height, width);
+    }
+
+    if (sandbox == NULL)
+    {
+        free(view_bytes);
+        free(edit_bytes);
+        return NULL;
+    }
+
+    struct SandboxView view;
+    view.row = unpack_save_u32(&view_bytes[0]);
+    view.column = unpack_save_u32(&view_bytes[4]);
+    view.height = unpack_save_u32(&view_bytes[8]);
+    view.width = unpack_save_u32(&view_bytes[12]);
+
+    clock_t start_time = clock();
+    bool is_frame_complete = false;
+
+    for (unsigned int offset = 0; offset + EDIT_VALUES * 4 <= edit_length; offset += EDIT_VALUES * 4)
+    {
+        unsigned int progress = unpack_save_u32(&edit_bytes[offset]);
+        unsigned int row_index = unpack_save_u32(&edit_bytes[offset + 4]);
+        unsigned int column_index = unpack_save_u32(&edit_bytes[offset + 8]);
+        unsigned char tile = unpack_save_u32(&edit_bytes[offset + 12]);
+
+        // A budget of 0 stops after every chunk processed, which includes
+        // every point the original frame could have stopped at.
+        while (!is_frame_complete && get_sandbox_frame_progress(sandbox) < progress)
+        {
+            is_frame_complete = process_sandbox_budgeted(sandbox, *height, *width, &view, 0);
+        }
+
+        if (row_index < *height && column_index < *width)
+        {
+            edit_tile(sandbox, row_index, column_index, tile);
+        }
+    }
+
+    if (!is_frame_complete)
+    {
+        process_sandbox_budgeted(sandbox, *height, *width, &view, -1);
+    }
+
+    *elapsed_ms = (clock() - start_time) * 1000.0 / CLOCKS_PER_SEC;
+
+    free(view_bytes);
+    free(edit_bytes);
+
+    return sandbox;
+}
+
+
+bool print_flight_record_timings(const char *path, FILE *stream)
+{
+    static const char *PHASE_NAMES[NUM_FRAME_PHASES] = {"input", "simulation", "draw", "present"};
+
+    unsigned int length;
+    unsigned char *timing_bytes = load_save_section(path, "TIME", &length);
+
+    if (timing_bytes == NULL || length < 4)
+    {
+        free(timing_bytes);
+        return false;
+    }
+
+    unsigned int num_phases = unpack_save_u32(timing_bytes);
+    unsigned int num_frames = num_phases ? (length / 4 - 1) / num_phases : 0;
+
+    fprintf(stream, "Phase timings (ms) of the last %u displayed frames:\n", num_frames);
+
+    for (unsigned int phase = 0; phase < num_phases && phase < NUM_FRAME_PHASES; phase++)
+    {
+        fprintf(stream, " %10s", PHASE_NAMES[phase]);
+    }
+
+    fprintf(stream, "\n");
+
+    for (unsigned int frame = 0; frame < num_frames; frame++)
+    {
+        for (unsigned int phase = 0; phase < num_phases && phase < NUM_FRAME_PHASES; phase++)
+        {
+            unsigned int phase_us = unpack_save_u32(&timing_bytes[(1 + frame * num_phases + phase) * 4]);
+            fprintf(stream, " %10.3f", phase_us / 1000.0);
+        }
+
+        fprintf(stream, "\n");
+    }
+
+    free(timing_bytes);
+    return true;
+}
+
+
+bool get_flight_record_hash(const char *path, unsigned long long *hash)
+{
+    unsigned int length;
+    unsigned char *hash_bytes = load_save_section(path, "DONE", &length);
+    bool has_hash = hash_bytes != NULL && length == 8;
+
+    if (has_hash)
+    {
+        *hash = unpack_save_u64(hash_bytes);
+    }
+
+    free(hash_bytes);
+    return has_hash;
+}
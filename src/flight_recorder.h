@@ -0,0 +1,141 @@
+#ifndef FLIGHT_RECORDER_H
+#define FLIGHT_RECORDER_H
+
+/*
+ * A flight recorder keeping just enough history to reproduce a slow frame of
+ * simulation offline.
+ *
+ * At the start of every frame, the recorder copies the sandbox, along with
+ * the frame's RNG state and view. Edits made while the frame is processed are
+ * recorded along with how far the frame had got when they were made, and the
+ * time taken by each phase of the last FLIGHT_RECORDER_FRAMES displayed
+ * frames is kept as well.
+ *
+ * Whenever a frame's simulation takes longer than SLOW_FRAME_BUDGET_MS, all
+ * of it is written to a save file, with sections tagged "VIEW", "EDIT",
+ * "TIME" and "DONE" besides the sandbox itself. replay_flight_record() then
+ * processes the exact same frame again, such as under a profiler by the
+ * headless replay program, which checks it ends with the world hash held by
+ * "DONE".
+ *
+ */
+
+#include "sandbox.h"
+#include "save.h"
+
+// Number of displayed frames whose phase timings are kept.
+#define FLIGHT_RECORDER_FRAMES 64
+
+// Maximum number of edits recorded per frame. Frames with more edits than
+// this cannot be reproduced, and are never written out.
+#define FLIGHT_RECORDER_MAX_EDITS 4096
+
+// Maximum number of slow frames written out per run, so a run that is slow
+// throughout does not fill up the disk.
+#define FLIGHT_RECORDER_MAX_DUMPS 8
+
+
+// Parts each displayed frame is made up of, in order.
+enum frame_phase {PHASE_INPUT, PHASE_SIMULATION, PHASE_DRAW, PHASE_PRESENT, NUM_FRAME_PHASES};
+
+
+// Milliseconds of simulation a frame may take before it is written out.
+// Negative to never write out frames.
+extern double SLOW_FRAME_BUDGET_MS;
+
+
+/*
+ * Allocate the recorder's copy of a sandbox with the given dimensions.
+ *
+ * @param height, width - Dimensions of sandbox to be recorded.
+ */
+void init_flight_recorder(unsigned int height, unsigned int width);
+
+
+/*
+ * Free everything allocated by init_flight_recorder().
+ */
+void free_flight_recorder(void);
+
+
+/*
+ * Record the state of the sandbox before a new frame of it is processed.
+ *
+ * Must be called while no frame of it is in progress, see
+ * is_sandbox_mid_frame().
+ *
+ * @param sandbox - Sandbox about to be processed.
+ * @param view - View the frame will be processed with, or NULL.
+ */
+void flight_recorder_begin_frame(unsigned char **sandbox, const struct SandboxView *view);
+
+
+/*
+ * Record a tile written into the sandbox from outside the simulation, at the
+ * point of its frame given by get_sandbox_frame_progress().
+ *
+ * @param row_index, column_index - Coordinates of written tile.
+ * @param tile - Tile written.
+ */
+void flight_recorder_record_edit(unsigned int row_index, unsigned int column_index, unsigned char tile);
+
+
+/*
+ * Record the time taken by each phase of a displayed frame.
+ *
+ * @param phase_ms - Milliseconds taken by each phase, by enum frame_phase.
+ */
+void flight_recorder_record_phases(const double phase_ms[NUM_FRAME_PHASES]);
+
+
+/*
+ * Record that the frame begun by flight_recorder_begin_frame() is complete,
+ * and write it out if its simulation took longer than SLOW_FRAME_BUDGET_MS.
+ *
+ * @return - True if the frame was written out, false otherwise.
+ */
+bool flight_recorder_end_frame(void);
+
+
+/*
+ * Process the frame held by a file written out by the flight recorder again,
+ * applying its edits at the same points of the frame as originally.
+ *
+ * @param path - Path of file to replay.
+ * @param height, width - Set to the dimensions of the replayed sandbox.
+ * @param elapsed_ms - Set to the milliseconds spent processing the frame.
+ *
+ * @return - Newly created sandbox as of the end of the frame, or NULL if the
+ * file could not be read.
+ */
+unsigned char **replay_flight_record(const char *path,
+        unsigned int *height,
+        unsigned int *width,
+        double *elapsed_ms);
+
+
+/*
+ * Print the phase timings held by a file written out by the flight recorder,
+ * oldest displayed frame first.
+ *
+ * @param path - Path of file to read.
+ * @param stream - Stream to print to.
+ *
+ * @return - True if the file held timings, false otherwise.
+ */
+bool print_flight_record_timings(const char *path, FILE *stream);
+
+
+/*
+ * Read the world hash the sandbox had at the end of the frame held by a file
+ * written out by the flight recorder, which a replay of it must end with.
+ *
+ * @param path - Path of file to read.
+ * @param hash - Set to the world hash.
+ *
+ * @return - True if the file held a world hash, false otherwise.
+ */
+bool get_flight_record_hash(const char *path, unsigned long long *hash);
+
+
+#endif
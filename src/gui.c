@@ -23,6 +23,163 @@ SDL_Texture **PANEL_TEXTURES;
 
 // ----- PRIVATE FUNCTIONS -----
 
+/*
+ * Find the sandbox coordinates of the tile under the mouse.
+ *
+ * Mouse screen coordinates are scaled down by PIXEL_SCALE.
+ *
+ * @param mouse - Pointer to mouse to get location of.
+ * @param row_index, col_index - Set to coordinates of tile.
+ */
+static void _get_mouse_tile(struct Mouse *mouse, unsigned int *row_index, unsigned int *col_index)
+{
+    // Downscale the mouse coordinates to floating sandbox coordinates.
+    float row_coordinate = (float) mouse -> y / PIXEL_SCALE;
+    float col_coordinate = (float) mouse -> x / PIXEL_SCALE;
+
+    // Round to the nearest integer to obtain valid sandbox indices.
+    *row_index = roundf(row_coordinate);
+    *col_index = roundf(col_coordinate);
+}
+
+
+/*
+ * Find the rectangle of tiles selected within the clipboard.
+ *
+ * @param clipboard - Clipboard holding selection.
+ * @param row_index, column_index - Set to coordinates of top left tile.
+ * @param height, width - Set to dimensions of rectangle.
+ */
+static void _get_selection(const struct Clipboard *clipboard,
+        unsigned int *row_index,
+        unsigned int *column_index,
+        unsigned int *height,
+        unsigned int *width)
+{
+    bool is_anchor_above = clipboard -> anchor_row < clipboard -> end_row;
+    bool is_anchor_left = clipboard -> anchor_column < clipboard -> end_column;
+
+    *row_index = is_anchor_above ? clipboard -> anchor_row : clipboard -> end_row;
+    *column_index = is_anchor_left ? clipboard -> anchor_column : clipboard -> end_column;
+    *height = (is_anchor_above ? clipboard -> end_row : clipboard -> anchor_row) - *row_index + 1;
+    *width = (is_anchor_left ? clipboard -> end_column : clipboard -> anchor_column) - *column_index + 1;
+}
+
+
+/*
+ * Choose the stamp after the current one in the clipboard's library to paste,
+ * going back to the first after the last.
+ *
+ * @param clipboard - Clipboard to choose stamp of.
+ */
+static void _choose_next_stamp(struct Clipboard *clipboard)
+{
+    struct StampLibrary *library = clipboard -> library;
+
+    if (library -> num_stamps == 0)
+    {
+        return;
+    }
+
+    clipboard -> stamp_index = (clipboard -> stamp_index + 1) % library -> num_stamps;
+    printf("Pasting stamp \"%s\"\n", library -> names[clipboard -> stamp_index]);
+}
+
+
+/*
+ * Show the frame of the player's recording under the mouse, spreading every
+ * frame across the width of the window.
+ *
+ * @param app - App holding the player and mouse.
+ */
+static void _scrub(struct Application *app)
+{
+    unsigned int num_frames = app -> player -> recording -> num_frames;
+    int x = app -> mouse -> x > 0 ? app -> mouse -> x : 0;
+    unsigned int frame = (unsigned long long) x * num_frames / WINDOW_WIDTH;
+
+    app -> player -> frame = frame < num_frames ? frame : num_frames - 1;
+    app -> player -> is_playing = false;
+}
+
+
+/*
+ * Move through the player's recording as asked for by a keypress.
+ *
+ * @param player - Player to move.
+ * @param keycode - Key pressed.
+ */
+static void _do_player_key_press(struct Player *player, SDL_Keycode keycode)
+{
+    unsigned int last_frame = player -> recording -> num_frames - 1;
+
+    switch (keycode)
+    {
+        // Play on from the start once the end is reached.
+        case SDLK_SPACE:
+            player -> is_playing = !player -> is_playing;
+
+            if (player -> is_playing && player -> frame == last_frame)
+            {
+                player -> frame = 0;
+            }
+            break;
+
+        case SDLK_RIGHT:
+            player -> frame = player -> frame < last_frame ? player -> frame + 1 : last_frame;
+            player -> is_playing = false;
+            break;
+
+        case SDLK_LEFT:
+            player -> frame = player -> frame > 0 ? player -> frame - 1 : 0;
+            player -> is_playing = false;
+            break;
+
+        case SDLK_UP:
+            player -> frame = last_frame - player -> frame > PLAYBACK_JUMP_FRAMES
+                ? player -> frame + PLAYBACK_JUMP_FRAMES
+                : last_frame;
+            break;
+
+        case SDLK_DOWN:
+            player -> frame = player -> frame > PLAYBACK_JUMP_FRAMES ? player -> frame - PLAYBACK_JUMP_FRAMES : 0;
+            break;
+
+        case SDLK_HOME:
+            player -> frame = 0;
+            break;
+
+        case SDLK_END:
+            player -> frame = last_frame;
+            break;
+
+        default:
+            break;
+    }
+}
+
+
+/*
+ * Draw a timeline along the bottom of the window, filled up to the frame of
+ * the player's recording shown.
+ *
+ * @param app - App holding the player.
+ */
+static void _draw_timeline(struct Application *app)
+{
+    struct Player *player = app -> player;
+    int played_width = (unsigned long long) (player -> frame + 1) * WINDOW_WIDTH / player -> recording -> num_frames;
+
+    SDL_Rect timeline = {0, WINDOW_HEIGHT - TIMELINE_HEIGHT, WINDOW_WIDTH, TIMELINE_HEIGHT};
+    SDL_SetRenderDrawColor(app -> renderer, 64, 64, 64, 255);
+    SDL_RenderFillRect(app -> renderer, &timeline);
+
+    timeline.w = played_width;
+    SDL_SetRenderDrawColor(app -> renderer, 255, 255, 255, 255);
+    SDL_RenderFillRect(app -> renderer, &timeline);
+}
+
+
 /*
  * Update mouse button pressed-down data in the given app by extracting mouse 
  * data from the mouse button event.
@@ -36,6 +193,27 @@ static void _do_mouse_button_down(struct Application *app, SDL_MouseButtonEvent
     {
         app -> mouse -> is_left_clicking = true;
     }
+
+    // While playing back a recording, the left button scrubs through it
+    // instead.
+    if (event -> button == SDL_BUTTON_LEFT && app -> player != NULL)
+    {
+        app -> player -> is_scrubbing = true;
+        _scrub(app);
+    }
+
+    // The right button starts selecting a new rectangle from the tile under
+    // the mouse.
+    if (event -> button == SDL_BUTTON_RIGHT)
+    {
+        struct Clipboard *clipboard = app -> clipboard;
+        _get_mouse_tile(app -> mouse, &clipboard -> anchor_row, &clipboard -> anchor_column);
+
+        clipboard -> end_row = clipboard -> anchor_row;
+        clipboard -> end_column = clipboard -> anchor_column;
+        clipboard -> is_selecting = true;
+        clipboard -> has_selection = true;
+    }
 }
 
 
@@ -53,6 +231,16 @@ static void _do_mouse_button_up(struct Application *app, SDL_MouseButtonEvent *e
     if (event -> button == SDL_BUTTON_LEFT)
     {
         app -> mouse -> is_left_clicking = false;
+
+        if (app -> player != NULL)
+        {
+            app -> player -> is_scrubbing = false;
+        }
+    }
+
+    if (event -> button == SDL_BUTTON_RIGHT)
+    {
+        app -> clipboard -> is_selecting = false;
     }
 }
 
@@ -72,6 +260,13 @@ static void _do_keyboard_press(struct Application *app, SDL_KeyboardEvent *event
     SDL_Keysym key_data = event -> keysym;
     SDL_Keycode keycode = key_data.sym;
 
+    // Recordings played back cannot be edited, only moved through.
+    if (app -> player != NULL)
+    {
+        _do_player_key_press(app -> player, keycode);
+        return;
+    }
+
     switch (keycode)
     {
         // In the event of keys 0 - 9, switch mouse tile to appropriate type.
@@ -91,6 +286,35 @@ static void _do_keyboard_press(struct Application *app, SDL_KeyboardEvent *event
             switch_selected_tile(app_mouse, STEAM);
             break;
 
+        // Report how long placed tiles have been taking to show up.
+        case SDLK_l:
+            print_latency_report(stdout);
+            break;
+
+        // Report the memory held by each subsystem.
+        case SDLK_m:
+            print_memory_report(stdout);
+            break;
+
+        // Copy or cut the selection, or paste the chosen stamp, once the
+        // current frame is done.
+        case SDLK_c:
+            app -> clipboard -> action = CLIPBOARD_COPY;
+            break;
+
+        case SDLK_x:
+            app -> clipboard -> action = CLIPBOARD_CUT;
+            break;
+
+        case SDLK_v:
+            app -> clipboard -> action = CLIPBOARD_PASTE;
+            break;
+
+        // Choose the next stamp of the library to paste.
+        case SDLK_TAB:
+            _choose_next_stamp(app -> clipboard);
+            break;
+
         // In an unhandled keypress, do nothing.
         default:
             break;
@@ -99,6 +323,69 @@ static void _do_keyboard_press(struct Application *app, SDL_KeyboardEvent *event
 }
 
 
+/*
+ * Return the milliseconds passed since the given lap started, and start the
+ * next lap.
+ *
+ * @param lap_start - Performance counter value the lap started at, set to
+ * the current value.
+ *
+ * @return - Milliseconds the lap took.
+ */
+static double _lap_ms(Uint64 *lap_start)
+{
+    Uint64 now = SDL_GetPerformanceCounter();
+    double elapsed_ms = (now - *lap_start) * 1000.0 / SDL_GetPerformanceFrequency();
+
+    *lap_start = now;
+    return elapsed_ms;
+}
+
+
+/*
+ * Return the bytes of pixels held by a texture.
+ *
+ * @param texture - Texture to measure.
+ *
+ * @return - Bytes of pixels, or 0 if the texture could not be loaded.
+ */
+static size_t _get_texture_bytes(SDL_Texture *texture)
+{
+    Uint32 format;
+    int width;
+    int height;
+
+    if (texture == NULL || SDL_QueryTexture(texture, &format, NULL, &width, &height) != 0)
+    {
+        return 0;
+    }
+
+    return (size_t) width * height * SDL_BYTESPERPIXEL(format);
+}
+
+
+/*
+ * Show the memory held by the program in the window title, with its
+ * high-water mark.
+ *
+ * @param app - App to retitle.
+ * @param title - Title of the window without the memory shown.
+ */
+static void _show_memory_usage(struct Application *app, const char *title)
+{
+    struct MemoryStats stats = get_memory_stats();
+    char full_title[256];
+
+    snprintf(full_title, sizeof(full_title), "%s - %.1f MiB resident, %.1f MiB allocated (peak %.1f MiB)",
+            title,
+            stats.total.resident / 1048576.0,
+            stats.total.allocated / 1048576.0,
+            stats.total.peak_allocated / 1048576.0);
+
+    SDL_SetWindowTitle(app -> window, full_title);
+}
+
+
 /*
  * Unload all tile textures from memory, destroying them and freeing the array
  * of tile_textures.
@@ -107,6 +394,13 @@ static void _destroy_textures(void)
 {
     for (int i = 0; i < NUM_UNIQUE_TILES; i++)
     {
+        // Placeholders share the textures of air, so only destroy those once.
+        if (i != AIR && TILE_TEXTURES[i] == TILE_TEXTURES[AIR])
+        {
+            continue;
+        }
+
+        untrack_memory(MEMORY_TEXTURES, NULL, _get_texture_bytes(TILE_TEXTURES[i]) + _get_texture_bytes(PANEL_TEXTURES[i]));
         SDL_DestroyTexture(TILE_TEXTURES[i]);
         SDL_DestroyTexture(PANEL_TEXTURES[i]);
     }
@@ -175,6 +469,14 @@ struct Application *init_gui(char *title)
     new_mouse -> selected_tile = SAND;
     app -> mouse = new_mouse;
 
+    // Start out with nothing selected, and the prefabs to paste.
+    app -> clipboard = (struct Clipboard *) calloc(1, sizeof(struct Clipboard));
+    app -> clipboard -> library = create_stamp_library();
+
+    // Nothing is recorded or played back unless asked for.
+    app -> recorder = NULL;
+    app -> player = NULL;
+
     // Allocate memory for all textures used by the 16 possible tile types.
     init_textures(app);
 
@@ -204,11 +506,19 @@ void init_textures(struct Application *app)
     PANEL_TEXTURES[STEAM] = load_texture(app, "assets/panels/steam_panel.png");
     PANEL_TEXTURES[FIRE] = load_texture(app, "assets/panels/fire_panel.png");
 
-    // Placeholder textures while other tiles are being implemented.
+    // Placeholder textures while other tiles are being implemented, sharing
+    // those of air rather than decoding them again.
     for (int i  = 6; i < NUM_UNIQUE_TILES; i++)
     {
-        TILE_TEXTURES[i] = load_texture(app, "assets/tiles/air.png");
-        PANEL_TEXTURES[i] = load_texture(app, "assets/panels/air_panel.png");
+        TILE_TEXTURES[i] = TILE_TEXTURES[AIR];
+        PANEL_TEXTURES[i] = PANEL_TEXTURES[AIR];
+    }
+
+    // Textures live with the graphics driver rather than in this process'
+    // memory, so only their size is known.
+    for (int i = 0; i < 6; i++)
+    {
+        track_memory(MEMORY_TEXTURES, NULL, _get_texture_bytes(TILE_TEXTURES[i]) + _get_texture_bytes(PANEL_TEXTURES[i]));
     }
 }
 
@@ -219,6 +529,21 @@ void cleanup(struct Application *app)
     SDL_DestroyWindow(app -> window);
     SDL_DestroyRenderer(app -> renderer);
     free(app -> mouse);
+    free_stamp_library(app -> clipboard -> library);
+    free(app -> clipboard);
+
+    // Finish any recording, so it can be sought through without reading all
+    // of it.
+    if (app -> recorder != NULL && !finish_recording(app -> recorder))
+    {
+        fprintf(stderr, "Could not finish recording\n");
+    }
+
+    if (app -> player != NULL)
+    {
+        close_recording(app -> player -> recording);
+        free(app -> player);
+    }
     free(app);
 
     // Remove textures before exiting.
@@ -230,7 +555,15 @@ void cleanup(struct Application *app)
 
 SDL_Texture *load_texture(struct Application *app, char *filename)
 {
-    // Call SDL_image to load image.
+    const struct Asset *asset = get_asset(filename);
+
+    // Call SDL_image to load image, from memory if it was compiled in.
+    if (asset != NULL)
+    {
+        SDL_RWops *source = SDL_RWFromConstMem(asset -> data, asset -> size);
+        return IMG_LoadTexture_RW(app -> renderer, source, 1);
+    }
+
     SDL_Texture *texture = IMG_LoadTexture(app -> renderer, filename);
     return texture;
 }
@@ -308,6 +641,17 @@ void draw_ui(struct Application *app)
     // topleft of the screen.
     SDL_Texture *panel_texture = get_panel_texture(app -> mouse -> selected_tile);
     blit_texture(app, panel_texture, 0, 0);
+
+    // Outline the tiles selected to copy or cut.
+    if (app -> clipboard -> has_selection)
+    {
+        unsigned int row_index, column_index, height, width;
+        _get_selection(app -> clipboard, &row_index, &column_index, &height, &width);
+
+        SDL_Rect outline = {column_index * PIXEL_SCALE, row_index * PIXEL_SCALE, width * PIXEL_SCALE, height * PIXEL_SCALE};
+        SDL_SetRenderDrawColor(app -> renderer, 255, 255, 255, 255);
+        SDL_RenderDrawRect(app -> renderer, &outline);
+    }
 }
 
 
@@ -337,6 +681,9 @@ void get_input(struct Application *app)
         {
             // Free memory taken up by app, then shutdown.
             case SDL_QUIT:
+                print_latency_report(stdout);
+                stop_metrics_server();
+                free_flight_recorder();
                 cleanup(app);
                 exit(0);
 
@@ -344,6 +691,26 @@ void get_input(struct Application *app)
             // when it is pressed down and up.
             case SDL_MOUSEBUTTONDOWN:
                 _do_mouse_button_down(app, &event.button);
+                latency_record_input(event.button.timestamp, SDL_GetTicks());
+                break;
+
+            // Dragging the mouse while holding it down places more tiles.
+            case SDL_MOUSEMOTION:
+                if (app -> mouse -> is_left_clicking)
+                {
+                    latency_record_input(event.motion.timestamp, SDL_GetTicks());
+                }
+
+                if (app -> player != NULL && app -> player -> is_scrubbing)
+                {
+                    _scrub(app);
+                }
+
+                // Dragging the right button stretches the selection.
+                if (app -> clipboard -> is_selecting)
+                {
+                    _get_mouse_tile(app -> mouse, &app -> clipboard -> end_row, &app -> clipboard -> end_column);
+                }
                 break;
 
             case SDL_MOUSEBUTTONUP:
@@ -374,23 +741,19 @@ void switch_selected_tile(struct Mouse *mouse, unsigned char tile_type)
 }
 
 
-void place_tile(struct Mouse *mouse,
+bool place_tile(struct Mouse *mouse,
         unsigned char **sandbox,
         unsigned int height,
         unsigned int width)
 {
-    // Downscale the mouse coordinates to floating sandbox coordinates.
-    float row_coordinate = (float) mouse -> y / PIXEL_SCALE;
-    float col_coordinate = (float) mouse -> x / PIXEL_SCALE;
-
-    // Round to the nearest integer to obtain valid sandbox indices.
-    unsigned int row_index = roundf(row_coordinate);
-    unsigned int col_index = roundf(col_coordinate);
+    unsigned int row_index;
+    unsigned int col_index;
+    _get_mouse_tile(mouse, &row_index, &col_index);
 
     // Don't replace tiles, only place them ontop of air.
     if (get_tile_id(sandbox[row_index][col_index]) != AIR)
     {
-        return;
+        return false;
     }
 
 
@@ -398,39 +761,381 @@ void place_tile(struct Mouse *mouse,
     //
     // A tile type has value (0000 XXXX) where XXXX is the tile type.
     // This produces a new, non-updated, non-static tile of type XXXX.
-    sandbox[row_index][col_index] = mouse -> selected_tile;
+    //
+    // Editing lets sparse chunks know there is a new tile to visit. Keep it
+    // as well in case the frame turns out slow.
+    edit_tile(sandbox, row_index, col_index, mouse -> selected_tile);
+    flight_recorder_record_edit(row_index, col_index, mouse -> selected_tile);
+
+    return true;
+}
+
+
+bool apply_clipboard(struct Application *app,
+        unsigned char **sandbox,
+        unsigned int height,
+        unsigned int width,
+        bool can_edit)
+{
+    struct Clipboard *clipboard = app -> clipboard;
+    enum clipboard_action action = clipboard -> action;
+    clipboard -> action = CLIPBOARD_NONE;
+
+    if (action == CLIPBOARD_NONE || (action != CLIPBOARD_COPY && !can_edit))
+    {
+        return false;
+    }
+
+    if (action == CLIPBOARD_PASTE)
+    {
+        struct StampLibrary *library = clipboard -> library;
+
+        if (library -> num_stamps == 0)
+        {
+            return false;
+        }
+
+        const struct Stamp *stamp = library -> stamps[clipboard -> stamp_index];
+        unsigned int row_index;
+        unsigned int column_index;
+        _get_mouse_tile(app -> mouse, &row_index, &column_index);
+
+        paste_stamp(sandbox, height, width, stamp, (int) row_index - stamp -> height / 2, (int) column_index - stamp -> width / 2);
+        return true;
+    }
+
+    if (!clipboard -> has_selection)
+    {
+        return false;
+    }
+
+    unsigned int row_index, column_index, selection_height, selection_width;
+    _get_selection(clipboard, &row_index, &column_index, &selection_height, &selection_width);
+
+    // Air is left out of the stamp, so pasting it does not clear around it.
+    struct Stamp *stamp = action == CLIPBOARD_CUT
+        ? cut_stamp(sandbox, height, width, row_index, column_index, selection_height, selection_width, true)
+        : copy_stamp(sandbox, height, width, row_index, column_index, selection_height, selection_width, true);
+
+    if (stamp == NULL || !add_library_stamp(clipboard -> library, CLIPBOARD_STAMP_NAME, stamp))
+    {
+        free_stamp(stamp);
+        return false;
+    }
+
+    // Paste what was just copied next.
+    for (unsigned int i = 0; i < clipboard -> library -> num_stamps; i++)
+    {
+        if (clipboard -> library -> stamps[i] == stamp)
+        {
+            clipboard -> stamp_index = i;
+        }
+    }
+
+    clipboard -> has_selection = false;
+
+    return action == CLIPBOARD_CUT;
+}
+
+
+void play_recording(struct Application *app, const char *title)
+{
+    struct Player *player = app -> player;
+    struct Recording *recording = player -> recording;
+
+    // No frame is shown before the first.
+    unsigned int shown_frame = recording -> num_frames;
+
+    while (true)
+    {
+        set_black_background(app);
+
+        get_input(app);
+
+        // Playing stops at the last frame.
+        if (player -> is_playing)
+        {
+            player -> is_playing = player -> frame + 1 < recording -> num_frames;
+            player -> frame += player -> is_playing;
+        }
+
+        if (player -> frame != shown_frame)
+        {
+            Uint64 seek_start = SDL_GetPerformanceCounter();
+            bool is_intact = seek_recording(recording, player -> frame);
+            double seek_ms = _lap_ms(&seek_start);
+            char full_title[256];
+
+            snprintf(full_title, sizeof(full_title), "%s - frame %u of %u (lifetime %u, %.1f ms to seek)%s",
+                    title,
+                    player -> frame + 1,
+                    recording -> num_frames,
+                    recording -> lifetime,
+                    seek_ms,
+                    is_intact ? "" : " - DAMAGED");
+
+            SDL_SetWindowTitle(app -> window, full_title);
+            shown_frame = player -> frame;
+        }
+
+        draw_sandbox(app, recording -> sandbox, recording -> height, recording -> width);
+        _draw_timeline(app);
+
+        SDL_RenderPresent(app -> renderer);
+
+        // Play at ~30 FPS, as recorded.
+        SDL_Delay(33);
+    }
+}
+
+
+bool queue_tile(struct Mouse *mouse, struct LockstepSession *session, unsigned char **sandbox)
+{
+    unsigned int row_index;
+    unsigned int col_index;
+    _get_mouse_tile(mouse, &row_index, &col_index);
+
+    // Every client checks again for air when placing the tile, as other
+    // clients' tiles may land there first.
+    if (get_tile_id(sandbox[row_index][col_index]) != AIR)
+    {
+        return false;
+    }
+
+    return lockstep_queue_edit(session, 0, row_index, col_index, mouse -> selected_tile);
 }
 
 
 int main(int argc, char *argv[])
 {
+    // Time startup up to the first displayed frame.
+    Uint64 startup_start = SDL_GetPerformanceCounter();
+    bool is_first_frame = true;
+
+    // Play back a recording in place of a simulation only when asked to,
+    // in a window fitting its sandbox.
+    char *playback_path = getenv(PLAYBACK_VARIABLE);
+    struct Recording *playback = NULL;
+
+    if (playback_path != NULL)
+    {
+        playback = open_recording(playback_path);
+
+        if (playback == NULL)
+        {
+            fprintf(stderr, "Could not open recording %s\n", playback_path);
+            return 1;
+        }
+
+        SANDBOX_HEIGHT = playback -> height;
+        SANDBOX_WIDTH = playback -> width;
+    }
+
     // Initialize SDL, create an app, and load in textures.
-    struct Application *app = init_gui("Sandbox");
+    char *title = "Sandbox";
+    struct Application *app = init_gui(title);
+    Uint32 memory_shown_ms = 0;
+
+    if (playback != NULL)
+    {
+        app -> player = (struct Player *) calloc(1, sizeof(struct Player));
+        app -> player -> recording = playback;
+
+        play_recording(app, title);
+    }
 
     // Form a sandbox.
     unsigned char **sandbox = create_sandbox(SANDBOX_HEIGHT, SANDBOX_WIDTH);
 
+    // Start from a generated world only when asked to.
+    char *world_seed = getenv(WORLD_SEED_VARIABLE);
+
+    if (world_seed != NULL)
+    {
+        generate_world(sandbox, SANDBOX_HEIGHT, SANDBOX_WIDTH, strtoul(world_seed, NULL, 10), 0);
+    }
+
+    // Record every frame only when asked to, starting from the world as
+    // generated.
+    char *recording_path = getenv(RECORDING_VARIABLE);
+
+    if (recording_path != NULL)
+    {
+        app -> recorder = start_recording(recording_path, sandbox, SANDBOX_HEIGHT, SANDBOX_WIDTH);
+
+        if (app -> recorder == NULL)
+        {
+            fprintf(stderr, "Could not record to %s\n", recording_path);
+        }
+    }
+
+    // Copy of the sandbox as of the last completed frame, displayed while a
+    // frame is still being processed.
+    unsigned char **last_frame = create_sandbox(SANDBOX_HEIGHT, SANDBOX_WIDTH);
+    set_sandbox_memory_subsystem(last_frame, MEMORY_SNAPSHOTS);
+
+    // The window shows the whole sandbox, so all of it is in view.
+    struct SandboxView view = {0, 0, SANDBOX_HEIGHT, SANDBOX_WIDTH};
+
+    // Keep what is needed to reproduce frames taking too long.
+    init_flight_recorder(SANDBOX_HEIGHT, SANDBOX_WIDTH);
+
+    // Serve metrics only when asked to.
+    char *metrics_port = getenv(METRICS_PORT_VARIABLE);
+
+    if (metrics_port != NULL && !start_metrics_server(atoi(metrics_port)))
+    {
+        fprintf(stderr, "Could not serve metrics on port %s\n", metrics_port);
+    }
+
+    // Share the sandbox with local lockstep clients only when asked to.
+    struct LockstepSession *session = NULL;
+    char *lockstep_clients = getenv(LOCKSTEP_CLIENTS_VARIABLE);
+
+    if (lockstep_clients != NULL)
+    {
+        session = create_lockstep_session(sandbox, SANDBOX_HEIGHT, SANDBOX_WIDTH, atoi(lockstep_clients));
+
+        if (session == NULL)
+        {
+            fprintf(stderr, "Could not start a lockstep session of %s clients\n", lockstep_clients);
+        }
+        else
+        {
+            // Edits are made between whole frames rather than during them,
+            // which the flight recorder does not know about.
+            SLOW_FRAME_BUDGET_MS = -1;
+        }
+    }
+
     while (true)
     {
+        double phase_ms[NUM_FRAME_PHASES];
+        Uint64 lap_start = SDL_GetPerformanceCounter();
+
+        // Snapshot the sandbox before any edits land in a new frame. Stamps
+        // land just before, so replays of the frame start with them in place.
+        // Lockstep clients only exchange single tiles, so they are never cut
+        // or pasted into.
+        if (!is_sandbox_mid_frame(sandbox))
+        {
+            apply_clipboard(app, sandbox, SANDBOX_HEIGHT, SANDBOX_WIDTH, session == NULL);
+            flight_recorder_begin_frame(sandbox, &view);
+        }
+
         // Render full black to the window.
         set_black_background(app);
 
         get_input(app);
 
-        if (app -> mouse -> is_left_clicking)
+        // Follow the placed tile on its way to the screen.
+        bool is_placed = app -> mouse -> is_left_clicking
+            && (session != NULL
+                ? queue_tile(app -> mouse, session, sandbox)
+                : place_tile(app -> mouse, sandbox, SANDBOX_HEIGHT, SANDBOX_WIDTH));
+
+        if (is_placed)
+        {
+            latency_record_edit(SDL_GetTicks());
+        }
+        else
+        {
+            latency_forget_input();
+        }
+
+        phase_ms[PHASE_INPUT] = _lap_ms(&lap_start);
+
+        // Do as much of 1 frame of sandbox processing as the budget allows,
+        // and draw the last complete frame to the renderer. Clients of a
+        // lockstep session must all process whole frames the same way.
+        bool is_frame_complete;
+
+        if (session != NULL)
+        {
+            is_frame_complete = advance_lockstep_session(session);
+
+            if (!is_frame_complete)
+            {
+                struct LockstepStats stats = get_lockstep_stats(session);
+
+                if (stats.is_desynced)
+                {
+                    fprintf(stderr, "Lockstep clients desynced at frame %u, going on alone\n", stats.desync_frame);
+                }
+                else
+                {
+                    fprintf(stderr, "Lockstep session failed at frame %u, going on alone\n", stats.frames);
+                }
+
+                free_lockstep_session(session);
+                session = NULL;
+            }
+        }
+        else
+        {
+            is_frame_complete = process_sandbox_budgeted(sandbox,
+                    SANDBOX_HEIGHT,
+                    SANDBOX_WIDTH,
+                    &view,
+                    SIMULATION_BUDGET_MS);
+        }
+
+        if (is_frame_complete)
         {
-            place_tile(app -> mouse, sandbox, SANDBOX_HEIGHT, SANDBOX_WIDTH);
+            copy_sandbox(last_frame, sandbox, SANDBOX_HEIGHT, SANDBOX_WIDTH);
+            latency_record_frame(SDL_GetTicks());
+
+            // Stop recording if the disk fills up, leaving the frames
+            // written so far readable.
+            if (app -> recorder != NULL && !record_frame(app -> recorder))
+            {
+                fprintf(stderr, "Could not record frame, recording stopped\n");
+                finish_recording(app -> recorder);
+                app -> recorder = NULL;
+            }
         }
 
-        // Do 1 frame of sandbox processing and draw the result to the renderer.
-        process_sandbox(sandbox, SANDBOX_HEIGHT, SANDBOX_WIDTH);
-        draw_sandbox(app, sandbox, SANDBOX_HEIGHT, SANDBOX_WIDTH);
+        phase_ms[PHASE_SIMULATION] = _lap_ms(&lap_start);
+
+        draw_sandbox(app, last_frame, SANDBOX_HEIGHT, SANDBOX_WIDTH);
 
         // Draw UI elements above the sandbox so that they aren't covered.
         draw_ui(app);
 
+        phase_ms[PHASE_DRAW] = _lap_ms(&lap_start);
+
         // Display all rendered graphics.
         SDL_RenderPresent(app -> renderer);
+        latency_record_present(SDL_GetTicks());
+
+        if (is_first_frame)
+        {
+            printf("First frame displayed %.1f ms after startup\n", _lap_ms(&startup_start));
+            is_first_frame = false;
+        }
+
+        phase_ms[PHASE_PRESENT] = _lap_ms(&lap_start);
+        flight_recorder_record_phases(phase_ms);
+
+        metrics_record_frame(phase_ms[PHASE_INPUT] + phase_ms[PHASE_SIMULATION] + phase_ms[PHASE_DRAW] + phase_ms[PHASE_PRESENT],
+                phase_ms[PHASE_SIMULATION],
+                phase_ms[PHASE_DRAW] + phase_ms[PHASE_PRESENT]);
+        metrics_record_sandbox(sandbox, SANDBOX_HEIGHT, SANDBOX_WIDTH, is_frame_complete, SDL_GetTicks());
+        metrics_record_pending_edits(get_latency_pending_edits());
+        publish_metrics();
+
+        if (is_frame_complete)
+        {
+            flight_recorder_end_frame();
+        }
+
+        // Keep the memory shown in the title current, without measuring it
+        // every frame.
+        if (SDL_GetTicks() - memory_shown_ms >= MEMORY_TITLE_INTERVAL_MS)
+        {
+            _show_memory_usage(app, title);
+            memory_shown_ms = SDL_GetTicks();
+        }
 
         // Run at ~30 FPS. (wait 33 milliseconds before proceeding to next frame)
         SDL_Delay(33);
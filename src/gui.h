@@ -10,10 +10,56 @@
 #include <SDL.h>
 #include <SDL_image.h>
 #include "sandbox.h"
+#include "latency.h"
+#include "flight_recorder.h"
+#include "metrics.h"
+#include "lockstep.h"
+#include "worldgen.h"
+#include "assets.h"
+#include "stamp.h"
+#include "recording.h"
 
 // Upscaling for individual pixels when drawing to screen.
 #define PIXEL_SCALE 8
 
+// Milliseconds of simulation allowed per displayed frame. Frames taking longer
+// are spread over several displayed frames, keeping input responsive.
+#define SIMULATION_BUDGET_MS 20
+
+// Milliseconds between updates of the memory shown in the window title.
+#define MEMORY_TITLE_INTERVAL_MS 1000
+
+// Environment variable holding the localhost port to serve metrics on, if
+// metrics should be served at all.
+#define METRICS_PORT_VARIABLE "SAND_METRICS_PORT"
+
+// Environment variable holding the number of local clients to share the
+// sandbox with in a lockstep session, if any.
+#define LOCKSTEP_CLIENTS_VARIABLE "SAND_LOCKSTEP_CLIENTS"
+
+// Environment variable holding the seed of a world to generate in place of
+// an empty sandbox, if any.
+#define WORLD_SEED_VARIABLE "SAND_WORLD_SEED"
+
+// Environment variable holding the path of a file to record every frame to,
+// if frames should be recorded at all.
+#define RECORDING_VARIABLE "SAND_RECORDING"
+
+// Environment variable holding the path of a recording to play back in place
+// of a simulated sandbox, if any.
+#define PLAYBACK_VARIABLE "SAND_PLAYBACK"
+
+// Frames skipped at once when jumping through a recording, being 10 seconds
+// of frames at 30 FPS.
+#define PLAYBACK_JUMP_FRAMES 300
+
+// Height in pixels of the timeline drawn along the bottom of the window while
+// playing back a recording.
+#define TIMELINE_HEIGHT 4
+
+// Name of the stamp last copied or cut, within the stamp library.
+#define CLIPBOARD_STAMP_NAME "clipboard"
+
 // Width and height of sandbox simulation in tiles.
 extern unsigned int SANDBOX_WIDTH;
 extern unsigned int SANDBOX_HEIGHT;
@@ -41,13 +87,55 @@ struct Mouse
 };
 
 
+// Edits of the clipboard asked for by the user, made between frames.
+enum clipboard_action {CLIPBOARD_NONE, CLIPBOARD_COPY, CLIPBOARD_CUT, CLIPBOARD_PASTE};
+
+
+// Struct for holding the rectangle selected by dragging the right mouse
+// button, the library of stamps, and which of them to paste.
+struct Clipboard
+{
+    // Tiles the selection was dragged from and to.
+    unsigned int anchor_row;
+    unsigned int anchor_column;
+    unsigned int end_row;
+    unsigned int end_column;
+
+    bool is_selecting;
+    bool has_selection;
+
+    struct StampLibrary *library;
+    unsigned int stamp_index;
+
+    enum clipboard_action action;
+};
+
+
+// Struct for holding a recording played back in place of a simulation, and
+// which of its frames to show.
+struct Player
+{
+    struct Recording *recording;
+    unsigned int frame;
+    bool is_playing;
+
+    // Whether the left button is held down, scrubbing through the recording
+    // as the mouse moves across the window.
+    bool is_scrubbing;
+};
+
+
 // Struct for holding references to the GUI application's most integral pieces:
-// The window, renderer, and mouse.
+// The window, renderer, mouse and clipboard, along with the writer recording
+// the sandbox and the player of a recording, when either is in use.
 struct Application
 {
     SDL_Renderer *renderer;
     SDL_Window *window;
     struct Mouse *mouse;
+    struct Clipboard *clipboard;
+    struct RecordingWriter *recorder;
+    struct Player *player;
 };
 
 
@@ -88,6 +176,9 @@ void cleanup(struct Application *app);
  * Given the filename for a location to a JPG or PNG, load the image as an
  * SDL_Texture on the given application.
  *
+ * Images compiled into the binary as assets are decoded from memory, and
+ * any others are read from disk.
+ *
  * @param app - App to load image on.
  * @param filename - Filepath of image to load from src folder as root.
  *
@@ -170,6 +261,8 @@ void draw_ui(struct Application *app);
  * Poll SDL for any user-input (mouse input, keyboard input) and react
  * accordingly within the sandbox application.
  *
+ * Mouse input that may place tiles is passed on to latency_record_input().
+ *
  * @param app - Application to react on due to input.
  */
 void get_input(struct Application *app);
@@ -195,11 +288,59 @@ void switch_selected_tile(struct Mouse *mouse, unsigned char tile_type);
  * @param sandbox - Sandbox to mutate and place tile in.
  * @param height, width - Dimensions of the given sandbox in tiles.
  *
+ * @return - True if a tile was placed, false if the location was taken.
  */
-void place_tile(struct Mouse *mouse,
+bool place_tile(struct Mouse *mouse,
         unsigned char **sandbox,
         unsigned int height,
         unsigned int width);
 
 
+/*
+ * Make the edit of the clipboard last asked for, if any: copying or cutting
+ * the selection into the stamp named CLIPBOARD_STAMP_NAME, or pasting the
+ * chosen stamp centered on the mouse's location.
+ *
+ * @param app - App holding the clipboard and mouse.
+ * @param sandbox - Sandbox to copy from, or cut or paste into.
+ * @param height, width - Dimensions of the given sandbox in tiles.
+ * @param can_edit - Whether the sandbox may be changed, rather than only
+ * copied from. Edits asked for otherwise are dropped.
+ *
+ * @return - True if the sandbox was changed, false otherwise.
+ */
+bool apply_clipboard(struct Application *app,
+        unsigned char **sandbox,
+        unsigned int height,
+        unsigned int width,
+        bool can_edit);
+
+
+/*
+ * Play back the recording held by the app's player in place of a simulated
+ * sandbox, until the window is closed. Space plays and pauses, the left and
+ * right arrows step one frame, the up and down arrows jump
+ * PLAYBACK_JUMP_FRAMES frames, Home and End go to the first and last frame,
+ * and dragging with the left mouse button scrubs along the timeline.
+ *
+ * @param app - App holding the player.
+ * @param title - Title of the window without the frame shown.
+ */
+void play_recording(struct Application *app, const char *title);
+
+
+/*
+ * Queue a tile of the mouse's currently selected type to be placed at the
+ * mouse's location by every client of a lockstep session, as its first
+ * client, like place_tile() does right away.
+ *
+ * @param mouse - Pointer to mouse to get placement location and tile type.
+ * @param session - Lockstep session to queue tile in.
+ * @param sandbox - Sandbox of the session's first client.
+ *
+ * @return - True if a tile was queued, false if the location was taken.
+ */
+bool queue_tile(struct Mouse *mouse, struct LockstepSession *session, unsigned char **sandbox);
+
+
 #endif
@@ -0,0 +1,221 @@
+/*
+ * Implementation of latency.h interface.
+ *
+ */
+
+#include "latency.h"
+
+
+// An edit on its way to the screen, with the time it reached each stage.
+struct LatencySample
+{
+    enum latency_stage stage;
+    unsigned int times[NUM_LATENCY_STAGES];
+};
+
+
+// Edits being followed, oldest first. Edits only ever advance together, so
+// older edits are always at least as far along as newer ones.
+static struct LatencySample PENDING[LATENCY_MAX_PENDING];
+static unsigned int NUM_PENDING = 0;
+
+// Earliest input polled since the last edit, if any.
+static bool HAS_INPUT = false;
+static unsigned int INPUT_EVENT_MS;
+static unsigned int INPUT_POLL_MS;
+
+// Histogram for every pair of stages, indexed by the earlier stage first.
+static struct LatencyHistogram HISTOGRAMS[NUM_LATENCY_STAGES][NUM_LATENCY_STAGES];
+
+// Edits given up on for lack of room to follow them.
+static unsigned long DROPPED_EDITS = 0;
+
+static const char *STAGE_NAMES[NUM_LATENCY_STAGES] = {"event", "polled", "applied", "simulated", "presented"};
+
+
+// ----- PRIVATE FUNCTIONS -----
+
+
+/*
+ * Add a single latency to a histogram.
+ *
+ * @param histogram - Histogram to add to.
+ * @param latency_ms - Latency to add.
+ */
+static void _add_to_histogram(struct LatencyHistogram *histogram, unsigned int latency_ms)
+{
+    unsigned int bucket = 0;
+
+    // Bucket i > 0 holds latencies from 2^(i - 1) up to 2^i ms.
+    while (bucket < LATENCY_NUM_BUCKETS - 1 && latency_ms >= (1u << bucket))
+    {
+        bucket++;
+    }
+
+    histogram -> counts[bucket]++;
+    histogram -> samples++;
+    histogram -> total_ms += latency_ms;
+
+    if (latency_ms > histogram -> max_ms)
+    {
+        histogram -> max_ms = latency_ms;
+    }
+}
+
+
+/*
+ * Advance every pending edit at the given stage to the next one.
+ *
+ * @param stage - Stage edits must be at to advance.
+ * @param now_ms - Time the next stage was reached.
+ */
+static void _advance_pending(enum latency_stage stage, unsigned int now_ms)
+{
+    for (unsigned int i = 0; i < NUM_PENDING; i++)
+    {
+        if (PENDING[i].stage == stage)
+        {
+            PENDING[i].stage = stage + 1;
+            PENDING[i].times[stage + 1] = now_ms;
+        }
+    }
+}
+
+
+// ----- PUBLIC FUNCTIONS -----
+
+
+void latency_record_input(unsigned int event_ms, unsigned int poll_ms)
+{
+    if (HAS_INPUT)
+    {
+        return;
+    }
+
+    HAS_INPUT = true;
+    INPUT_EVENT_MS = event_ms;
+    INPUT_POLL_MS = poll_ms;
+}
+
+
+void latency_record_edit(unsigned int now_ms)
+{
+    if (!HAS_INPUT)
+    {
+        return;
+    }
+
+    HAS_INPUT = false;
+
+    if (NUM_PENDING == LATENCY_MAX_PENDING)
+    {
+        DROPPED_EDITS++;
+        return;
+    }
+
+    struct LatencySample *sample = &PENDING[NUM_PENDING++];
+    sample -> stage = LATENCY_APPLIED;
+    sample -> times[LATENCY_EVENT] = INPUT_EVENT_MS;
+    sample -> times[LATENCY_POLLED] = INPUT_POLL_MS;
+    sample -> times[LATENCY_APPLIED] = now_ms;
+}
+
+
+void latency_forget_input(void)
+{
+    HAS_INPUT = false;
+}
+
+
+void latency_record_frame(unsigned int now_ms)
+{
+    _advance_pending(LATENCY_APPLIED, now_ms);
+}
+
+
+void latency_record_present(unsigned int now_ms)
+{
+    _advance_pending(LATENCY_SIMULATED, now_ms);
+
+    // Presented edits are all at the front, being the oldest.
+    unsigned int num_presented = 0;
+
+    while (num_presented < NUM_PENDING && PENDING[num_presented].stage == LATENCY_PRESENTED)
+    {
+        struct LatencySample *sample = &PENDING[num_presented++];
+
+        for (unsigned int from = 0; from < NUM_LATENCY_STAGES; from++)
+        {
+            for (unsigned int to = from + 1; to < NUM_LATENCY_STAGES; to++)
+            {
+                // Event timestamps may run slightly ahead of the clock used
+                // afterwards, which must not wrap around.
+                unsigned int latency_ms = 0;
+
+                if (sample -> times[to] > sample -> times[from])
+                {
+                    latency_ms = sample -> times[to] - sample -> times[from];
+                }
+
+                _add_to_histogram(&HISTOGRAMS[from][to], latency_ms);
+            }
+        }
+    }
+
+    NUM_PENDING -= num_presented;
+    memmove(PENDING, PENDING + num_presented, NUM_PENDING * sizeof(struct LatencySample));
+}
+
+
+unsigned int get_latency_pending_edits(void)
+{
+    return NUM_PENDING;
+}
+
+
+struct LatencyHistogram get_latency_histogram(enum latency_stage from, enum latency_stage to)
+{
+    struct LatencyHistogram empty = {0};
+
+    if (from >= to || to >= NUM_LATENCY_STAGES)
+    {
+        return empty;
+    }
+
+    return HISTOGRAMS[from][to];
+}
+
+
+void print_latency_report(FILE *stream)
+{
+    fprintf(stream, "Input latency over %lu edits (%lu not measured):\n",
+            HISTOGRAMS[LATENCY_EVENT][LATENCY_PRESENTED].samples, DROPPED_EDITS);
+
+    // Each stage on its own, followed by the whole way from input to screen.
+    for (unsigned int stage = 0; stage < NUM_LATENCY_STAGES; stage++)
+    {
+        unsigned int from = stage;
+        unsigned int to = stage + 1;
+
+        if (stage == NUM_LATENCY_STAGES - 1)
+        {
+            from = LATENCY_EVENT;
+            to = LATENCY_PRESENTED;
+        }
+
+        struct LatencyHistogram *histogram = &HISTOGRAMS[from][to];
+        double mean_ms = histogram -> samples ? (double) histogram -> total_ms / histogram -> samples : 0;
+
+        fprintf(stream, "  %9s -> %-9s mean %7.2f ms, max %5u ms |",
+                STAGE_NAMES[from], STAGE_NAMES[to], mean_ms, histogram -> max_ms);
+
+        for (unsigned int bucket = 0; bucket < LATENCY_NUM_BUCKETS; bucket++)
+        {
+            fprintf(stream, " %lu", histogram -> counts[bucket]);
+        }
+
+        fprintf(stream, "\n");
+    }
+
+    fprintf(stream, "  Buckets: <1 ms, then doubling up to >=%u ms.\n", 1u << (LATENCY_NUM_BUCKETS - 2));
+}
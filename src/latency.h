@@ -0,0 +1,131 @@
+#ifndef LATENCY_H
+#define LATENCY_H
+
+/*
+ * Instrumentation measuring how long user input takes to show up on screen.
+ *
+ * Every brush edit is followed through the stages of enum latency_stage, from
+ * the input event causing it to the first presented frame displaying it, and
+ * the time between each stage and the next is gathered into histograms.
+ *
+ * Times are given in milliseconds by the caller, from whichever clock the
+ * input events are timestamped with, so this module does not depend on SDL.
+ *
+ */
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+
+// Maximum number of edits followed at once. Edits beyond it are dropped from
+// the measurements, never from the sandbox.
+#define LATENCY_MAX_PENDING 256
+
+// Histogram buckets double in width, the first holding latencies under 1 ms
+// and the last everything from 2^(LATENCY_NUM_BUCKETS - 2) ms upwards.
+#define LATENCY_NUM_BUCKETS 12
+
+
+// Points an edit passes through on its way to the screen, in order.
+enum latency_stage
+{
+    // Timestamp of the input event, as given by the event itself.
+    LATENCY_EVENT,
+
+    // Event taken off the event queue by get_input().
+    LATENCY_POLLED,
+
+    // Edit written into the sandbox.
+    LATENCY_APPLIED,
+
+    // Frame holding the edit completed, and copied out for display.
+    LATENCY_SIMULATED,
+
+    // Frame holding the edit presented to the screen.
+    LATENCY_PRESENTED,
+
+    NUM_LATENCY_STAGES
+};
+
+
+// Distribution of latencies between two stages.
+struct LatencyHistogram
+{
+    unsigned long counts[LATENCY_NUM_BUCKETS];
+    unsigned long samples;
+    unsigned long total_ms;
+    unsigned int max_ms;
+};
+
+
+/*
+ * Record that an input event was polled. The earliest event polled since the
+ * last edit is taken as the cause of the next one.
+ *
+ * @param event_ms - Timestamp carried by the event.
+ * @param poll_ms - Time the event was polled.
+ */
+void latency_record_input(unsigned int event_ms, unsigned int poll_ms);
+
+
+/*
+ * Record that an edit was written into the sandbox, caused by the inputs
+ * recorded since the last edit. Does nothing if there were none.
+ *
+ * @param now_ms - Current time.
+ */
+void latency_record_edit(unsigned int now_ms);
+
+
+/*
+ * Forget the inputs recorded since the last edit, as they did not lead to one.
+ */
+void latency_forget_input(void);
+
+
+/*
+ * Record that a frame completed, so every edit applied before now is part of
+ * the next frame displayed.
+ *
+ * @param now_ms - Current time.
+ */
+void latency_record_frame(unsigned int now_ms);
+
+
+/*
+ * Record that the frame last completed was presented, finishing the
+ * measurement of every edit it holds.
+ *
+ * @param now_ms - Current time.
+ */
+void latency_record_present(unsigned int now_ms);
+
+
+/*
+ * Return the number of edits applied to the sandbox, but not yet presented.
+ *
+ * @return - Number of edits being followed.
+ */
+unsigned int get_latency_pending_edits(void);
+
+
+/*
+ * Obtain the distribution of latencies from one stage to another, over every
+ * edit measured so far.
+ *
+ * @param from, to - Stages to measure between, from coming before to.
+ *
+ * @return - Histogram of latencies. All zero if from does not precede to.
+ */
+struct LatencyHistogram get_latency_histogram(enum latency_stage from, enum latency_stage to);
+
+
+/*
+ * Print the latency histograms of every stage, and of edits as a whole.
+ *
+ * @param stream - Stream to print to.
+ */
+void print_latency_report(FILE *stream);
+
+
+#endif
@@ -0,0 +1,556 @@
+/*
+ * Implementation of lockstep.h interface.
+ *
+ */
+
+#include "lockstep.h"
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+typedef SOCKET lockstep_socket;
+#define INVALID_LOCKSTEP_SOCKET INVALID_SOCKET
+#define close_lockstep_socket closesocket
+#else
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+typedef int lockstep_socket;
+#define INVALID_LOCKSTEP_SOCKET -1
+#define close_lockstep_socket close
+#endif
+
+// Bytes taken by an edit on the wire: row, column and tile.
+#define EDIT_BYTES 9
+
+// Bytes taken by a client's message before its edits: frame, world hash and
+// number of edits.
+#define CLIENT_HEADER_BYTES 16
+
+// Bytes taken by the host's message before its edits: frame and number of
+// edits.
+#define HOST_HEADER_BYTES 8
+
+// Largest message sent, being the host's with every client's edits.
+#define MAX_MESSAGE_BYTES (HOST_HEADER_BYTES + LOCKSTEP_MAX_CLIENTS * LOCKSTEP_MAX_EDITS * EDIT_BYTES)
+
+
+struct LockstepClient
+{
+    lockstep_socket socket;
+    unsigned char **sandbox;
+
+    // Edits to send for the next frame.
+    struct LockstepEdit edits[LOCKSTEP_MAX_EDITS];
+    unsigned int num_edits;
+};
+
+
+struct LockstepSession
+{
+    unsigned int height;
+    unsigned int width;
+
+    struct LockstepClient clients[LOCKSTEP_MAX_CLIENTS];
+    unsigned int num_clients;
+
+    // Host's end of the connection to each client, in client order.
+    lockstep_socket host_sockets[LOCKSTEP_MAX_CLIENTS];
+
+    struct LockstepStats stats;
+
+    // Buffer messages are built in and read into.
+    unsigned char message[MAX_MESSAGE_BYTES];
+};
+
+
+// ----- PRIVATE FUNCTIONS -----
+
+
+/*
+ * Send a whole message over a connection.
+ *
+ * @param socket - Connection to send over.
+ * @param bytes - Message to send.
+ * @param length - Length of message in bytes.
+ *
+ * @return - True if all of it was sent, false otherwise.
+ */
+static bool _send_all(lockstep_socket socket, const unsigned char *bytes, unsigned int length)
+{
+    while (length > 0)
+    {
+        int sent = send(socket, (const char *) bytes, length, 0);
+
+        if (sent <= 0)
+        {
+            return false;
+        }
+
+        bytes += sent;
+        length -= sent;
+    }
+
+    return true;
+}
+
+
+/*
+ * Receive exactly the given number of bytes from a connection.
+ *
+ * @param socket - Connection to receive from.
+ * @param bytes - Buffer to receive into.
+ * @param length - Number of bytes to receive.
+ *
+ * @return - True if all of them were received, false otherwise.
+ */
+static bool _receive_all(lockstep_socket socket, unsigned char *bytes, unsigned int length)
+{
+    while (length > 0)
+    {
+        int received = recv(socket, (char *) bytes, length, 0);
+
+        if (received <= 0)
+        {
+            return false;
+        }
+
+        bytes += received;
+        length -= received;
+    }
+
+    return true;
+}
+
+
+/*
+ * Open a connection to the given port of localhost, sending edits as soon as
+ * they are written rather than batching them up.
+ *
+ * @param port - Port to connect to, in network byte order.
+ *
+ * @return - Connection, or INVALID_LOCKSTEP_SOCKET if it failed.
+ */
+static lockstep_socket _connect_local(unsigned short port)
+{
+    lockstep_socket connection = socket(AF_INET, SOCK_STREAM, 0);
+
+    if (connection == INVALID_LOCKSTEP_SOCKET)
+    {
+        return INVALID_LOCKSTEP_SOCKET;
+    }
+
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = port;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    if (connect(connection, (struct sockaddr *) &address, sizeof(address)) != 0)
+    {
+        close_lockstep_socket(connection);
+        return INVALID_LOCKSTEP_SOCKET;
+    }
+
+    int should_not_delay = 1;
+    setsockopt(connection, IPPROTO_TCP, TCP_NODELAY, (const char *) &should_not_delay, sizeof(should_not_delay));
+
+    return connection;
+}
+
+
+/*
+ * Pack edits into a message, one after another.
+ *
+ * @param bytes - Location to pack edits at.
+ * @param edits - Edits to pack.
+ * @param num_edits - Number of edits.
+ */
+static void _pack_edits(unsigned char *bytes, const struct LockstepEdit *edits, unsigned int num_edits)
+{
+    for (unsigned int i = 0; i < num_edits; i++)
+    {
+        pack_save_u32(&bytes[i * EDIT_BYTES], edits[i].row);
+        pack_save_u32(&bytes[i * EDIT_BYTES + 4], edits[i].column);
+        bytes[i * EDIT_BYTES + 8] = edits[i].tile;
+    }
+}
+
+
+/*
+ * Make the edits packed into a message to a sandbox, placing each tile only
+ * over air, as the GUI does.
+ *
+ * @param sandbox - Sandbox to edit.
+ * @param height, width - Dimensions of sandbox.
+ * @param bytes - Packed edits.
+ * @param num_edits - Number of edits.
+ */
+static void _apply_edits(unsigned char **sandbox,
+        unsigned int height,
+        unsigned int width,
+        const unsigned char *bytes,
+        unsigned int num_edits)
+{
+    for (unsigned int i = 0; i < num_edits; i++)
+    {
+        unsigned int row_index = unpack_save_u32(&bytes[i * EDIT_BYTES]);
+        unsigned int column_index = unpack_save_u32(&bytes[i * EDIT_BYTES + 4]);
+        unsigned char tile = bytes[i * EDIT_BYTES + 8];
+
+        if (row_index < height && column_index < width && get_tile_id(sandbox[row_index][column_index]) == AIR)
+        {
+            edit_tile(sandbox, row_index, column_index, tile);
+        }
+    }
+}
+
+
+/*
+ * Send a client's queued edits to the host, along with the world hash of its
+ * sandbox, and clear them.
+ *
+ * @param session - Session of client.
+ * @param client - Client to send edits of.
+ *
+ * @return - True if sent, false otherwise.
+ */
+static bool _send_client_edits(struct LockstepSession *session, struct LockstepClient *client)
+{
+    unsigned char *bytes = session -> message;
+    unsigned int length = CLIENT_HEADER_BYTES + client -> num_edits * EDIT_BYTES;
+
+    pack_save_u32(&bytes[0], session -> stats.frames);
+    pack_save_u64(&bytes[4], get_world_hash(client -> sandbox));
+    pack_save_u32(&bytes[12], client -> num_edits);
+    _pack_edits(&bytes[CLIENT_HEADER_BYTES], client -> edits, client -> num_edits);
+
+    client -> num_edits = 0;
+    session -> stats.frame_bytes += length;
+
+    return _send_all(client -> socket, bytes, length);
+}
+
+
+/*
+ * Gather every client's edits as the host, checking every client is at the
+ * same frame with the same world hash, and send all of the edits back to
+ * every client.
+ *
+ * @param session - Session to host.
+ *
+ * @return - True if every client was sent the edits, false otherwise.
+ */
+static bool _relay_edits(struct LockstepSession *session)
+{
+    unsigned char *bytes = session -> message;
+    unsigned int total_edits = 0;
+    unsigned long long first_hash = 0;
+
+    for (unsigned int i = 0; i < session -> num_clients; i++)
+    {
+        unsigned char header[CLIENT_HEADER_BYTES];
+
+        if (!_receive_all(session -> host_sockets[i], header, CLIENT_HEADER_BYTES))
+        {
+            return false;
+        }
+
+        unsigned int frame = unpack_save_u32(&header[0]);
+        unsigned long long hash = unpack_save_u64(&header[4]);
+        unsigned int num_edits = unpack_save_u32(&header[12]);
+
+        if (frame != session -> stats.frames || num_edits > LOCKSTEP_MAX_EDITS)
+        {
+            return false;
+        }
+
+        // Edits are appended in client order, which every client then makes
+        // them in.
+        if (!_receive_all(session -> host_sockets[i], &bytes[HOST_HEADER_BYTES + total_edits * EDIT_BYTES], num_edits * EDIT_BYTES))
+        {
+            return false;
+        }
+
+        total_edits += num_edits;
+
+        if (i == 0)
+        {
+            first_hash = hash;
+        }
+        else if (hash != first_hash && !session -> stats.is_desynced)
+        {
+            session -> stats.is_desynced = true;
+            session -> stats.desync_frame = frame;
+        }
+    }
+
+    if (session -> stats.is_desynced)
+    {
+        return false;
+    }
+
+    pack_save_u32(&bytes[0], session -> stats.frames);
+    pack_save_u32(&bytes[4], total_edits);
+
+    unsigned int length = HOST_HEADER_BYTES + total_edits * EDIT_BYTES;
+
+    for (unsigned int i = 0; i < session -> num_clients; i++)
+    {
+        if (!_send_all(session -> host_sockets[i], bytes, length))
+        {
+            return false;
+        }
+
+        session -> stats.frame_bytes += length;
+    }
+
+    return true;
+}
+
+
+/*
+ * Receive the edits of every client from the host as a client, make them,
+ * and simulate the frame.
+ *
+ * @param session - Session of client.
+ * @param client - Client to simulate.
+ *
+ * @return - True if the frame was simulated, false otherwise.
+ */
+static bool _simulate_client(struct LockstepSession *session, struct LockstepClient *client)
+{
+    unsigned char *bytes = session -> message;
+
+    if (!_receive_all(client -> socket, bytes, HOST_HEADER_BYTES))
+    {
+        return false;
+    }
+
+    unsigned int frame = unpack_save_u32(&bytes[0]);
+    unsigned int num_edits = unpack_save_u32(&bytes[4]);
+
+    if (frame != session -> stats.frames
+            || num_edits > session -> num_clients * LOCKSTEP_MAX_EDITS
+            || !_receive_all(client -> socket, &bytes[HOST_HEADER_BYTES], num_edits * EDIT_BYTES))
+    {
+        return false;
+    }
+
+    _apply_edits(client -> sandbox, session -> height, session -> width, &bytes[HOST_HEADER_BYTES], num_edits);
+    process_sandbox(client -> sandbox, session -> height, session -> width);
+
+    return true;
+}
+
+
+// ----- PUBLIC FUNCTIONS -----
+
+
+struct LockstepSession *create_lockstep_session(unsigned char **sandbox,
+        unsigned int height,
+        unsigned int width,
+        unsigned int num_clients)
+{
+    if (num_clients == 0 || num_clients > LOCKSTEP_MAX_CLIENTS)
+    {
+        return NULL;
+    }
+
+#ifdef _WIN32
+    WSADATA wsa_data;
+
+    if (WSAStartup(MAKEWORD(2, 2), &wsa_data) != 0)
+    {
+        return NULL;
+    }
+#endif
+
+    // The host listens on a port of localhost picked by the system.
+    lockstep_socket listener = socket(AF_INET, SOCK_STREAM, 0);
+
+    if (listener == INVALID_LOCKSTEP_SOCKET)
+    {
+        return NULL;
+    }
+
+    struct sockaddr_in address;
+    socklen_t address_length = sizeof(address);
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = 0;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    if (bind(listener, (struct sockaddr *) &address, sizeof(address)) != 0
+            || listen(listener, LOCKSTEP_MAX_CLIENTS) != 0
+            || getsockname(listener, (struct sockaddr *) &address, &address_length) != 0)
+    {
+        close_lockstep_socket(listener);
+        return NULL;
+    }
+
+    struct LockstepSession *session = (struct LockstepSession *) allocate_memory(MEMORY_EDITS, sizeof(struct LockstepSession));
+
+    if (session == NULL)
+    {
+        close_lockstep_socket(listener);
+        return NULL;
+    }
+
+    session -> height = height;
+    session -> width = width;
+
+    bool is_connected = true;
+
+    // Each client connects in turn, and is accepted straight away so the
+    // host's connections line up with the clients.
+    for (unsigned int i = 0; i < num_clients; i++)
+    {
+        struct LockstepClient *client = &session -> clients[i];
+        client -> socket = _connect_local(address.sin_port);
+        session -> host_sockets[i] = client -> socket != INVALID_LOCKSTEP_SOCKET
+            ? accept(listener, NULL, NULL)
+            : INVALID_LOCKSTEP_SOCKET;
+
+        if (session -> host_sockets[i] == INVALID_LOCKSTEP_SOCKET)
+        {
+            if (client -> socket != INVALID_LOCKSTEP_SOCKET)
+            {
+                close_lockstep_socket(client -> socket);
+            }
+
+            is_connected = false;
+            break;
+        }
+
+        int should_not_delay = 1;
+        setsockopt(session -> host_sockets[i], IPPROTO_TCP, TCP_NODELAY, (const char *) &should_not_delay, sizeof(should_not_delay));
+
+        // Every client starts out from the same sandbox.
+        if (i == 0)
+        {
+            client -> sandbox = sandbox;
+        }
+        else
+        {
+            client -> sandbox = create_sandbox(height, width);
+
+            if (client -> sandbox == NULL)
+            {
+                close_lockstep_socket(client -> socket);
+                close_lockstep_socket(session -> host_sockets[i]);
+                is_connected = false;
+                break;
+            }
+
+            copy_sandbox(client -> sandbox, sandbox, height, width);
+        }
+
+        session -> num_clients++;
+    }
+
+    close_lockstep_socket(listener);
+
+    if (!is_connected)
+    {
+        free_lockstep_session(session);
+        return NULL;
+    }
+
+    return session;
+}
+
+
+void free_lockstep_session(struct LockstepSession *session)
+{
+    for (unsigned int i = 0; i < session -> num_clients; i++)
+    {
+        close_lockstep_socket(session -> clients[i].socket);
+        close_lockstep_socket(session -> host_sockets[i]);
+
+        if (i > 0)
+        {
+            sandbox_free(session -> clients[i].sandbox, session -> height, session -> width);
+        }
+    }
+
+    release_memory(MEMORY_EDITS, session, sizeof(struct LockstepSession));
+}
+
+
+bool lockstep_queue_edit(struct LockstepSession *session,
+        unsigned int client_index,
+        unsigned int row_index,
+        unsigned int column_index,
+        unsigned char tile)
+{
+    if (client_index >= session -> num_clients || row_index >= session -> height || column_index >= session -> width)
+    {
+        return false;
+    }
+
+    struct LockstepClient *client = &session -> clients[client_index];
+
+    if (client -> num_edits == LOCKSTEP_MAX_EDITS)
+    {
+        return false;
+    }
+
+    struct LockstepEdit edit = {row_index, column_index, tile};
+    client -> edits[client -> num_edits++] = edit;
+
+    return true;
+}
+
+
+bool advance_lockstep_session(struct LockstepSession *session)
+{
+    if (session -> stats.is_desynced)
+    {
+        return false;
+    }
+
+    session -> stats.frame_bytes = 0;
+
+    // Messages are small enough to sit in the sockets' buffers, so every
+    // client can send before the host reads anything.
+    for (unsigned int i = 0; i < session -> num_clients; i++)
+    {
+        if (!_send_client_edits(session, &session -> clients[i]))
+        {
+            return false;
+        }
+    }
+
+    if (!_relay_edits(session))
+    {
+        return false;
+    }
+
+    // Clients all simulate the same frame, so each starts from the same
+    // clock.
+    unsigned int lifetime = SANDBOX_LIFETIME;
+
+    for (unsigned int i = 0; i < session -> num_clients; i++)
+    {
+        SANDBOX_LIFETIME = lifetime;
+
+        if (!_simulate_client(session, &session -> clients[i]))
+        {
+            return false;
+        }
+    }
+
+    session -> stats.frames++;
+    session -> stats.total_bytes += session -> stats.frame_bytes;
+
+    return true;
+}
+
+
+struct LockstepStats get_lockstep_stats(const struct LockstepSession *session)
+{
+    return session -> stats;
+}
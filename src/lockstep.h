@@ -0,0 +1,127 @@
+#ifndef LOCKSTEP_H
+#define LOCKSTEP_H
+
+/*
+ * Lockstep sessions, in which several clients each simulate their own copy
+ * of one deterministic sandbox, exchanging only the edits made to it.
+ *
+ * Every frame, each client sends the edits it queued, along with the world
+ * hash of its copy, to a host over a loopback socket. The host checks the
+ * hashes agree, and sends every client the edits of all clients, in client
+ * order. Each client then applies them to its copy and simulates a frame,
+ * so every copy stays identical without the sandbox itself ever being sent.
+ * The data exchanged per frame only depends on the number of edits, however
+ * large the sandbox.
+ *
+ * Clients and host all live in the calling process, with the sockets
+ * between them standing in for a network.
+ *
+ */
+
+#include "sandbox.h"
+#include "save.h"
+
+// Maximum number of clients per session.
+#define LOCKSTEP_MAX_CLIENTS 8
+
+// Maximum number of edits a client can queue per frame.
+#define LOCKSTEP_MAX_EDITS 256
+
+
+// Edit exchanged between clients, placing a tile over air.
+struct LockstepEdit
+{
+    unsigned int row;
+    unsigned int column;
+    unsigned char tile;
+};
+
+
+// Counters describing the progress of a lockstep session.
+struct LockstepStats
+{
+    // Frames simulated by the session.
+    unsigned int frames;
+
+    // Bytes sent over every connection during the last frame, and in total.
+    unsigned long frame_bytes;
+    unsigned long total_bytes;
+
+    // Whether the clients' sandboxes were found to differ, and at the start
+    // of which frame.
+    bool is_desynced;
+    unsigned int desync_frame;
+};
+
+
+// A lockstep session, holding its clients and the host's connections to them.
+struct LockstepSession;
+
+
+/*
+ * Start a lockstep session over loopback sockets.
+ *
+ * @param sandbox - Sandbox of the first client. Every other client starts
+ * out with a copy of it.
+ * @param height, width - Dimensions of sandbox.
+ * @param num_clients - Number of clients, up to LOCKSTEP_MAX_CLIENTS.
+ *
+ * @return - Newly created session, or NULL if it could not be started.
+ */
+struct LockstepSession *create_lockstep_session(unsigned char **sandbox,
+        unsigned int height,
+        unsigned int width,
+        unsigned int num_clients);
+
+
+/*
+ * Close the connections of a lockstep session and free it, along with the
+ * sandboxes of every client but the first.
+ *
+ * @param session - Session to free.
+ */
+void free_lockstep_session(struct LockstepSession *session);
+
+
+/*
+ * Queue an edit made by a client, to be made by every client at the start of
+ * the next frame.
+ *
+ * @param session - Session of client.
+ * @param client_index - Index of client making the edit.
+ * @param row_index, column_index - Coordinates of tile to place.
+ * @param tile - Tile to place, if the tile there is air by then.
+ *
+ * @return - True if queued, false if out of bounds or the client already
+ * queued LOCKSTEP_MAX_EDITS edits.
+ */
+bool lockstep_queue_edit(struct LockstepSession *session,
+        unsigned int client_index,
+        unsigned int row_index,
+        unsigned int column_index,
+        unsigned char tile);
+
+
+/*
+ * Exchange every client's queued edits through the host, then simulate a
+ * frame of every client's sandbox with them applied.
+ *
+ * @param session - Session to advance.
+ *
+ * @return - True if every client simulated the frame, false if a connection
+ * failed or the clients have desynced. Once false, the session cannot go on.
+ */
+bool advance_lockstep_session(struct LockstepSession *session);
+
+
+/*
+ * Return the counters of a lockstep session.
+ *
+ * @param session - Session to describe.
+ *
+ * @return - Counters of session.
+ */
+struct LockstepStats get_lockstep_stats(const struct LockstepSession *session);
+
+
+#endif
@@ -0,0 +1,586 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "memory.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// Number of pages checked for residency at a time.
+#define RESIDENCY_BATCH 4096
+
+// Bits of /proc/self/pagemap entries set for pages present in memory, and for
+// pages still shared with the file they were mapped from.
+#define PAGEMAP_PRESENT_BIT (1ULL << 63)
+#define PAGEMAP_SHARED_BIT (1ULL << 61)
+
+
+// A block tracked with its address, so its residency can be measured.
+struct TrackedBlock
+{
+    const void *block;
+    size_t bytes;
+    enum memory_subsystem subsystem;
+
+    // Whether the block is mapped from a file by map_file().
+    bool is_mapped;
+};
+
+
+// Allocator blocks are allocated from, with no functions for calloc() and
+// free().
+static struct Allocator ALLOCATOR = {NULL, NULL, NULL};
+
+static struct TrackedBlock BLOCKS[MEMORY_MAX_BLOCKS];
+static unsigned int NUM_BLOCKS = 0;
+
+// Memory held by each subsystem, with resident bytes as last measured.
+static struct MemoryUsage USAGE[NUM_MEMORY_SUBSYSTEMS];
+static struct MemoryUsage TOTAL_USAGE;
+
+// Bytes of each subsystem not tracked with an address, counted as resident.
+static unsigned long UNMEASURED_BYTES[NUM_MEMORY_SUBSYSTEMS];
+
+static const char *SUBSYSTEM_NAMES[NUM_MEMORY_SUBSYSTEMS] =
+{
+    "grid",
+    "chunks",
+    "chunk_cache",
+    "planes",
+    "snapshots",
+    "rewind",
+    "edits",
+    "capture",
+    "textures",
+    "stamps"
+};
+
+
+// ----- PRIVATE FUNCTIONS -----
+
+
+
+/*
+ * Add bytes to those allocated by a subsystem, raising its high-water marks
+ * and those of the total if passed.
+ *
+ * @param subsystem - Subsystem allocating.
+ * @param bytes - Bytes allocated.
+ */
+static void _add_allocated(enum memory_subsystem subsystem, size_t bytes)
+{
+    USAGE[subsystem].allocated += bytes;
+    TOTAL_USAGE.allocated += bytes;
+
+    if (USAGE[subsystem].allocated > USAGE[subsystem].peak_allocated)
+    {
+        USAGE[subsystem].peak_allocated = USAGE[subsystem].allocated;
+    }
+
+    if (TOTAL_USAGE.allocated > TOTAL_USAGE.peak_allocated)
+    {
+        TOTAL_USAGE.peak_allocated = TOTAL_USAGE.allocated;
+    }
+}
+
+
+/*
+ * Return the index of a tracked block.
+ *
+ * @param block - Address of block.
+ *
+ * @return - Index of block in BLOCKS, or -1 if it is not tracked.
+ */
+static int _find_block(const void *block)
+{
+    // Blocks freed soonest tend to be those allocated last.
+    for (int i = (int) NUM_BLOCKS - 1; i >= 0; i--)
+    {
+        if (BLOCKS[i].block == block)
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+
+#ifndef _WIN32
+/*
+ * Return the size of the pages memory is mapped in.
+ *
+ * @return - Bytes per page.
+ */
+static long _get_page_size(void)
+{
+    static long page_size = 0;
+
+    if (page_size == 0)
+    {
+        page_size = sysconf(_SC_PAGESIZE);
+    }
+
+    return page_size;
+}
+#endif
+
+
+/*
+ * Measure the bytes of a block backed by physical memory.
+ *
+ * @param block - Address of block.
+ * @param bytes - Size of block.
+ *
+ * @return - Bytes of block resident, or all of them where residency cannot
+ * be measured.
+ */
+static unsigned long _get_resident_bytes(const void *block, size_t bytes)
+{
+#ifdef _WIN32
+    return bytes;
+#else
+    long page_size = _get_page_size();
+    uintptr_t start = (uintptr_t) block;
+    uintptr_t end = start + bytes;
+    uintptr_t page = start & ~((uintptr_t) page_size - 1);
+    unsigned long resident = 0;
+
+    while (page < end)
+    {
+        unsigned char is_resident[RESIDENCY_BATCH];
+        size_t num_pages = (end - page + page_size - 1) / page_size;
+        num_pages = num_pages < RESIDENCY_BATCH ? num_pages : RESIDENCY_BATCH;
+
+        if (mincore((void *) page, num_pages * page_size, (void *) is_resident) != 0)
+        {
+            return bytes;
+        }
+
+        // Count only the part of each resident page within the block.
+        for (size_t i = 0; i < num_pages; i++, page += page_size)
+        {
+            if (is_resident[i] & 1)
+            {
+                uintptr_t overlap_start = page > start ? page : start;
+                uintptr_t overlap_end = page + page_size < end ? page + page_size : end;
+
+                resident += overlap_end - overlap_start;
+            }
+        }
+    }
+
+    return resident;
+#endif
+}
+
+
+/*
+ * Measure the bytes of a block mapped by map_file() which have been copied
+ * for it alone, as its pages shared with the file's other mappings are held
+ * by the page cache rather than by the block.
+ *
+ * @param block - Address of block.
+ * @param bytes - Size of block.
+ *
+ * @return - Bytes of block copied, or its resident bytes where copies cannot
+ * be told apart, as anywhere but on Linux.
+ */
+static unsigned long _get_copied_bytes(const void *block, size_t bytes)
+{
+#ifdef __linux__
+    static int pagemap = -1;
+
+    if (pagemap < 0)
+    {
+        pagemap = open("/proc/self/pagemap", O_RDONLY);
+    }
+
+    if (pagemap < 0)
+    {
+        return _get_resident_bytes(block, bytes);
+    }
+
+    long page_size = _get_page_size();
+    uintptr_t start = (uintptr_t) block;
+    uintptr_t end = start + bytes;
+    uintptr_t page = start & ~((uintptr_t) page_size - 1);
+    unsigned long copied = 0;
+
+    while (page < end)
+    {
+        unsigned long long entries[RESIDENCY_BATCH];
+        size_t num_pages = (end - page + page_size - 1) / page_size;
+        num_pages = num_pages < RESIDENCY_BATCH ? num_pages : RESIDENCY_BATCH;
+
+        off_t entry_offset = (off_t) (page / page_size) * sizeof(entries[0]);
+
+        if (pread(pagemap, entries, num_pages * sizeof(entries[0]), entry_offset) != (ssize_t) (num_pages * sizeof(entries[0])))
+        {
+            return _get_resident_bytes(block, bytes);
+        }
+
+        for (size_t i = 0; i < num_pages; i++, page += page_size)
+        {
+            if ((entries[i] & PAGEMAP_PRESENT_BIT) && !(entries[i] & PAGEMAP_SHARED_BIT))
+            {
+                uintptr_t overlap_start = page > start ? page : start;
+                uintptr_t overlap_end = page + page_size < end ? page + page_size : end;
+
+                copied += overlap_end - overlap_start;
+            }
+        }
+    }
+
+    return copied;
+#else
+    return _get_resident_bytes(block, bytes);
+#endif
+}
+
+
+/*
+ * Account a newly allocated or mapped block to a subsystem.
+ *
+ * @param subsystem - Subsystem holding the block.
+ * @param block - Address of the block, or NULL if it is not in this process'
+ * memory.
+ * @param bytes - Size of the block.
+ * @param is_mapped - Whether the block is mapped from a file by map_file().
+ */
+static void _track_block(enum memory_subsystem subsystem, const void *block, size_t bytes, bool is_mapped)
+{
+    _add_allocated(subsystem, bytes);
+
+    if (block != NULL && NUM_BLOCKS < MEMORY_MAX_BLOCKS)
+    {
+        BLOCKS[NUM_BLOCKS++] = (struct TrackedBlock) {block, bytes, subsystem, is_mapped};
+    }
+    else
+    {
+        UNMEASURED_BYTES[subsystem] += bytes;
+    }
+}
+
+
+/*
+ * Round a size up to a multiple of ARENA_ALIGNMENT.
+ *
+ * @param bytes - Size to round.
+ *
+ * @return - Rounded size.
+ */
+static size_t _align(size_t bytes)
+{
+    return (bytes + ARENA_ALIGNMENT - 1) & ~((size_t) ARENA_ALIGNMENT - 1);
+}
+
+
+/*
+ * Release every allocation an arena made after running out of room.
+ *
+ * @param arena - Arena to release the overflow of.
+ */
+static void _release_overflow(struct Arena *arena)
+{
+    while (arena -> overflow != NULL)
+    {
+        struct ArenaOverflow *next = arena -> overflow -> next;
+        release_memory(arena -> subsystem, arena -> overflow, arena -> overflow -> bytes);
+        arena -> overflow = next;
+    }
+
+    arena -> overflow_bytes = 0;
+}
+
+
+// ----- PUBLIC FUNCTIONS -----
+
+
+void set_allocator(const struct Allocator *allocator)
+{
+    if (allocator == NULL)
+    {
+        ALLOCATOR = (struct Allocator) {NULL, NULL, NULL};
+        return;
+    }
+
+    ALLOCATOR = *allocator;
+}
+
+
+void *allocate_memory(enum memory_subsystem subsystem, size_t bytes)
+{
+    void *block = ALLOCATOR.allocate != NULL
+        ? ALLOCATOR.allocate(bytes, ALLOCATOR.context)
+        : calloc(1, bytes);
+
+    if (block != NULL)
+    {
+        track_memory(subsystem, block, bytes);
+    }
+
+    return block;
+}
+
+
+void release_memory(enum memory_subsystem subsystem, void *block, size_t bytes)
+{
+    if (block == NULL)
+    {
+        return;
+    }
+
+    untrack_memory(subsystem, block, bytes);
+
+    if (ALLOCATOR.release != NULL)
+    {
+        ALLOCATOR.release(block, bytes, ALLOCATOR.context);
+    }
+    else
+    {
+        free(block);
+    }
+}
+
+
+void *arena_allocate(struct Arena *arena, size_t bytes)
+{
+    bytes = _align(bytes);
+
+    if (arena -> used + bytes <= arena -> size)
+    {
+        unsigned char *space = arena -> block + arena -> used;
+        arena -> used += bytes;
+
+        memset(space, 0, bytes);
+        return space;
+    }
+
+    // Out of room until the next reset grows the block, so allocate the
+    // space on its own for now.
+    size_t header_bytes = _align(sizeof(struct ArenaOverflow));
+    struct ArenaOverflow *overflow = (struct ArenaOverflow *) allocate_memory(arena -> subsystem, header_bytes + bytes);
+
+    if (overflow == NULL)
+    {
+        return NULL;
+    }
+
+    overflow -> next = arena -> overflow;
+    overflow -> bytes = header_bytes + bytes;
+    arena -> overflow = overflow;
+    arena -> overflow_bytes += bytes;
+
+    return (unsigned char *) overflow + header_bytes;
+}
+
+
+void reset_arena(struct Arena *arena)
+{
+    if (arena -> overflow != NULL)
+    {
+        size_t needed = arena -> used + arena -> overflow_bytes;
+        _release_overflow(arena);
+
+        // Grow the block to fit everything at once next time.
+        release_memory(arena -> subsystem, arena -> block, arena -> size);
+        arena -> block = (unsigned char *) allocate_memory(arena -> subsystem, needed);
+        arena -> size = arena -> block != NULL ? needed : 0;
+    }
+
+    arena -> used = 0;
+}
+
+
+void free_arena(struct Arena *arena)
+{
+    _release_overflow(arena);
+    release_memory(arena -> subsystem, arena -> block, arena -> size);
+
+    arena -> block = NULL;
+    arena -> size = 0;
+    arena -> used = 0;
+}
+
+
+void *map_file(enum memory_subsystem subsystem, const char *path, size_t offset, size_t bytes)
+{
+#ifdef _WIN32
+    // Without mmap(), the file is read into a block of its own instead.
+    unsigned char *block = (unsigned char *) allocate_memory(subsystem, bytes);
+    FILE *file = fopen(path, "rb");
+    bool is_read = block != NULL && file != NULL && fseek(file, offset, SEEK_SET) == 0;
+
+    if (is_read)
+    {
+        fread(block, 1, bytes, file);
+        is_read = !ferror(file);
+    }
+
+    if (file != NULL)
+    {
+        fclose(file);
+    }
+
+    if (!is_read)
+    {
+        release_memory(subsystem, block, bytes);
+        return NULL;
+    }
+
+    return block;
+#else
+    int file = open(path, O_RDONLY);
+
+    if (file < 0)
+    {
+        return NULL;
+    }
+
+    // Mappings start on a page, so start on the one holding the offset.
+    size_t misalignment = offset % _get_page_size();
+    void *mapping = mmap(NULL, bytes + misalignment, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, offset - misalignment);
+
+    // The mapping keeps the file open by itself.
+    close(file);
+
+    if (mapping == MAP_FAILED)
+    {
+        return NULL;
+    }
+
+    unsigned char *block = (unsigned char *) mapping + misalignment;
+    _track_block(subsystem, block, bytes, true);
+
+    return block;
+#endif
+}
+
+
+void unmap_file(enum memory_subsystem subsystem, void *block, size_t bytes)
+{
+#ifdef _WIN32
+    release_memory(subsystem, block, bytes);
+#else
+    untrack_memory(subsystem, block, bytes);
+
+    size_t misalignment = (uintptr_t) block % _get_page_size();
+    munmap((unsigned char *) block - misalignment, bytes + misalignment);
+#endif
+}
+
+
+void track_memory(enum memory_subsystem subsystem, const void *block, size_t bytes)
+{
+    _track_block(subsystem, block, bytes, false);
+}
+
+
+void untrack_memory(enum memory_subsystem subsystem, const void *block, size_t bytes)
+{
+    USAGE[subsystem].allocated -= bytes;
+    TOTAL_USAGE.allocated -= bytes;
+
+    int index = block != NULL ? _find_block(block) : -1;
+
+    if (index >= 0)
+    {
+        BLOCKS[index] = BLOCKS[--NUM_BLOCKS];
+    }
+    else
+    {
+        UNMEASURED_BYTES[subsystem] -= bytes;
+    }
+}
+
+
+void retrack_memory(enum memory_subsystem from, enum memory_subsystem to, const void *block, size_t bytes)
+{
+    // The total is unchanged, so only the subsystems' marks can rise.
+    USAGE[from].allocated -= bytes;
+    TOTAL_USAGE.allocated -= bytes;
+    _add_allocated(to, bytes);
+
+    int index = block != NULL ? _find_block(block) : -1;
+
+    if (index >= 0)
+    {
+        BLOCKS[index].subsystem = to;
+    }
+    else
+    {
+        UNMEASURED_BYTES[from] -= bytes;
+        UNMEASURED_BYTES[to] += bytes;
+    }
+}
+
+
+struct MemoryStats get_memory_stats(void)
+{
+    TOTAL_USAGE.resident = 0;
+
+    for (int i = 0; i < NUM_MEMORY_SUBSYSTEMS; i++)
+    {
+        USAGE[i].resident = UNMEASURED_BYTES[i];
+    }
+
+    for (unsigned int i = 0; i < NUM_BLOCKS; i++)
+    {
+        const struct TrackedBlock *tracked = &BLOCKS[i];
+
+        USAGE[tracked -> subsystem].resident += tracked -> is_mapped
+            ? _get_copied_bytes(tracked -> block, tracked -> bytes)
+            : _get_resident_bytes(tracked -> block, tracked -> bytes);
+    }
+
+    struct MemoryStats stats;
+
+    for (int i = 0; i < NUM_MEMORY_SUBSYSTEMS; i++)
+    {
+        if (USAGE[i].resident > USAGE[i].peak_resident)
+        {
+            USAGE[i].peak_resident = USAGE[i].resident;
+        }
+
+        TOTAL_USAGE.resident += USAGE[i].resident;
+        stats.subsystems[i] = USAGE[i];
+    }
+
+    if (TOTAL_USAGE.resident > TOTAL_USAGE.peak_resident)
+    {
+        TOTAL_USAGE.peak_resident = TOTAL_USAGE.resident;
+    }
+
+    stats.total = TOTAL_USAGE;
+
+    return stats;
+}
+
+
+const char *get_memory_subsystem_name(enum memory_subsystem subsystem)
+{
+    return SUBSYSTEM_NAMES[subsystem];
+}
+
+
+void print_memory_report(FILE *stream)
+{
+    struct MemoryStats stats = get_memory_stats();
+
+    fprintf(stream, "%-12s %12s %12s %12s %12s\n", "subsystem", "allocated", "resident", "peak alloc", "peak res");
+
+    for (int i = 0; i < NUM_MEMORY_SUBSYSTEMS; i++)
+    {
+        struct MemoryUsage *usage = &stats.subsystems[i];
+
+        fprintf(stream, "%-12s %12lu %12lu %12lu %12lu\n", SUBSYSTEM_NAMES[i],
+                usage -> allocated, usage -> resident, usage -> peak_allocated, usage -> peak_resident);
+    }
+
+    fprintf(stream, "%-12s %12lu %12lu %12lu %12lu\n", "total",
+            stats.total.allocated, stats.total.resident, stats.total.peak_allocated, stats.total.peak_resident);
+}
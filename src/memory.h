@@ -0,0 +1,290 @@
+#ifndef MEMORY_H
+#define MEMORY_H
+
+/*
+ * Allocation and accounting of the memory held by each subsystem of the
+ * program, so that containers can be sized from more than the resident size
+ * of the whole process.
+ *
+ * The simulation core takes all of its memory from allocate_memory(), which
+ * hands out blocks from a pluggable allocator, calloc() unless replaced, so
+ * programs embedding it can supply their own. Scratch space needed over and
+ * over, such as while settling, comes from arenas instead, which keep their
+ * memory between uses. Once a sandbox is created, stepping it allocates
+ * nothing.
+ *
+ * Subsystems track each block they allocate, and untrack it when freeing it.
+ * Bytes allocated are counted as blocks are tracked, while bytes resident,
+ * those of blocks actually backed by physical memory, are measured whenever
+ * the stats are read. Blocks calloc'd but never written, such as the tiles
+ * of a large empty sandbox, are then allocated without being resident.
+ * Blocks mapped from files are only resident for the pages copied for them
+ * alone, where that can be measured, as on Linux.
+ *
+ * Tracking is not thread-safe, and is done from the thread simulating.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// Maximum number of blocks tracked with an address. Blocks past this are
+// still counted as allocated, and as resident in full.
+#define MEMORY_MAX_BLOCKS 1024
+
+// Alignment of every allocation made from an arena.
+#define ARENA_ALIGNMENT 16
+
+
+// Subsystems memory is accounted to.
+enum memory_subsystem
+{
+    // Tiles, row pointers and bookkeeping of live sandboxes.
+    MEMORY_GRID,
+
+    // Chunk metadata of live sandboxes.
+    MEMORY_CHUNKS,
+
+    // Entries of the chunk cache.
+    MEMORY_CHUNK_CACHE,
+
+    // Planes kept alongside the tiles, such as change feeds, renderer state
+    // and scratch space for settling.
+    MEMORY_PLANES,
+
+    // Copies of sandboxes kept for display or recording.
+    MEMORY_SNAPSHOTS,
+
+    // Saved states sandboxes can be rewound to.
+    MEMORY_REWIND,
+
+    // Queues of edits waiting to be applied or measured.
+    MEMORY_EDITS,
+
+    // Buffers of frames captured by the flight recorder.
+    MEMORY_CAPTURE,
+
+    // Textures uploaded for drawing.
+    MEMORY_TEXTURES,
+
+    // Stamps copied from sandboxes or kept in libraries to paste.
+    MEMORY_STAMPS,
+
+    NUM_MEMORY_SUBSYSTEMS
+};
+
+
+// Memory held by a subsystem, or by all of them.
+struct MemoryUsage
+{
+    // Bytes held now.
+    unsigned long allocated;
+    unsigned long resident;
+
+    // Most bytes held at once. Resident bytes are only as high as they were
+    // when last measured.
+    unsigned long peak_allocated;
+    unsigned long peak_resident;
+};
+
+
+// Memory held by each subsystem, and in total.
+struct MemoryStats
+{
+    struct MemoryUsage subsystems[NUM_MEMORY_SUBSYSTEMS];
+    struct MemoryUsage total;
+};
+
+
+// Source of every block allocated by allocate_memory().
+struct Allocator
+{
+    // Return a block of the given size with every byte 0, or NULL if none is
+    // left.
+    void *(*allocate)(size_t bytes, void *context);
+
+    // Take back a block returned by allocate, of the size it was asked for.
+    void (*release)(void *block, size_t bytes, void *context);
+
+    // Passed to both functions.
+    void *context;
+};
+
+
+// Allocation made from an arena after it ran out of room, freed on reset.
+struct ArenaOverflow
+{
+    struct ArenaOverflow *next;
+    size_t bytes;
+};
+
+
+// Bump allocator handing out scratch space, all given back at once by
+// reset_arena(). Its block grows to the most ever used between resets, so
+// repeated uses of the same size allocate nothing.
+struct Arena
+{
+    enum memory_subsystem subsystem;
+
+    unsigned char *block;
+    size_t size;
+    size_t used;
+
+    // Allocations which did not fit in the block, and their total size.
+    struct ArenaOverflow *overflow;
+    size_t overflow_bytes;
+};
+
+
+/*
+ * Replace the allocator of allocate_memory(). Blocks must be released to the
+ * allocator they were allocated from, so this is done before any are.
+ *
+ * @param allocator - Allocator to use from now on, copied, or NULL for
+ * calloc() and free().
+ */
+void set_allocator(const struct Allocator *allocator);
+
+
+/*
+ * Allocate a block from the current allocator, accounting it to a subsystem.
+ *
+ * @param subsystem - Subsystem holding the block.
+ * @param bytes - Size of the block.
+ *
+ * @return - Block with every byte 0, or NULL if it could not be allocated.
+ */
+void *allocate_memory(enum memory_subsystem subsystem, size_t bytes);
+
+
+/*
+ * Release a block allocated by allocate_memory().
+ *
+ * @param subsystem - Subsystem the block is accounted to.
+ * @param block - Block to release, or NULL to do nothing.
+ * @param bytes - Size the block was allocated with.
+ */
+void release_memory(enum memory_subsystem subsystem, void *block, size_t bytes);
+
+
+/*
+ * Allocate scratch space from an arena, valid until it is next reset.
+ *
+ * Arenas may be zero-initialized, apart from their subsystem, instead of
+ * being set up.
+ *
+ * @param arena - Arena to allocate from.
+ * @param bytes - Size of the space.
+ *
+ * @return - Space with every byte 0, or NULL if it could not be allocated.
+ */
+void *arena_allocate(struct Arena *arena, size_t bytes);
+
+
+/*
+ * Give back all scratch space allocated from an arena, growing its block to
+ * fit everything allocated since it was last reset.
+ *
+ * @param arena - Arena to reset.
+ */
+void reset_arena(struct Arena *arena);
+
+
+/*
+ * Release the memory of an arena, leaving it empty but usable.
+ *
+ * @param arena - Arena to free.
+ */
+void free_arena(struct Arena *arena);
+
+
+/*
+ * Map part of a file into memory copy-on-write, accounting it to a subsystem
+ * but not taking it from the allocator. Its pages are shared with every other
+ * mapping of the file until written to, when the mapping writing them gets
+ * its own copies, so many mappings of one file cost little more than one.
+ *
+ * Where files cannot be mapped, such as on Windows, the part is read into a
+ * block allocated by allocate_memory() instead.
+ *
+ * @param subsystem - Subsystem holding the mapping.
+ * @param path - Path of file to map.
+ * @param offset - Offset in bytes of the part to map.
+ * @param bytes - Size of the part. Any of it past the end of the file must
+ * not be read or written.
+ *
+ * @return - Mapped block, or NULL if the file could not be mapped.
+ */
+void *map_file(enum memory_subsystem subsystem, const char *path, size_t offset, size_t bytes);
+
+
+/*
+ * Unmap a block mapped by map_file(), dropping any copies made of its pages.
+ *
+ * @param subsystem - Subsystem the mapping is accounted to.
+ * @param block - Block to unmap.
+ * @param bytes - Size the block was mapped with.
+ */
+void unmap_file(enum memory_subsystem subsystem, void *block, size_t bytes);
+
+
+/*
+ * Account a newly allocated block to a subsystem.
+ *
+ * @param subsystem - Subsystem holding the block.
+ * @param block - Address of the block, or NULL if it is not in this process'
+ * memory, such as a texture held by the graphics driver.
+ * @param bytes - Size of the block.
+ */
+void track_memory(enum memory_subsystem subsystem, const void *block, size_t bytes);
+
+
+/*
+ * Stop accounting a block about to be freed.
+ *
+ * @param subsystem - Subsystem holding the block.
+ * @param block - Address the block was tracked with.
+ * @param bytes - Size the block was tracked with.
+ */
+void untrack_memory(enum memory_subsystem subsystem, const void *block, size_t bytes);
+
+
+/*
+ * Account a tracked block to another subsystem, such as a sandbox kept as a
+ * snapshot.
+ *
+ * @param from - Subsystem holding the block until now.
+ * @param to - Subsystem holding the block from now on.
+ * @param block - Address the block was tracked with.
+ * @param bytes - Size the block was tracked with.
+ */
+void retrack_memory(enum memory_subsystem from, enum memory_subsystem to, const void *block, size_t bytes);
+
+
+/*
+ * Measure the memory held by each subsystem.
+ *
+ * @return - Memory held by each subsystem, and in total.
+ */
+struct MemoryStats get_memory_stats(void);
+
+
+/*
+ * Return the name of a subsystem, as used in reports and metrics.
+ *
+ * @param subsystem - Subsystem to name.
+ *
+ * @return - Name of subsystem.
+ */
+const char *get_memory_subsystem_name(enum memory_subsystem subsystem);
+
+
+/*
+ * Print a table of the memory held by each subsystem.
+ *
+ * @param stream - Stream to print to.
+ */
+void print_memory_report(FILE *stream);
+
+
+#endif
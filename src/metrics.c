@@ -0,0 +1,435 @@
+/*
+ * Implementation of metrics.h interface.
+ *
+ */
+
+#include "metrics.h"
+
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+typedef SOCKET metrics_socket;
+#define INVALID_METRICS_SOCKET INVALID_SOCKET
+#define SHUTDOWN_BOTH SD_BOTH
+#define close_metrics_socket closesocket
+#else
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+typedef int metrics_socket;
+#define INVALID_METRICS_SOCKET -1
+#define SHUTDOWN_BOTH SHUT_RDWR
+#define close_metrics_socket close
+#endif
+
+// Set in the index handed over between threads once a snapshot is published
+// into it, and cleared once it has been picked up by the reader.
+#define SNAPSHOT_FRESH 4
+
+// Largest response served, being the headers plus the metrics.
+#define RESPONSE_SIZE 16384
+
+// Milliseconds a connection may take to send its request or take its
+// response, before it is given up on.
+#define CONNECTION_TIMEOUT_MS 1000
+
+static const double FRAME_BUCKET_BOUNDS[METRICS_NUM_FRAME_BUCKETS] = METRICS_FRAME_BUCKETS;
+
+// Metrics as recorded so far by the simulation thread, published by copying
+// them into a snapshot.
+static struct MetricsSnapshot RECORDED;
+
+// The three snapshots. At any time one is written by the publisher, one read
+// by the reader, and the third is handed between them.
+static struct MetricsSnapshot SNAPSHOTS[3];
+static unsigned int PUBLISHER_INDEX = 0;
+static unsigned int READER_INDEX = 1;
+static atomic_uint SHARED_INDEX = 2;
+
+static metrics_socket LISTENER = INVALID_METRICS_SOCKET;
+static pthread_t LISTENER_THREAD;
+static atomic_bool IS_LISTENING = false;
+
+// Time memory was last sampled, and whether it has been since the listener
+// started.
+static unsigned int MEMORY_SAMPLED_MS = 0;
+static bool HAS_MEMORY_SAMPLE = false;
+
+
+// ----- PRIVATE FUNCTIONS -----
+
+
+/*
+ * Compare two doubles, for qsort().
+ *
+ * @param first, second - Pointers to doubles to compare.
+ *
+ * @return - Negative, zero or positive as first is less, equal or greater.
+ */
+static int _compare_doubles(const void *first, const void *second)
+{
+    double a = *(const double *) first;
+    double b = *(const double *) second;
+
+    return (a > b) - (a < b);
+}
+
+
+/*
+ * Write text onto the end of a partially written buffer, as snprintf() does.
+ *
+ * @param buffer - Buffer being written.
+ * @param size - Size of buffer in bytes.
+ * @param length - Length written so far, increased by the length of the text
+ * even when it does not fit.
+ * @param format - printf() format of text.
+ */
+static void _append(char *buffer, unsigned int size, unsigned int *length, const char *format, ...)
+{
+    va_list arguments;
+    va_start(arguments, format);
+
+    unsigned int offset = *length < size ? *length : size;
+    int written = vsnprintf(buffer + offset, size - offset, format, arguments);
+
+    va_end(arguments);
+
+    if (written > 0)
+    {
+        *length += written;
+    }
+}
+
+
+/*
+ * Bound how long sending to and receiving from a connection may block, so a
+ * client which never sends its request cannot hold up the listener.
+ *
+ * @param connection - Connection just accepted.
+ */
+static void _set_connection_timeouts(metrics_socket connection)
+{
+#ifdef _WIN32
+    DWORD timeout = CONNECTION_TIMEOUT_MS;
+#else
+    struct timeval timeout = {CONNECTION_TIMEOUT_MS / 1000, (CONNECTION_TIMEOUT_MS % 1000) * 1000};
+#endif
+
+    setsockopt(connection, SOL_SOCKET, SO_RCVTIMEO, (const char *) &timeout, sizeof(timeout));
+    setsockopt(connection, SOL_SOCKET, SO_SNDTIMEO, (const char *) &timeout, sizeof(timeout));
+}
+
+
+/*
+ * Serve metrics to every connection made to the listener, until it is
+ * stopped.
+ *
+ * @param argument - Unused.
+ *
+ * @return - NULL.
+ */
+static void *_serve_metrics(void *argument)
+{
+    static char request[1024];
+    static char body[RESPONSE_SIZE];
+    static char response[RESPONSE_SIZE + 256];
+
+    while (atomic_load(&IS_LISTENING))
+    {
+        metrics_socket connection = accept(LISTENER, NULL, NULL);
+
+        if (connection == INVALID_METRICS_SOCKET)
+        {
+            continue;
+        }
+
+        _set_connection_timeouts(connection);
+
+        // Requests are small enough to arrive at once, and only their first
+        // line matters.
+        int received = recv(connection, request, sizeof(request) - 1, 0);
+        request[received > 0 ? received : 0] = '\0';
+
+        int response_length;
+
+        if (strncmp(request, "GET /metrics", 12) == 0)
+        {
+            unsigned int body_length = format_metrics(read_metrics(), body, sizeof(body));
+
+            if (body_length >= sizeof(body))
+            {
+                body_length = sizeof(body) - 1;
+            }
+
+            response_length = snprintf(response, sizeof(response),
+                    "HTTP/1.0 200 OK\r\n"
+                    "Content-Type: text/plain; version=0.0.4\r\n"
+                    "Content-Length: %u\r\n\r\n%s", body_length, body);
+        }
+        else
+        {
+            response_length = snprintf(response, sizeof(response),
+                    "HTTP/1.0 404 Not Found\r\nContent-Length: 0\r\n\r\n");
+        }
+
+        send(connection, response, response_length, 0);
+        close_metrics_socket(connection);
+    }
+
+    return NULL;
+}
+
+
+// ----- PUBLIC FUNCTIONS -----
+
+
+void metrics_record_frame(double frame_ms, double simulation_ms, double render_ms)
+{
+    RECORDED.frames++;
+
+    RECORDED.frame_ms[RECORDED.next_frame] = frame_ms;
+    RECORDED.next_frame = (RECORDED.next_frame + 1) % METRICS_FRAME_WINDOW;
+
+    if (RECORDED.num_frames < METRICS_FRAME_WINDOW)
+    {
+        RECORDED.num_frames++;
+    }
+
+    unsigned int bucket = 0;
+
+    while (bucket < METRICS_NUM_FRAME_BUCKETS && frame_ms > FRAME_BUCKET_BOUNDS[bucket])
+    {
+        bucket++;
+    }
+
+    RECORDED.frame_buckets[bucket]++;
+    RECORDED.frame_ms_total += frame_ms;
+    RECORDED.simulation_ms_total += simulation_ms;
+    RECORDED.render_ms_total += render_ms;
+}
+
+
+void metrics_record_sandbox(unsigned char **sandbox,
+        unsigned int height,
+        unsigned int width,
+        bool is_frame_complete,
+        unsigned int now_ms)
+{
+    struct SandboxInfo *info = get_sandbox_info(sandbox);
+    unsigned int num_chunks = info -> chunk_rows * info -> chunk_columns;
+
+    if (is_frame_complete)
+    {
+        RECORDED.simulation_frames++;
+        RECORDED.last_stats = get_sandbox_stats(sandbox);
+        RECORDED.tiles_visited_total += RECORDED.last_stats.tiles_visited;
+        RECORDED.swaps_total += RECORDED.last_stats.swaps;
+    }
+
+    RECORDED.pending_chunks = is_sandbox_mid_frame(sandbox) ? num_chunks - get_sandbox_frame_progress(sandbox) : 0;
+
+    // Measuring memory walks every allocation, so only do so for scrapes,
+    // and no more often than they are useful.
+    if (atomic_load(&IS_LISTENING) && (!HAS_MEMORY_SAMPLE || now_ms - MEMORY_SAMPLED_MS >= METRICS_MEMORY_INTERVAL_MS))
+    {
+        RECORDED.memory = get_memory_stats();
+        MEMORY_SAMPLED_MS = now_ms;
+        HAS_MEMORY_SAMPLE = true;
+    }
+}
+
+
+void metrics_record_pending_edits(unsigned int pending_edits)
+{
+    RECORDED.pending_edits = pending_edits;
+}
+
+
+void publish_metrics(void)
+{
+    SNAPSHOTS[PUBLISHER_INDEX] = RECORDED;
+
+    // Hand the fresh snapshot over, taking back whichever the reader is not
+    // using to publish into next time.
+    PUBLISHER_INDEX = atomic_exchange(&SHARED_INDEX, PUBLISHER_INDEX | SNAPSHOT_FRESH) & ~SNAPSHOT_FRESH;
+}
+
+
+const struct MetricsSnapshot *read_metrics(void)
+{
+    // Without anything new published, keep reading the same snapshot.
+    if (atomic_load(&SHARED_INDEX) & SNAPSHOT_FRESH)
+    {
+        READER_INDEX = atomic_exchange(&SHARED_INDEX, READER_INDEX) & ~SNAPSHOT_FRESH;
+    }
+
+    return &SNAPSHOTS[READER_INDEX];
+}
+
+
+unsigned int format_metrics(const struct MetricsSnapshot *snapshot, char *buffer, unsigned int size)
+{
+    unsigned int length = 0;
+    buffer[0] = '\0';
+
+    // Quantiles are taken over the last frames only, sorted out of order.
+    double sorted_ms[METRICS_FRAME_WINDOW];
+    memcpy(sorted_ms, snapshot -> frame_ms, snapshot -> num_frames * sizeof(double));
+    qsort(sorted_ms, snapshot -> num_frames, sizeof(double), _compare_doubles);
+
+    static const double QUANTILES[] = {0.5, 0.9, 0.99};
+
+    _append(buffer, size, &length, "# HELP sand_frame_time_ms Time taken by displayed frames.\n");
+    _append(buffer, size, &length, "# TYPE sand_frame_time_ms histogram\n");
+
+    unsigned long cumulative = 0;
+
+    for (unsigned int bucket = 0; bucket < METRICS_NUM_FRAME_BUCKETS; bucket++)
+    {
+        cumulative += snapshot -> frame_buckets[bucket];
+        _append(buffer, size, &length, "sand_frame_time_ms_bucket{le=\"%g\"} %lu\n", FRAME_BUCKET_BOUNDS[bucket], cumulative);
+    }
+
+    _append(buffer, size, &length, "sand_frame_time_ms_bucket{le=\"+Inf\"} %lu\n", snapshot -> frames);
+    _append(buffer, size, &length, "sand_frame_time_ms_sum %f\n", snapshot -> frame_ms_total);
+    _append(buffer, size, &length, "sand_frame_time_ms_count %lu\n", snapshot -> frames);
+
+    _append(buffer, size, &length, "# HELP sand_recent_frame_time_ms Quantiles of the last %d displayed frames.\n", METRICS_FRAME_WINDOW);
+    _append(buffer, size, &length, "# TYPE sand_recent_frame_time_ms gauge\n");
+
+    for (unsigned int i = 0; i < sizeof(QUANTILES) / sizeof(QUANTILES[0]) && snapshot -> num_frames > 0; i++)
+    {
+        unsigned int rank = (unsigned int) (QUANTILES[i] * (snapshot -> num_frames - 1) + 0.5);
+        _append(buffer, size, &length, "sand_recent_frame_time_ms{quantile=\"%g\"} %f\n", QUANTILES[i], sorted_ms[rank]);
+    }
+
+    _append(buffer, size, &length, "# HELP sand_phase_time_ms_total Time spent in each phase of displayed frames.\n");
+    _append(buffer, size, &length, "# TYPE sand_phase_time_ms_total counter\n");
+    _append(buffer, size, &length, "sand_phase_time_ms_total{phase=\"simulation\"} %f\n", snapshot -> simulation_ms_total);
+    _append(buffer, size, &length, "sand_phase_time_ms_total{phase=\"render\"} %f\n", snapshot -> render_ms_total);
+
+    _append(buffer, size, &length, "# HELP sand_simulation_frames_total Frames of simulation completed.\n");
+    _append(buffer, size, &length, "# TYPE sand_simulation_frames_total counter\n");
+    _append(buffer, size, &length, "sand_simulation_frames_total %lu\n", snapshot -> simulation_frames);
+
+    _append(buffer, size, &length, "# HELP sand_chunks Chunks of the last frame of simulation, by how they were processed.\n");
+    _append(buffer, size, &length, "# TYPE sand_chunks gauge\n");
+    _append(buffer, size, &length, "sand_chunks{mode=\"dense\"} %u\n", snapshot -> last_stats.dense_chunks);
+    _append(buffer, size, &length, "sand_chunks{mode=\"sparse\"} %u\n", snapshot -> last_stats.sparse_chunks);
+    _append(buffer, size, &length, "sand_chunks{mode=\"skipped\"} %u\n", snapshot -> last_stats.skipped_chunks);
+
+    _append(buffer, size, &length, "# HELP sand_active_tiles Tiles simulated during the last frame of simulation.\n");
+    _append(buffer, size, &length, "# TYPE sand_active_tiles gauge\n");
+    _append(buffer, size, &length, "sand_active_tiles %lu\n", snapshot -> last_stats.tiles_visited);
+
+    _append(buffer, size, &length, "# HELP sand_tiles_visited_total Tiles simulated over every frame.\n");
+    _append(buffer, size, &length, "# TYPE sand_tiles_visited_total counter\n");
+    _append(buffer, size, &length, "sand_tiles_visited_total %lu\n", snapshot -> tiles_visited_total);
+
+    _append(buffer, size, &length, "# HELP sand_swaps_total Tile swaps over every frame.\n");
+    _append(buffer, size, &length, "# TYPE sand_swaps_total counter\n");
+    _append(buffer, size, &length, "sand_swaps_total %lu\n", snapshot -> swaps_total);
+
+    // Each measure of memory, with a series per subsystem.
+    const char *memory_names[4] = {"sand_memory_bytes", "sand_memory_resident_bytes", "sand_memory_peak_bytes", "sand_memory_peak_resident_bytes"};
+    const char *memory_help[4] = {"Bytes allocated", "Bytes allocated and resident", "Most bytes allocated at once", "Most bytes resident at once"};
+
+    for (int measure = 0; measure < 4; measure++)
+    {
+        _append(buffer, size, &length, "# HELP %s %s, by subsystem.\n", memory_names[measure], memory_help[measure]);
+        _append(buffer, size, &length, "# TYPE %s gauge\n", memory_names[measure]);
+
+        for (int i = 0; i < NUM_MEMORY_SUBSYSTEMS; i++)
+        {
+            const struct MemoryUsage *usage = &snapshot -> memory.subsystems[i];
+            unsigned long values[4] = {usage -> allocated, usage -> resident, usage -> peak_allocated, usage -> peak_resident};
+
+            _append(buffer, size, &length, "%s{subsystem=\"%s\"} %lu\n", memory_names[measure], get_memory_subsystem_name(i), values[measure]);
+        }
+    }
+
+    _append(buffer, size, &length, "# HELP sand_queue_depth Work waiting, by queue.\n");
+    _append(buffer, size, &length, "# TYPE sand_queue_depth gauge\n");
+    _append(buffer, size, &length, "sand_queue_depth{queue=\"edits\"} %u\n", snapshot -> pending_edits);
+    _append(buffer, size, &length, "sand_queue_depth{queue=\"chunks\"} %u\n", snapshot -> pending_chunks);
+
+    return length;
+}
+
+
+bool start_metrics_server(unsigned short port)
+{
+    if (atomic_load(&IS_LISTENING))
+    {
+        return false;
+    }
+
+#ifdef _WIN32
+    WSADATA wsa_data;
+
+    if (WSAStartup(MAKEWORD(2, 2), &wsa_data) != 0)
+    {
+        return false;
+    }
+#endif
+
+    LISTENER = socket(AF_INET, SOCK_STREAM, 0);
+
+    if (LISTENER == INVALID_METRICS_SOCKET)
+    {
+        return false;
+    }
+
+    int should_reuse = 1;
+    setsockopt(LISTENER, SOL_SOCKET, SO_REUSEADDR, (const char *) &should_reuse, sizeof(should_reuse));
+
+    // Only listen on localhost, never on the network.
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    if (bind(LISTENER, (struct sockaddr *) &address, sizeof(address)) != 0 || listen(LISTENER, 8) != 0)
+    {
+        close_metrics_socket(LISTENER);
+        LISTENER = INVALID_METRICS_SOCKET;
+        return false;
+    }
+
+    HAS_MEMORY_SAMPLE = false;
+    atomic_store(&IS_LISTENING, true);
+
+    if (pthread_create(&LISTENER_THREAD, NULL, _serve_metrics, NULL) != 0)
+    {
+        atomic_store(&IS_LISTENING, false);
+        close_metrics_socket(LISTENER);
+        LISTENER = INVALID_METRICS_SOCKET;
+        return false;
+    }
+
+    return true;
+}
+
+
+void stop_metrics_server(void)
+{
+    if (!atomic_load(&IS_LISTENING))
+    {
+        return;
+    }
+
+    // Shutting the listener down wakes the thread from accept().
+    atomic_store(&IS_LISTENING, false);
+    shutdown(LISTENER, SHUTDOWN_BOTH);
+    close_metrics_socket(LISTENER);
+    pthread_join(LISTENER_THREAD, NULL);
+
+    LISTENER = INVALID_METRICS_SOCKET;
+}
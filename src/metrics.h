@@ -0,0 +1,157 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+/*
+ * Metrics describing a running sandbox, served in the Prometheus text format
+ * by an optional HTTP listener on localhost.
+ *
+ * The simulation thread records metrics with the metrics_record_*() functions
+ * and calls publish_metrics() once per displayed frame. Publishing copies the
+ * metrics into one of three snapshots, handed between the simulation thread
+ * and the listener with a single atomic exchange each, so neither thread ever
+ * waits on the other and scrapes never slow down the simulation.
+ *
+ */
+
+#include "sandbox.h"
+#include "chunk_cache.h"
+
+// Number of most recent displayed frames frame time quantiles are taken over.
+#define METRICS_FRAME_WINDOW 256
+
+// Upper bounds, in milliseconds, of the frame time histogram's buckets,
+// besides the last bucket holding everything.
+#define METRICS_FRAME_BUCKETS {1, 2, 4, 8, 16, 33, 50, 100, 250}
+#define METRICS_NUM_FRAME_BUCKETS 9
+
+// Milliseconds between measurements of memory while the listener runs, as
+// often as the window title shows it.
+#define METRICS_MEMORY_INTERVAL_MS 1000
+
+
+// Everything served by the listener, as of one call to publish_metrics().
+struct MetricsSnapshot
+{
+    // Displayed frames, and completed frames of simulation.
+    unsigned long frames;
+    unsigned long simulation_frames;
+
+    // Times of the last displayed frames, with next_frame the oldest once
+    // num_frames reaches METRICS_FRAME_WINDOW.
+    double frame_ms[METRICS_FRAME_WINDOW];
+    unsigned int num_frames;
+    unsigned int next_frame;
+
+    // Histogram of the times of every displayed frame, the last count being
+    // frames longer than every bound.
+    unsigned long frame_buckets[METRICS_NUM_FRAME_BUCKETS + 1];
+    double frame_ms_total;
+
+    // Time spent simulating and rendering over every displayed frame.
+    double simulation_ms_total;
+    double render_ms_total;
+
+    // Counters of the last completed frame of simulation, and totals of
+    // them over every frame.
+    struct SandboxStats last_stats;
+    unsigned long tiles_visited_total;
+    unsigned long swaps_total;
+
+    // Memory held by each subsystem of the program.
+    struct MemoryStats memory;
+
+    // Edits on their way to the screen, and chunks of the current frame of
+    // simulation still to process.
+    unsigned int pending_edits;
+    unsigned int pending_chunks;
+};
+
+
+/*
+ * Record the times taken by a displayed frame.
+ *
+ * @param frame_ms - Milliseconds taken by the whole frame.
+ * @param simulation_ms - Milliseconds of it spent simulating.
+ * @param render_ms - Milliseconds of it spent drawing and presenting.
+ */
+void metrics_record_frame(double frame_ms, double simulation_ms, double render_ms);
+
+
+/*
+ * Record the state of a sandbox after it was processed for a displayed frame.
+ *
+ * Memory is only measured while the listener runs, at most once every
+ * METRICS_MEMORY_INTERVAL_MS.
+ *
+ * @param sandbox - Sandbox being simulated.
+ * @param height, width - Dimensions of sandbox.
+ * @param is_frame_complete - Whether a frame of simulation was completed,
+ * and its counters are to be added up.
+ * @param now_ms - Current time.
+ */
+void metrics_record_sandbox(unsigned char **sandbox,
+        unsigned int height,
+        unsigned int width,
+        bool is_frame_complete,
+        unsigned int now_ms);
+
+
+/*
+ * Record the number of edits applied to the sandbox, but not yet displayed.
+ *
+ * @param pending_edits - Number of edits.
+ */
+void metrics_record_pending_edits(unsigned int pending_edits);
+
+
+/*
+ * Make everything recorded so far visible to read_metrics(), without waiting
+ * on any reader.
+ *
+ * Must only be called from a single thread.
+ */
+void publish_metrics(void);
+
+
+/*
+ * Obtain the metrics as of the most recent call to publish_metrics(), without
+ * waiting on the publishing thread.
+ *
+ * Must only be called from a single thread, which is the listener's while
+ * it runs.
+ *
+ * @return - Pointer to snapshot of metrics, valid until the next call.
+ */
+const struct MetricsSnapshot *read_metrics(void);
+
+
+/*
+ * Write a snapshot of metrics out in the Prometheus text format.
+ *
+ * @param snapshot - Metrics to write.
+ * @param buffer - Buffer to write into, always NULL terminated.
+ * @param size - Size of buffer in bytes.
+ *
+ * @return - Length of the text, which was cut short if not under size.
+ */
+unsigned int format_metrics(const struct MetricsSnapshot *snapshot, char *buffer, unsigned int size);
+
+
+/*
+ * Start serving metrics over HTTP on the given port of localhost, from a
+ * thread of their own.
+ *
+ * @param port - Port to listen on.
+ *
+ * @return - True if the listener started, false otherwise.
+ */
+bool start_metrics_server(unsigned short port);
+
+
+/*
+ * Stop the listener started by start_metrics_server(), if any.
+ */
+void stop_metrics_server(void);
+
+
+#endif
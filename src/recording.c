@@ -0,0 +1,896 @@
+/*
+ * Implementation of recording.h interface.
+ *
+ */
+
+#include "recording.h"
+
+// Number of values stored after the magic bytes, before the first frame.
+#define RECORDING_HEADER_VALUES 5
+
+// Offset in bytes of the first frame within a recording.
+#define RECORDING_FRAMES_OFFSET (4 + RECORDING_HEADER_VALUES * 4)
+
+// Bytes every frame starts with, being its tag, lifetime and world hash.
+#define FRAME_HEADER_BYTES 16
+
+// Bytes the index starts with, being its tag and numbers of frames and
+// keyframes, and bytes finished recordings end with, being its offset.
+#define INDEX_HEADER_BYTES 12
+#define INDEX_FOOTER_BYTES 8
+
+// Number of frames the index of a writer first has room for.
+#define INDEX_START_CAPACITY 1024
+
+// Number of changes read from the change feed at once.
+#define CHANGE_BATCH 256
+
+static const char RECORDING_MAGIC[4] = {'S', 'R', 'E', 'C'};
+static const char KEYFRAME_TAG[4] = {'K', 'E', 'Y', 'F'};
+static const char DELTA_TAG[4] = {'D', 'E', 'L', 'T'};
+static const char INDEX_TAG[4] = {'I', 'N', 'D', 'X'};
+
+
+struct RecordingWriter
+{
+    unsigned char **sandbox;
+    unsigned int height;
+    unsigned int width;
+
+    // Dimensions of sandbox in chunks, rounding up.
+    unsigned int chunk_rows;
+    unsigned int chunk_columns;
+
+    FILE *file;
+
+    // Bytes written so far, being the offset of the next frame.
+    unsigned long long offset;
+
+    // Whether anything failed to be written, leaving the recording
+    // unfinished.
+    bool is_failed;
+
+    // Cursor into the sandbox's change feed.
+    unsigned long cursor;
+
+    // Whether each chunk changed since the last frame written, and the index
+    // of each that did, in the order they first changed.
+    bool *is_chunk_changed;
+    unsigned int *changed_chunks;
+    unsigned int num_changed;
+
+    // Offset of each frame written, and number of each keyframe.
+    unsigned long long *frame_offsets;
+    unsigned int num_frames;
+    unsigned int frame_capacity;
+
+    unsigned int *keyframes;
+    unsigned int num_keyframes;
+    unsigned int keyframe_capacity;
+};
+
+
+// ----- PRIVATE FUNCTIONS -----
+
+
+/*
+ * Grow an array of the index of a recording to hold at least one more item.
+ *
+ * @param array - Array to grow, replaced by the grown one.
+ * @param count - Number of items held by the array.
+ * @param capacity - Number of items the array has room for, updated.
+ * @param item_bytes - Size of each item.
+ *
+ * @return - True if the array has room for another item, false if there was
+ * no memory left.
+ */
+static bool _grow_index(void **array, unsigned int count, unsigned int *capacity, size_t item_bytes)
+{
+    if (count < *capacity)
+    {
+        return true;
+    }
+
+    unsigned int grown_capacity = *capacity > 0 ? 2 * *capacity : INDEX_START_CAPACITY;
+    void *grown = allocate_memory(MEMORY_CAPTURE, grown_capacity * item_bytes);
+
+    if (grown == NULL)
+    {
+        return false;
+    }
+
+    if (count > 0)
+    {
+        memcpy(grown, *array, count * item_bytes);
+    }
+
+    release_memory(MEMORY_CAPTURE, *array, *capacity * item_bytes);
+
+    *array = grown;
+    *capacity = grown_capacity;
+
+    return true;
+}
+
+
+/*
+ * Append bytes to a recording, unless writing it already failed.
+ *
+ * @param writer - Writer of recording.
+ * @param data - Bytes to write.
+ * @param bytes - Number of bytes to write.
+ */
+static void _write(struct RecordingWriter *writer, const void *data, size_t bytes)
+{
+    if (writer -> is_failed)
+    {
+        return;
+    }
+
+    writer -> is_failed = fwrite(data, 1, bytes, writer -> file) != bytes;
+    writer -> offset += bytes;
+}
+
+
+/*
+ * Append a value to a recording, stored by pack_save_u32().
+ *
+ * @param writer - Writer of recording.
+ * @param value - Value to write.
+ */
+static void _write_u32(struct RecordingWriter *writer, unsigned int value)
+{
+    unsigned char bytes[4];
+
+    pack_save_u32(bytes, value);
+    _write(writer, bytes, 4);
+}
+
+
+/*
+ * Append a value to a recording, stored by pack_save_u64().
+ *
+ * @param writer - Writer of recording.
+ * @param value - Value to write.
+ */
+static void _write_u64(struct RecordingWriter *writer, unsigned long long value)
+{
+    unsigned char bytes[8];
+
+    pack_save_u64(bytes, value);
+    _write(writer, bytes, 8);
+}
+
+
+/*
+ * Find the tiles of a chunk, clipped to the sandbox.
+ *
+ * @param height, width - Dimensions of sandbox.
+ * @param chunk_columns - Number of columns of chunks of sandbox.
+ * @param chunk_index - Index of chunk, counting chunks row by row.
+ * @param row_index, column_index - Set to coordinates of top left tile.
+ * @param chunk_height, chunk_width - Set to dimensions of chunk.
+ */
+static void _get_chunk_tiles(unsigned int height,
+        unsigned int width,
+        unsigned int chunk_columns,
+        unsigned int chunk_index,
+        unsigned int *row_index,
+        unsigned int *column_index,
+        unsigned int *chunk_height,
+        unsigned int *chunk_width)
+{
+    *row_index = chunk_index / chunk_columns * CHUNK_SIZE;
+    *column_index = chunk_index % chunk_columns * CHUNK_SIZE;
+    *chunk_height = height - *row_index < CHUNK_SIZE ? height - *row_index : CHUNK_SIZE;
+    *chunk_width = width - *column_index < CHUNK_SIZE ? width - *column_index : CHUNK_SIZE;
+}
+
+
+/*
+ * Mark the chunks changed since the last frame written, as told by the
+ * sandbox's change feed.
+ *
+ * @param writer - Writer of sandbox's recording.
+ *
+ * @return - True if the changes read are all that changed, false if the
+ * whole sandbox must be treated as changed.
+ */
+static bool _read_changed_chunks(struct RecordingWriter *writer)
+{
+    struct TileChange changes[CHANGE_BATCH];
+    unsigned int num_read;
+
+    do
+    {
+        if (!read_changes(writer -> sandbox, &writer -> cursor, changes, CHANGE_BATCH, &num_read))
+        {
+            return false;
+        }
+
+        for (unsigned int i = 0; i < num_read; i++)
+        {
+            unsigned int chunk_index = changes[i].row * writer -> chunk_columns + changes[i].column;
+
+            if (!writer -> is_chunk_changed[chunk_index])
+            {
+                writer -> is_chunk_changed[chunk_index] = true;
+                writer -> changed_chunks[writer -> num_changed++] = chunk_index;
+            }
+        }
+    }
+    while (num_read == CHANGE_BATCH);
+
+    return true;
+}
+
+
+/*
+ * Append the current tiles of the sandbox to its recording as a new frame,
+ * either every tile as a keyframe, or those of the chunks changed.
+ *
+ * @param writer - Writer of sandbox's recording.
+ * @param is_keyframe - Whether to write every tile.
+ */
+static void _write_frame(struct RecordingWriter *writer, bool is_keyframe)
+{
+    bool is_indexed = _grow_index((void **) &writer -> frame_offsets,
+            writer -> num_frames,
+            &writer -> frame_capacity,
+            sizeof(unsigned long long));
+
+    if (is_indexed && is_keyframe)
+    {
+        is_indexed = _grow_index((void **) &writer -> keyframes,
+                writer -> num_keyframes,
+                &writer -> keyframe_capacity,
+                sizeof(unsigned int));
+    }
+
+    if (!is_indexed)
+    {
+        writer -> is_failed = true;
+        return;
+    }
+
+    writer -> frame_offsets[writer -> num_frames] = writer -> offset;
+
+    _write(writer, is_keyframe ? KEYFRAME_TAG : DELTA_TAG, 4);
+    _write_u32(writer, SANDBOX_LIFETIME);
+    _write_u64(writer, get_world_hash(writer -> sandbox));
+
+    if (is_keyframe)
+    {
+        writer -> keyframes[writer -> num_keyframes++] = writer -> num_frames;
+        _write(writer, get_sandbox_info(writer -> sandbox) -> tiles, (size_t) writer -> height * writer -> width);
+
+        // Keep everything up to the latest keyframe readable if the program
+        // stops without finishing the recording.
+        writer -> is_failed = writer -> is_failed || fflush(writer -> file) != 0;
+    }
+    else
+    {
+        _write_u32(writer, writer -> num_changed);
+
+        for (unsigned int i = 0; i < writer -> num_changed; i++)
+        {
+            _write_u32(writer, writer -> changed_chunks[i]);
+        }
+
+        for (unsigned int i = 0; i < writer -> num_changed; i++)
+        {
+            unsigned int row_index, column_index, chunk_height, chunk_width;
+
+            _get_chunk_tiles(writer -> height,
+                    writer -> width,
+                    writer -> chunk_columns,
+                    writer -> changed_chunks[i],
+                    &row_index,
+                    &column_index,
+                    &chunk_height,
+                    &chunk_width);
+
+            for (unsigned int row = row_index; row < row_index + chunk_height; row++)
+            {
+                _write(writer, &writer -> sandbox[row][column_index], chunk_width);
+            }
+        }
+    }
+
+    writer -> num_frames++;
+}
+
+
+/*
+ * Read a frame of a recording, writing the tiles of each chunk it holds into
+ * the recording's sandbox unless a later frame already wrote them during the
+ * seek in progress, and marking those written as stale.
+ *
+ * @param recording - Recording holding frame.
+ * @param offset - Offset of frame within the recording's file.
+ * @param is_written - Whether to write the frame's tiles, rather than only
+ * measure the frame.
+ * @param bytes - Set to the size of the frame.
+ * @param is_keyframe - Set to whether the frame is a keyframe.
+ *
+ * @return - True if the whole frame was read, false if it runs past the end
+ * of the file or is damaged, in which case only part of it may have been
+ * written into the sandbox.
+ */
+static bool _read_frame(struct Recording *recording,
+        unsigned long long offset,
+        bool is_written,
+        unsigned long long *bytes,
+        bool *is_keyframe)
+{
+    unsigned long long file_size = recording -> file_size;
+
+    if (offset > file_size || file_size - offset < FRAME_HEADER_BYTES)
+    {
+        return false;
+    }
+
+    const unsigned char *frame = recording -> file + offset;
+    unsigned long long position = offset + FRAME_HEADER_BYTES;
+    unsigned int chunk_columns = (recording -> width + CHUNK_SIZE - 1) / CHUNK_SIZE;
+
+    *is_keyframe = memcmp(frame, KEYFRAME_TAG, 4) == 0;
+
+    if (*is_keyframe)
+    {
+        size_t num_tiles = (size_t) recording -> height * recording -> width;
+
+        if (file_size - position < num_tiles)
+        {
+            return false;
+        }
+
+        for (unsigned int i = 0; is_written && i < recording -> num_chunks; i++)
+        {
+            if (recording -> stale_chunks[i])
+            {
+                continue;
+            }
+
+            unsigned int row_index, column_index, chunk_height, chunk_width;
+
+            _get_chunk_tiles(recording -> height,
+                    recording -> width,
+                    chunk_columns,
+                    i,
+                    &row_index,
+                    &column_index,
+                    &chunk_height,
+                    &chunk_width);
+
+            for (unsigned int row = row_index; row < row_index + chunk_height; row++)
+            {
+                memcpy(&recording -> sandbox[row][column_index],
+                        recording -> file + position + (size_t) row * recording -> width + column_index,
+                        chunk_width);
+            }
+
+            recording -> stale_chunks[i] = true;
+        }
+
+        *bytes = FRAME_HEADER_BYTES + num_tiles;
+        return true;
+    }
+
+    if (memcmp(frame, DELTA_TAG, 4) != 0 || file_size - position < 4)
+    {
+        return false;
+    }
+
+    unsigned int num_changed = unpack_save_u32(recording -> file + position);
+    position += 4;
+
+    if ((file_size - position) / 4 < num_changed)
+    {
+        return false;
+    }
+
+    // Chunk indices come first, so only the tiles actually written are read.
+    const unsigned char *chunk_indices = recording -> file + position;
+    position += num_changed * 4ULL;
+
+    for (unsigned int i = 0; i < num_changed; i++)
+    {
+        unsigned int chunk_index = unpack_save_u32(chunk_indices + i * 4);
+
+        if (chunk_index >= recording -> num_chunks)
+        {
+            return false;
+        }
+
+        unsigned int row_index, column_index, chunk_height, chunk_width;
+
+        _get_chunk_tiles(recording -> height,
+                recording -> width,
+                chunk_columns,
+                chunk_index,
+                &row_index,
+                &column_index,
+                &chunk_height,
+                &chunk_width);
+
+        if (file_size - position < chunk_height * chunk_width)
+        {
+            return false;
+        }
+
+        if (is_written && !recording -> stale_chunks[chunk_index])
+        {
+            for (unsigned int row = 0; row < chunk_height; row++)
+            {
+                memcpy(&recording -> sandbox[row_index + row][column_index],
+                        recording -> file + position + row * chunk_width,
+                        chunk_width);
+            }
+
+            recording -> stale_chunks[chunk_index] = true;
+        }
+
+        position += chunk_height * chunk_width;
+    }
+
+    *bytes = position - offset;
+    return true;
+}
+
+
+/*
+ * Read the index a finished recording ends with.
+ *
+ * @param recording - Recording to read index of, given its frame offsets and
+ * keyframe numbers.
+ *
+ * @return - True if the index was read, false if the recording has none or
+ * it is damaged.
+ */
+static bool _read_index(struct Recording *recording)
+{
+    unsigned long long file_size = recording -> file_size;
+
+    if (file_size < RECORDING_FRAMES_OFFSET + INDEX_HEADER_BYTES + INDEX_FOOTER_BYTES)
+    {
+        return false;
+    }
+
+    unsigned long long index_offset = unpack_save_u64(recording -> file + file_size - INDEX_FOOTER_BYTES);
+
+    if (index_offset < RECORDING_FRAMES_OFFSET || index_offset > file_size - INDEX_HEADER_BYTES - INDEX_FOOTER_BYTES)
+    {
+        return false;
+    }
+
+    const unsigned char *index = recording -> file + index_offset;
+    unsigned int num_frames = unpack_save_u32(index + 4);
+    unsigned int num_keyframes = unpack_save_u32(index + 8);
+    unsigned long long index_bytes = file_size - INDEX_FOOTER_BYTES - index_offset - INDEX_HEADER_BYTES;
+
+    // Every frame follows the first keyframe.
+    if (memcmp(index, INDEX_TAG, 4) != 0
+            || index_bytes != num_frames * 8ULL + num_keyframes * 4ULL
+            || num_keyframes == 0
+            || unpack_save_u32(index + INDEX_HEADER_BYTES + num_frames * 8ULL) != 0)
+    {
+        return false;
+    }
+
+    recording -> frame_offsets = (unsigned long long *) allocate_memory(MEMORY_CAPTURE, num_frames * sizeof(unsigned long long));
+    recording -> keyframes = (unsigned int *) allocate_memory(MEMORY_CAPTURE, num_keyframes * sizeof(unsigned int));
+
+    if (recording -> frame_offsets == NULL || recording -> keyframes == NULL)
+    {
+        release_memory(MEMORY_CAPTURE, recording -> frame_offsets, num_frames * sizeof(unsigned long long));
+        release_memory(MEMORY_CAPTURE, recording -> keyframes, num_keyframes * sizeof(unsigned int));
+        recording -> frame_offsets = NULL;
+        recording -> keyframes = NULL;
+        return false;
+    }
+
+    for (unsigned int i = 0; i < num_frames; i++)
+    {
+        recording -> frame_offsets[i] = unpack_save_u64(index + INDEX_HEADER_BYTES + i * 8ULL);
+    }
+
+    // Keyframes are sought by binary search, so they must be in order.
+    const unsigned char *keyframes = index + INDEX_HEADER_BYTES + num_frames * 8ULL;
+    bool is_ordered = true;
+
+    for (unsigned int i = 0; i < num_keyframes; i++)
+    {
+        recording -> keyframes[i] = unpack_save_u32(keyframes + i * 4);
+        is_ordered = is_ordered && recording -> keyframes[i] < num_frames
+            && (i == 0 || recording -> keyframes[i] > recording -> keyframes[i - 1]);
+    }
+
+    recording -> num_frames = num_frames;
+    recording -> num_keyframes = num_keyframes;
+
+    return is_ordered;
+}
+
+
+/*
+ * Find the frames of a recording left without an index by reading through
+ * it, up to its last whole frame.
+ *
+ * @param recording - Recording to find frames of, given their offsets and
+ * the numbers of keyframes if it already has room for them, or else only
+ * their numbers.
+ */
+static void _scan_frames(struct Recording *recording)
+{
+    unsigned long long offset = RECORDING_FRAMES_OFFSET;
+    unsigned long long bytes;
+    bool is_keyframe;
+    unsigned int num_frames = 0;
+    unsigned int num_keyframes = 0;
+
+    while (_read_frame(recording, offset, false, &bytes, &is_keyframe))
+    {
+        // Every frame follows the first keyframe.
+        if (num_frames == 0 && !is_keyframe)
+        {
+            break;
+        }
+
+        if (recording -> frame_offsets != NULL)
+        {
+            recording -> frame_offsets[num_frames] = offset;
+
+            if (is_keyframe)
+            {
+                recording -> keyframes[num_keyframes] = num_frames;
+            }
+        }
+
+        num_frames++;
+        num_keyframes += is_keyframe;
+        offset += bytes;
+    }
+
+    recording -> num_frames = num_frames;
+    recording -> num_keyframes = num_keyframes;
+}
+
+
+/*
+ * Find the last keyframe of a recording at or before a frame.
+ *
+ * @param recording - Recording to search.
+ * @param frame - Number of frame.
+ *
+ * @return - Number of keyframe.
+ */
+static unsigned int _find_keyframe(const struct Recording *recording, unsigned int frame)
+{
+    unsigned int low = 0;
+    unsigned int high = recording -> num_keyframes;
+
+    // The first frame is always a keyframe, so one is always found.
+    while (high - low > 1)
+    {
+        unsigned int middle = low + (high - low) / 2;
+
+        if (recording -> keyframes[middle] <= frame)
+        {
+            low = middle;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    return recording -> keyframes[low];
+}
+
+
+/*
+ * Hash the stale chunks of a recording's sandbox again, as wake_region()
+ * does, or the whole sandbox if every chunk is stale.
+ *
+ * @param recording - Recording holding sandbox.
+ */
+static void _rehash_stale_chunks(struct Recording *recording)
+{
+    unsigned int chunk_columns = (recording -> width + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    unsigned int num_stale = 0;
+
+    for (unsigned int i = 0; i < recording -> num_chunks; i++)
+    {
+        num_stale += recording -> stale_chunks[i];
+    }
+
+    if (num_stale == recording -> num_chunks)
+    {
+        wake_sandbox(recording -> sandbox);
+    }
+    else
+    {
+        for (unsigned int i = 0; num_stale > 0 && i < recording -> num_chunks; i++)
+        {
+            if (!recording -> stale_chunks[i])
+            {
+                continue;
+            }
+
+            unsigned int row_index, column_index, chunk_height, chunk_width;
+
+            _get_chunk_tiles(recording -> height,
+                    recording -> width,
+                    chunk_columns,
+                    i,
+                    &row_index,
+                    &column_index,
+                    &chunk_height,
+                    &chunk_width);
+
+            wake_region(recording -> sandbox, row_index, column_index, chunk_height, chunk_width);
+            num_stale--;
+        }
+    }
+
+    memset(recording -> stale_chunks, false, recording -> num_chunks * sizeof(bool));
+}
+
+
+// ----- PUBLIC FUNCTIONS -----
+
+
+struct RecordingWriter *start_recording(const char *path,
+        unsigned char **sandbox,
+        unsigned int height,
+        unsigned int width)
+{
+    FILE *file = fopen(path, "wb");
+
+    if (file == NULL)
+    {
+        return NULL;
+    }
+
+    struct SandboxInfo *info = get_sandbox_info(sandbox);
+    unsigned int num_chunks = info -> chunk_rows * info -> chunk_columns;
+
+    struct RecordingWriter *writer = (struct RecordingWriter *) allocate_memory(MEMORY_CAPTURE, sizeof(struct RecordingWriter));
+    writer -> is_chunk_changed = (bool *) allocate_memory(MEMORY_CAPTURE, num_chunks * sizeof(bool));
+    writer -> changed_chunks = (unsigned int *) allocate_memory(MEMORY_CAPTURE, num_chunks * sizeof(unsigned int));
+
+    writer -> sandbox = sandbox;
+    writer -> height = height;
+    writer -> width = width;
+    writer -> chunk_rows = info -> chunk_rows;
+    writer -> chunk_columns = info -> chunk_columns;
+    writer -> file = file;
+
+    set_change_feed(sandbox, CHANGES_CHUNKS, num_chunks * RECORDING_FEED_RECORDS_PER_CHUNK);
+    writer -> cursor = get_change_cursor(sandbox);
+
+    _write(writer, RECORDING_MAGIC, 4);
+    _write_u32(writer, RECORDING_VERSION);
+    _write_u32(writer, height);
+    _write_u32(writer, width);
+    _write_u32(writer, SANDBOX_SEED);
+    _write_u32(writer, SANDBOX_RNG_PERIOD);
+
+    _write_frame(writer, true);
+
+    if (writer -> is_failed)
+    {
+        finish_recording(writer);
+        return NULL;
+    }
+
+    return writer;
+}
+
+
+bool record_frame(struct RecordingWriter *writer)
+{
+    if (writer -> is_failed)
+    {
+        return false;
+    }
+
+    bool is_known = _read_changed_chunks(writer);
+    unsigned int frames_since_keyframe = writer -> num_frames - writer -> keyframes[writer -> num_keyframes - 1];
+
+    _write_frame(writer, !is_known || frames_since_keyframe >= RECORDING_KEYFRAME_INTERVAL);
+
+    for (unsigned int i = 0; i < writer -> num_changed; i++)
+    {
+        writer -> is_chunk_changed[writer -> changed_chunks[i]] = false;
+    }
+
+    writer -> num_changed = 0;
+
+    return !writer -> is_failed;
+}
+
+
+bool finish_recording(struct RecordingWriter *writer)
+{
+    unsigned long long index_offset = writer -> offset;
+
+    _write(writer, INDEX_TAG, 4);
+    _write_u32(writer, writer -> num_frames);
+    _write_u32(writer, writer -> num_keyframes);
+
+    for (unsigned int i = 0; i < writer -> num_frames; i++)
+    {
+        _write_u64(writer, writer -> frame_offsets[i]);
+    }
+
+    for (unsigned int i = 0; i < writer -> num_keyframes; i++)
+    {
+        _write_u32(writer, writer -> keyframes[i]);
+    }
+
+    _write_u64(writer, index_offset);
+
+    bool is_written = fclose(writer -> file) == 0 && !writer -> is_failed;
+
+    set_change_feed(writer -> sandbox, CHANGES_CHUNKS, 0);
+
+    unsigned int num_chunks = writer -> chunk_rows * writer -> chunk_columns;
+
+    release_memory(MEMORY_CAPTURE, writer -> is_chunk_changed, num_chunks * sizeof(bool));
+    release_memory(MEMORY_CAPTURE, writer -> changed_chunks, num_chunks * sizeof(unsigned int));
+    release_memory(MEMORY_CAPTURE, writer -> frame_offsets, writer -> frame_capacity * sizeof(unsigned long long));
+    release_memory(MEMORY_CAPTURE, writer -> keyframes, writer -> keyframe_capacity * sizeof(unsigned int));
+    release_memory(MEMORY_CAPTURE, writer, sizeof(struct RecordingWriter));
+
+    return is_written;
+}
+
+
+struct Recording *open_recording(const char *path)
+{
+    FILE *file = fopen(path, "rb");
+
+    if (file == NULL)
+    {
+        return NULL;
+    }
+
+    // Mapped bytes past the end of the file cannot be read, so only map
+    // those there are.
+    long file_size = fseek(file, 0, SEEK_END) == 0 ? ftell(file) : -1;
+
+    fclose(file);
+
+    if (file_size < RECORDING_FRAMES_OFFSET)
+    {
+        return NULL;
+    }
+
+    unsigned char *bytes = (unsigned char *) map_file(MEMORY_CAPTURE, path, 0, file_size);
+
+    if (bytes == NULL)
+    {
+        return NULL;
+    }
+
+    unsigned int header[RECORDING_HEADER_VALUES];
+
+    for (unsigned int i = 0; i < RECORDING_HEADER_VALUES; i++)
+    {
+        header[i] = unpack_save_u32(bytes + 4 + i * 4);
+    }
+
+    if (memcmp(bytes, RECORDING_MAGIC, 4) != 0 || header[0] != RECORDING_VERSION || header[1] == 0 || header[2] == 0)
+    {
+        unmap_file(MEMORY_CAPTURE, bytes, file_size);
+        return NULL;
+    }
+
+    struct Recording *recording = (struct Recording *) allocate_memory(MEMORY_CAPTURE, sizeof(struct Recording));
+
+    recording -> height = header[1];
+    recording -> width = header[2];
+    recording -> seed = header[3];
+    recording -> rng_period = header[4];
+    recording -> file = bytes;
+    recording -> file_size = file_size;
+    recording -> num_chunks = ((recording -> height + CHUNK_SIZE - 1) / CHUNK_SIZE) * ((recording -> width + CHUNK_SIZE - 1) / CHUNK_SIZE);
+    recording -> stale_chunks = (bool *) allocate_memory(MEMORY_CAPTURE, recording -> num_chunks * sizeof(bool));
+
+    // Recordings without an index are read through once to count their
+    // frames, and again to find them.
+    if (!_read_index(recording))
+    {
+        release_memory(MEMORY_CAPTURE, recording -> frame_offsets, recording -> num_frames * sizeof(unsigned long long));
+        release_memory(MEMORY_CAPTURE, recording -> keyframes, recording -> num_keyframes * sizeof(unsigned int));
+        recording -> frame_offsets = NULL;
+        recording -> keyframes = NULL;
+
+        _scan_frames(recording);
+
+        recording -> frame_offsets = (unsigned long long *) allocate_memory(MEMORY_CAPTURE, recording -> num_frames * sizeof(unsigned long long));
+        recording -> keyframes = (unsigned int *) allocate_memory(MEMORY_CAPTURE, recording -> num_keyframes * sizeof(unsigned int));
+
+        if (recording -> frame_offsets != NULL && recording -> keyframes != NULL)
+        {
+            _scan_frames(recording);
+        }
+    }
+
+    recording -> sandbox = create_sandbox(recording -> height, recording -> width);
+
+    if (recording -> num_frames == 0 || recording -> frame_offsets == NULL || recording -> keyframes == NULL
+            || recording -> sandbox == NULL || recording -> stale_chunks == NULL)
+    {
+        close_recording(recording);
+        return NULL;
+    }
+
+    set_sandbox_memory_subsystem(recording -> sandbox, MEMORY_SNAPSHOTS);
+
+    // Nothing is held yet, so the first frame is rebuilt from its keyframe.
+    recording -> frame = recording -> num_frames;
+    seek_recording(recording, 0);
+
+    return recording;
+}
+
+
+bool seek_recording(struct Recording *recording, unsigned int frame)
+{
+    if (frame >= recording -> num_frames)
+    {
+        return false;
+    }
+
+    // Go on from the frame held if no keyframe lies between, as it is then
+    // closer than the keyframe.
+    unsigned int keyframe = _find_keyframe(recording, frame);
+    bool is_going_on = recording -> frame <= frame && recording -> frame >= keyframe;
+    unsigned int first_frame = is_going_on ? recording -> frame + 1 : keyframe;
+
+    // Read the latest frames first, so each chunk is only written once, from
+    // the last frame changing it.
+    for (unsigned int i = frame + 1; i-- > first_frame;)
+    {
+        unsigned long long bytes;
+        bool is_keyframe;
+
+        if (!_read_frame(recording, recording -> frame_offsets[i], true, &bytes, &is_keyframe)
+                || (i == keyframe && !is_keyframe))
+        {
+            _rehash_stale_chunks(recording);
+
+            // What is held is no frame at all, so rebuild the next from its
+            // keyframe.
+            recording -> frame = recording -> num_frames;
+            return false;
+        }
+    }
+
+    _rehash_stale_chunks(recording);
+
+    const unsigned char *header = recording -> file + recording -> frame_offsets[frame];
+
+    recording -> frame = frame;
+    recording -> lifetime = unpack_save_u32(header + 4);
+
+    return get_world_hash(recording -> sandbox) == unpack_save_u64(header + 8);
+}
+
+
+void close_recording(struct Recording *recording)
+{
+    if (recording -> sandbox != NULL)
+    {
+        sandbox_free(recording -> sandbox, recording -> height, recording -> width);
+    }
+
+    release_memory(MEMORY_CAPTURE, recording -> frame_offsets, recording -> num_frames * sizeof(unsigned long long));
+    release_memory(MEMORY_CAPTURE, recording -> keyframes, recording -> num_keyframes * sizeof(unsigned int));
+    release_memory(MEMORY_CAPTURE, recording -> stale_chunks, recording -> num_chunks * sizeof(bool));
+    unmap_file(MEMORY_CAPTURE, recording -> file, recording -> file_size);
+    release_memory(MEMORY_CAPTURE, recording, sizeof(struct Recording));
+}
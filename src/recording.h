@@ -0,0 +1,172 @@
+#ifndef RECORDING_H
+#define RECORDING_H
+
+/*
+ * Recordings of every frame of a sandbox written to disk, to review long
+ * sessions by jumping to any of their frames without simulating them again.
+ *
+ * After each completed frame, the writer appends the tiles of every chunk the
+ * frame changed, as read from the sandbox's change feed, so a still sandbox
+ * costs a few bytes a frame. Every RECORDING_KEYFRAME_INTERVAL frames, and
+ * whenever the change feed cannot tell what changed, it appends every tile
+ * instead, as a keyframe. Finishing the recording appends an index of where
+ * each frame and keyframe lies.
+ *
+ * Readers map the whole file with map_file(), and rebuild any frame from the
+ * keyframe before it and the changes of the frames in between, going on
+ * from the frame last rebuilt instead when that is closer. Frames are read
+ * latest first, so each chunk is copied once, from the last frame changing
+ * it, and hashed once, however many frames apart. Every frame holds
+ * the world hash the sandbox had when it was recorded, which the rebuilt
+ * frame is checked against. Recordings left unfinished, such as by a crash,
+ * have no index, and are read up to their last whole frame instead.
+ *
+ * Recordings start with the 4 bytes "SREC" and RECORDING_VERSION, followed
+ * by the height, width, seed and RNG period of the sandbox. Each frame is
+ * then either:
+ *
+ * 1. The tag "KEYF", the frame's SANDBOX_LIFETIME and world hash, and every
+ *    tile, row by row.
+ * 2. The tag "DELT", the frame's SANDBOX_LIFETIME and world hash, the
+ *    number of chunks changed, and the index of each, counting chunks row by
+ *    row. The tiles of each chunk follow in the same order, row by row,
+ *    clipped to the sandbox.
+ *
+ * Finished recordings then have the tag "INDX", the number of frames and of
+ * keyframes, the offset of each frame within the file, and the number of
+ * each keyframe, ending with the offset of "INDX" itself. Numbers are little
+ * endian, with 8 bytes for world hashes and offsets, and 4 bytes otherwise.
+ *
+ */
+
+#include "sandbox.h"
+#include "save.h"
+
+// Version of the recording format written, and the only one read.
+#define RECORDING_VERSION 1
+
+// Frames between keyframes, bounding how many frames of changes a reader
+// applies to reach any frame.
+#define RECORDING_KEYFRAME_INTERVAL 300
+
+// Number of chunk records the change feed of a recorded sandbox holds, per
+// chunk of the sandbox.
+#define RECORDING_FEED_RECORDS_PER_CHUNK 2
+
+
+// A writer appending the frames of one sandbox to one recording.
+struct RecordingWriter;
+
+
+// A recording opened to rebuild its frames.
+struct Recording
+{
+    unsigned int height;
+    unsigned int width;
+
+    // Values of SANDBOX_SEED and SANDBOX_RNG_PERIOD while recording.
+    unsigned int seed;
+    unsigned int rng_period;
+
+    unsigned int num_frames;
+
+    // Sandbox holding the frame last sought to, and its number, along with
+    // the value SANDBOX_LIFETIME had for it.
+    unsigned char **sandbox;
+    unsigned int frame;
+    unsigned int lifetime;
+
+    // Whole recording, mapped, and its size in bytes.
+    unsigned char *file;
+    size_t file_size;
+
+    // Offset of each frame within the file, and number of each keyframe, in
+    // order.
+    unsigned long long *frame_offsets;
+    unsigned int *keyframes;
+    unsigned int num_keyframes;
+
+    // Whether each chunk of the sandbox was written to during the seek in
+    // progress, and is yet to be hashed again.
+    bool *stale_chunks;
+    unsigned int num_chunks;
+};
+
+
+/*
+ * Start recording a sandbox to a new file, replacing any existing one, with
+ * its current tiles as the first frame.
+ *
+ * The sandbox is given a change feed of chunks, replacing any feed it had.
+ *
+ * @param path - Path of file to write.
+ * @param sandbox - Sandbox to record.
+ * @param height, width - Dimensions of sandbox.
+ *
+ * @return - Newly created writer, or NULL if the file could not be written.
+ */
+struct RecordingWriter *start_recording(const char *path,
+        unsigned char **sandbox,
+        unsigned int height,
+        unsigned int width);
+
+
+/*
+ * Append the frame the sandbox just completed to its recording.
+ *
+ * Must be called after every completed frame, while no frame is in progress.
+ *
+ * @param writer - Writer of sandbox's recording.
+ *
+ * @return - True if the frame was written, false otherwise, in which case
+ * the recording is left unfinished and nothing more is written.
+ */
+bool record_frame(struct RecordingWriter *writer);
+
+
+/*
+ * Append the index of a recording, and free its writer, removing the change
+ * feed it gave its sandbox.
+ *
+ * @param writer - Writer to finish.
+ *
+ * @return - True if the whole recording was written, false otherwise.
+ */
+bool finish_recording(struct RecordingWriter *writer);
+
+
+/*
+ * Open a recording to seek through, holding its first frame.
+ *
+ * The file must not change while the recording is open.
+ *
+ * @param path - Path of file to open.
+ *
+ * @return - Newly opened recording, or NULL if the file could not be read or
+ * holds no frames.
+ */
+struct Recording *open_recording(const char *path);
+
+
+/*
+ * Rebuild a frame of a recording in its sandbox.
+ *
+ * @param recording - Recording to seek through.
+ * @param frame - Number of frame to rebuild, counting from 0.
+ *
+ * @return - True if the frame was rebuilt and matches its recorded world
+ * hash, false if the frame does not exist, or is damaged and may be shown
+ * wrong.
+ */
+bool seek_recording(struct Recording *recording, unsigned int frame);
+
+
+/*
+ * Close a recording, freeing its sandbox.
+ *
+ * @param recording - Recording to close.
+ */
+void close_recording(struct Recording *recording);
+
+
+#endif
@@ -0,0 +1,73 @@
+/*
+ * Headless runner replaying slow frames written out by the flight recorder,
+ * without any window, so they can be run under a profiler.
+ *
+ * Usage: replay FILE [REPEATS] [OUTPUT]
+ *
+ * The frame held by FILE is replayed REPEATS times, 1 by default, printing
+ * the time taken by each and failing if any ends differently than the
+ * original frame did. If OUTPUT is given, the sandbox as of the end of the
+ * frame is saved to it.
+ *
+ */
+
+#include "flight_recorder.h"
+
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "Usage: %s FILE [REPEATS] [OUTPUT]\n", argv[0]);
+        return 1;
+    }
+
+    char *path = argv[1];
+    int repeats = argc > 2 ? atoi(argv[2]) : 1;
+    char *output_path = argc > 3 ? argv[3] : NULL;
+
+    if (!print_flight_record_timings(path, stdout))
+    {
+        fprintf(stderr, "%s holds no flight record\n", path);
+        return 1;
+    }
+
+    unsigned long long expected_hash;
+    bool has_hash = get_flight_record_hash(path, &expected_hash);
+    int status = 0;
+
+    for (int i = 0; i < repeats; i++)
+    {
+        unsigned int height;
+        unsigned int width;
+        double elapsed_ms;
+
+        // Loading restores the RNG state, so every repeat replays the same
+        // frame.
+        unsigned char **sandbox = replay_flight_record(path, &height, &width, &elapsed_ms);
+
+        if (sandbox == NULL)
+        {
+            fprintf(stderr, "Could not replay %s\n", path);
+            return 1;
+        }
+
+        printf("Replayed frame %u of %ux%u sandbox in %.3f ms\n", SANDBOX_LIFETIME - 1, width, height, elapsed_ms);
+
+        if (has_hash && get_world_hash(sandbox) != expected_hash)
+        {
+            fprintf(stderr, "Replay ended with world hash %016llx, but the frame ended with %016llx\n",
+                    get_world_hash(sandbox), expected_hash);
+            status = 1;
+        }
+
+        if (output_path != NULL && i == repeats - 1 && !save_sandbox(output_path, sandbox, height, width))
+        {
+            fprintf(stderr, "Could not write %s\n", output_path);
+        }
+
+        sandbox_free(sandbox, height, width);
+    }
+
+    return status;
+}
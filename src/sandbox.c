@@ -1,7 +1,7 @@
 /*
  * Tiles have the following 4 bit flags, starting from most significant bit:
  *
- * 1. Update - If the tile has already been updated in the current update pass.
+ * 1. (UNUSED) - Tiles updated during the current pass are tracked per chunk.
  * 2. Static - If the tile is set to not be updated due to reaching rest.
  * 3. (UNUSED)
  * 4. (UNUSED)
@@ -19,16 +19,361 @@
  */
 
 #include "sandbox.h"
+#include "chunk_cache.h"
 
 // Lifetime begins at 0 frames and 0 seconds.
 unsigned int SANDBOX_LIFETIME = 0;
 
+unsigned int SANDBOX_SEED = 0;
+
+unsigned int SANDBOX_RNG_PERIOD = SANDBOX_UNBOUNDED_RNG_PERIOD;
+
+// Scratch space for settling, kept between settles.
+static struct Arena SCRATCH = {MEMORY_PLANES};
+
+static const char *STOP_REASON_NAMES[NUM_STOP_REASONS] =
+{
+    "predicate",
+    "settled",
+    "few_active_tiles",
+    "max_frames",
+    "time_limit"
+};
+
 
 // ----- STATIC/PRIVATE FUNCTIONS -----
 
 
 /*
- * Swap the tiles located at the two coordinates within sandbox.
+ * Return the chunk containing the tile at the given coordinates, along with
+ * the bit for that tile within the chunk's moved_tiles.
+ *
+ * @param info - Bookkeeping of sandbox containing tile.
+ * @param row_index, column_index - Coordinates of tile.
+ * @param bit_index - Set to the index of the tile's bit within its chunk.
+ *
+ * @return - Pointer to chunk containing the tile.
+ */
+static struct Chunk *_get_tile_chunk(struct SandboxInfo *info,
+        unsigned int row_index,
+        unsigned int column_index,
+        unsigned int *bit_index)
+{
+    unsigned int chunk_index = (row_index / CHUNK_SIZE) * info -> chunk_columns + column_index / CHUNK_SIZE;
+    *bit_index = (row_index % CHUNK_SIZE) * CHUNK_SIZE + column_index % CHUNK_SIZE;
+
+    return &info -> chunks[chunk_index];
+}
+
+
+/*
+ * Return whether the tile at the given coordinates has been moved during the
+ * current frame, and so must not be updated again until the next.
+ *
+ * @param info - Bookkeeping of sandbox containing tile.
+ * @param row_index, column_index - Coordinates of tile.
+ *
+ * @return - True if the tile has moved this frame, false otherwise.
+ */
+static bool _is_tile_moved(struct SandboxInfo *info, unsigned int row_index, unsigned int column_index)
+{
+    unsigned int bit_index;
+    struct Chunk *chunk = _get_tile_chunk(info, row_index, column_index, &bit_index);
+
+    // Bits left over from an earlier frame are stale, and count as unset.
+    if (chunk -> frame_stamp != SANDBOX_LIFETIME)
+    {
+        return false;
+    }
+
+    return (chunk -> moved_tiles[bit_index / 8] >> (bit_index % 8)) & 1;
+}
+
+
+/*
+ * Wake the tile at the given coordinates and the tiles next to it, so sparse
+ * chunks visit them again.
+ *
+ * @param info - Bookkeeping of sandbox containing tile.
+ * @param row_index, column_index - Coordinates of changed tile.
+ */
+static void _wake_tiles_around(struct SandboxInfo *info, unsigned int row_index, unsigned int column_index)
+{
+    unsigned int row_first = row_index > 0 ? row_index - 1 : 0;
+    unsigned int row_last = row_index + 1 < info -> height ? row_index + 1 : row_index;
+    unsigned int column_first = column_index > 0 ? column_index - 1 : 0;
+    unsigned int column_last = column_index + 1 < info -> width ? column_index + 1 : column_index;
+
+    for (unsigned int row = row_first; row <= row_last; row++)
+    {
+        for (unsigned int col = column_first; col <= column_last; col++)
+        {
+            unsigned int bit_index;
+            struct Chunk *chunk = _get_tile_chunk(info, row, col, &bit_index);
+
+            chunk -> woken_tiles[bit_index / 8] |= 1 << (bit_index % 8);
+        }
+    }
+}
+
+
+/*
+ * Record that the tile at the given coordinates has moved during the current
+ * frame, waking it and its neighbours.
+ *
+ * @param info - Bookkeeping of sandbox containing tile.
+ * @param row_index, column_index - Coordinates of tile.
+ */
+static void _mark_tile_moved(struct SandboxInfo *info, unsigned int row_index, unsigned int column_index)
+{
+    unsigned int bit_index;
+    struct Chunk *chunk = _get_tile_chunk(info, row_index, column_index, &bit_index);
+
+    // The first tile to move in a chunk each frame clears out stale bits.
+    if (chunk -> frame_stamp != SANDBOX_LIFETIME)
+    {
+        memset(chunk -> moved_tiles, 0, sizeof(chunk -> moved_tiles));
+        chunk -> frame_stamp = SANDBOX_LIFETIME;
+    }
+
+    chunk -> moved_tiles[bit_index / 8] |= 1 << (bit_index % 8);
+
+    _wake_tiles_around(info, row_index, column_index);
+}
+
+
+/*
+ * Count the tiles of a chunk that have moved during the current frame.
+ *
+ * @param chunk - Chunk to count moved tiles of.
+ *
+ * @return - Number of moved tiles within chunk.
+ */
+static unsigned int _count_moved_tiles(const struct Chunk *chunk)
+{
+    if (chunk -> frame_stamp != SANDBOX_LIFETIME)
+    {
+        return 0;
+    }
+
+    unsigned int count = 0;
+
+    for (unsigned int i = 0; i < sizeof(chunk -> moved_tiles); i++)
+    {
+        // Clear the lowest set bit until none are left.
+        for (unsigned char bits = chunk -> moved_tiles[i]; bits != 0; bits &= bits - 1)
+        {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+
+/*
+ * Forget about every tile moved so far in the sandbox's current frame.
+ *
+ * @param sandbox - Sandbox whose chunks to clear.
+ */
+static void _clear_moved_tiles(unsigned char **sandbox)
+{
+    struct SandboxInfo *info = get_sandbox_info(sandbox);
+    unsigned int num_chunks = info -> chunk_rows * info -> chunk_columns;
+
+    // Stamping every chunk with a frame other than the current one makes all
+    // of their bits stale.
+    for (unsigned int i = 0; i < num_chunks; i++)
+    {
+        info -> chunks[i].frame_stamp = SANDBOX_LIFETIME - 1;
+    }
+}
+
+
+/*
+ * Make every consumer of the sandbox's change feed treat the whole sandbox as
+ * changed, for changes too large to record one by one.
+ *
+ * @param info - Bookkeeping of sandbox with a change feed.
+ */
+static void _mark_changes_dirty(struct SandboxInfo *info)
+{
+    // Skipping a record number leaves every cursor before it behind.
+    info -> change_feed -> head++;
+    info -> change_feed -> dirty_since = info -> change_feed -> head;
+}
+
+
+/*
+ * Wake every tile of the sandbox after it changed in bulk, and make any
+ * change feed's consumers treat the whole sandbox as changed.
+ *
+ * @param info - Bookkeeping of sandbox to wake.
+ */
+static void _wake_every_tile(struct SandboxInfo *info)
+{
+    unsigned int num_chunks = info -> chunk_rows * info -> chunk_columns;
+
+    if (info -> change_feed != NULL)
+    {
+        _mark_changes_dirty(info);
+    }
+
+    for (unsigned int i = 0; i < num_chunks; i++)
+    {
+        memset(info -> chunks[i].woken_tiles, 0xFF, sizeof(info -> chunks[i].woken_tiles));
+    }
+}
+
+
+/*
+ * Compute the hash of a chunk anew from its tiles, updating the world hash
+ * to match.
+ *
+ * @param sandbox - Sandbox containing chunk.
+ * @param chunk_row, chunk_column - Coordinates of chunk, in chunks.
+ */
+static void _rehash_chunk(unsigned char **sandbox, unsigned int chunk_row, unsigned int chunk_column)
+{
+    struct SandboxInfo *info = get_sandbox_info(sandbox);
+    struct Chunk *chunk = &info -> chunks[chunk_row * info -> chunk_columns + chunk_column];
+
+    unsigned int row_start = chunk_row * CHUNK_SIZE;
+    unsigned int column_start = chunk_column * CHUNK_SIZE;
+    unsigned int row_end = row_start + CHUNK_SIZE < info -> height ? row_start + CHUNK_SIZE : info -> height;
+    unsigned int column_end = column_start + CHUNK_SIZE < info -> width ? column_start + CHUNK_SIZE : info -> width;
+
+    unsigned long long hash = 0;
+
+    for (unsigned int row = row_start; row < row_end; row++)
+    {
+        for (unsigned int col = column_start; col < column_end; col++)
+        {
+            hash ^= get_tile_key((unsigned long) row * info -> width + col, sandbox[row][col]);
+        }
+    }
+
+    info -> world_hash ^= chunk -> hash ^ hash;
+    chunk -> hash = hash;
+    chunk -> modified_epoch = info -> state_epoch;
+}
+
+
+/*
+ * Copy the tiles of a chunk from one block of every tile in the sandbox to
+ * another.
+ *
+ * @param info - Bookkeeping of sandbox containing chunk.
+ * @param chunk_index - Index of chunk, counting row by row.
+ * @param source, destination - Blocks of tiles to copy from and into.
+ *
+ * @return - Number of bytes copied.
+ */
+static unsigned int _copy_chunk_tiles(struct SandboxInfo *info,
+        unsigned int chunk_index,
+        const unsigned char *source,
+        unsigned char *destination)
+{
+    unsigned int row_start = chunk_index / info -> chunk_columns * CHUNK_SIZE;
+    unsigned int column_start = chunk_index % info -> chunk_columns * CHUNK_SIZE;
+    unsigned int row_end = row_start + CHUNK_SIZE < info -> height ? row_start + CHUNK_SIZE : info -> height;
+    unsigned int column_end = column_start + CHUNK_SIZE < info -> width ? column_start + CHUNK_SIZE : info -> width;
+
+    for (unsigned int row = row_start; row < row_end; row++)
+    {
+        size_t offset = (size_t) row * info -> width + column_start;
+        memcpy(destination + offset, source + offset, column_end - column_start);
+    }
+
+    return (row_end - row_start) * (column_end - column_start);
+}
+
+
+/*
+ * Record a change within a chunk in a change feed of chunks, unless the chunk
+ * was already recorded during the current frame.
+ *
+ * @param feed - Change feed with a granularity of chunks.
+ * @param chunk - Chunk that changed.
+ * @param chunk_row, chunk_column - Coordinates of chunk, in chunks.
+ */
+static void _record_chunk_change(struct ChangeFeed *feed,
+        struct Chunk *chunk,
+        unsigned int chunk_row,
+        unsigned int chunk_column)
+{
+    // Offset by one, so freshly allocated chunks are not already stamped
+    // during frame 0.
+    if (chunk -> change_stamp == SANDBOX_LIFETIME + 1)
+    {
+        return;
+    }
+
+    chunk -> change_stamp = SANDBOX_LIFETIME + 1;
+
+    feed -> records[feed -> head % feed -> capacity] = (struct TileChange) {chunk_row, chunk_column, AIR, AIR};
+    feed -> head++;
+}
+
+
+/*
+ * Account for a change of the tile at the given coordinates, updating the
+ * hashes of its chunk and of the world, and recording it in the sandbox's
+ * change feed if it has one.
+ *
+ * @param info - Bookkeeping of sandbox containing tile.
+ * @param row_index, column_index - Coordinates of tile.
+ * @param old_tile, new_tile - Tile before and after the change.
+ */
+static void _record_change(struct SandboxInfo *info,
+        unsigned int row_index,
+        unsigned int column_index,
+        unsigned char old_tile,
+        unsigned char new_tile)
+{
+    if (old_tile == new_tile)
+    {
+        return;
+    }
+
+    unsigned int bit_index;
+    struct Chunk *chunk = _get_tile_chunk(info, row_index, column_index, &bit_index);
+
+    // XOR-ing out the old key and in the new one is all it takes.
+    unsigned long tile_index = (unsigned long) row_index * info -> width + column_index;
+    unsigned long long key_change = get_tile_key(tile_index, old_tile) ^ get_tile_key(tile_index, new_tile);
+
+    chunk -> hash ^= key_change;
+    chunk -> modified_epoch = info -> state_epoch;
+    info -> world_hash ^= key_change;
+
+    struct ChangeFeed *feed = info -> change_feed;
+
+    if (feed == NULL)
+    {
+        return;
+    }
+
+    if (feed -> granularity == CHANGES_CHUNKS)
+    {
+        _record_chunk_change(feed, chunk, row_index / CHUNK_SIZE, column_index / CHUNK_SIZE);
+        return;
+    }
+
+    struct TileChange *change = &feed -> records[feed -> head % feed -> capacity];
+
+    change -> row = row_index;
+    change -> column = column_index;
+    change -> old_tile = old_tile;
+    change -> new_tile = new_tile;
+
+    feed -> head++;
+}
+
+
+/*
+ * Swap the tiles located at the two coordinates within sandbox, marking both
+ * as moved for the current frame.
  *
  * @param row_one, column_one - Coordinates of first tile.
  * @param row_two, column_two - Coordinates of second tile.
@@ -44,27 +389,57 @@ static void _swap_tiles(unsigned int row_one,
     unsigned char temp = sandbox[row_one][column_one];
     sandbox[row_one][column_one] = sandbox[row_two][column_two];
     sandbox[row_two][column_two] = temp;
+
+    struct SandboxInfo *info = get_sandbox_info(sandbox);
+    _mark_tile_moved(info, row_one, column_one);
+    _mark_tile_moved(info, row_two, column_two);
+
+    _record_change(info, row_one, column_one, temp, sandbox[row_one][column_one]);
+    _record_change(info, row_two, column_two, sandbox[row_one][column_one], temp);
+
+    info -> frame_stats.swaps++;
 }
 
 
 /*
- * Flip a coin pseudo-randomly, generating either heads or tails.
+ * Scramble the bits of the given value, such that nearby inputs produce
+ * unrelated outputs.
  *
- * This function is not seeded, and will always generate the same sequence.
+ * @param value - Value to scramble.
  *
- * @return - 1 for heads, 0 for tails.
+ * @return - Scrambled value.
  */
-static bool _flip_coin(void)
+static unsigned int _mix_bits(unsigned int value)
 {
-    // Generate a random number between 0 and 1.
-    float random_value = rand() / (float) RAND_MAX;
+    // Finalizer of MurmurHash3.
+    value ^= value >> 16;
+    value *= 0x85ebca6b;
+    value ^= value >> 13;
+    value *= 0xc2b2ae35;
+    value ^= value >> 16;
+
+    return value;
+}
 
-    if (random_value > 0.5)
-    {
-        return 1;
-    }
 
-    return 0;
+/*
+ * Flip a coin pseudo-randomly for the tile at the given coordinates,
+ * generating either heads or tails.
+ *
+ * The outcome depends only on the current frame's RNG key and the given
+ * coordinates, so processing the same tiles in the same frame always flips
+ * the same way.
+ *
+ * @param row_index, column_index - Coordinates of tile flipping the coin.
+ *
+ * @return - 1 for heads, 0 for tails.
+ */
+static bool _flip_coin(unsigned int row_index, unsigned int column_index)
+{
+    unsigned int key = get_rng_key(SANDBOX_LIFETIME);
+    unsigned int random_value = _mix_bits(key ^ _mix_bits(row_index * 0x9e3779b9 ^ column_index));
+
+    return random_value & 1;
 }
 
 
@@ -155,280 +530,2405 @@ static bool _tile_has_flow(unsigned char tile)
  */
 static bool _tile_has_lift(unsigned char tile)
 {
-    unsigned char tile_type = get_tile_id(tile);
+    unsigned char tile_type = get_tile_id(tile);
+
+    switch (tile_type)
+    {
+        // Air refers to the empty tile, it does not receive lift.
+        case AIR:
+            return false;
+
+        case SAND:
+            return false;
+
+        case WATER:
+            return false;
+
+        case WOOD:
+            return false;
+
+        case STEAM:
+            return true;
+
+        case FIRE:
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+
+/*
+ * Return whether or not a tile is "solid".
+ *
+ * A tile is considered solid if it capable of acting as a "floor".
+ * Intuitively, this means you could sensibly stand on the tile.
+ *
+ * For example, air is not solid, but sand is. Fire is not solid, but wood is.
+ *
+ */
+static bool _is_solid(unsigned char tile)
+{
+    unsigned char tile_type = get_tile_id(tile);
+
+    switch (tile_type)
+    {
+        case AIR:
+            return false;
+
+        case SAND:
+            return true;
+
+        case WATER:
+            return true;
+
+        case WOOD:
+            return true;
+
+        case STEAM:
+            return false;
+
+        case FIRE:
+            return false;
+
+        default:
+            return false;
+    }
+}
+
+
+/*
+ * Return whether the given tile settles like a grain, falling into a pile.
+ *
+ * @param tile - Tile to check.
+ *
+ * @return - True for tiles with gravity that don't flow, false otherwise.
+ */
+static bool _is_granular(unsigned char tile)
+{
+    return _tile_has_gravity(tile) && !_tile_has_flow(tile);
+}
+
+
+/*
+ * Return whether the given tile never moves on its own, like wood.
+ *
+ * @param tile - Tile to check.
+ *
+ * @return - True for non-air tiles without gravity, flow or lift.
+ */
+static bool _is_fixed(unsigned char tile)
+{
+    return get_tile_id(tile) != AIR
+        && !_tile_has_gravity(tile)
+        && !_tile_has_flow(tile)
+        && !_tile_has_lift(tile);
+}
+
+
+/*
+ * Compact a single column of the sandbox, such that within every stretch of
+ * the column between fixed tiles, granular tiles sit at the bottom and gases
+ * at the top, with the remaining tiles between them in their original order.
+ *
+ * Helper function to settle_sandbox.
+ *
+ * @param sandbox - Sandbox to mutate by compacting a column.
+ * @param height - Height of given sandbox.
+ * @param column_index - Column to compact.
+ * @param grains, others - Scratch buffers of at least height tiles each.
+ */
+static void _compact_column(unsigned char **sandbox,
+        unsigned int height,
+        unsigned int column_index,
+        unsigned char *grains,
+        unsigned char *others)
+{
+    unsigned int segment_bottom = height;
+
+    while (segment_bottom > 0)
+    {
+        unsigned int num_grains = 0;
+        unsigned int num_others = 0;
+        unsigned int num_gases = 0;
+        unsigned int row = segment_bottom;
+
+        // Gather tiles upwards until hitting a fixed tile or the top.
+        // Gases are kept at the back of the others buffer, in reverse.
+        while (row > 0 && !_is_fixed(sandbox[row - 1][column_index]))
+        {
+            row--;
+            unsigned char tile = sandbox[row][column_index];
+
+            if (_is_granular(tile))
+            {
+                grains[num_grains++] = tile;
+            }
+            else if (_tile_has_lift(tile) && !_tile_has_gravity(tile))
+            {
+                others[height - 1 - num_gases++] = tile;
+            }
+            else
+            {
+                others[num_others++] = tile;
+            }
+        }
+
+        // Lay the stretch back down, grains first and gases last.
+        unsigned int write_row = segment_bottom;
+
+        for (unsigned int i = 0; i < num_grains; i++)
+        {
+            sandbox[--write_row][column_index] = grains[i];
+        }
+
+        for (unsigned int i = 0; i < num_others; i++)
+        {
+            sandbox[--write_row][column_index] = others[i];
+        }
+
+        for (unsigned int i = 0; i < num_gases; i++)
+        {
+            sandbox[--write_row][column_index] = others[height - 1 - i];
+        }
+
+        // Step over the fixed tile ending this stretch, if any.
+        segment_bottom = row > 0 ? row - 1 : 0;
+    }
+}
+
+
+/*
+ * Let the granular tile at the given coordinates tumble until it comes to
+ * rest, by falling straight down or sliding diagonally down into air, in the
+ * same way do_gravity() moves it a tile at a time.
+ *
+ * Helper function to settle_sandbox.
+ *
+ * @param sandbox - Sandbox to mutate by moving the tile.
+ * @param height, width - Dimensions of given sandbox.
+ * @param row_index, column_index - Coordinates of granular tile to topple.
+ */
+static void _topple_grain(unsigned char **sandbox,
+        unsigned int height,
+        unsigned int width,
+        unsigned int row_index,
+        unsigned int column_index)
+{
+    while (row_index + 1 < height)
+    {
+        unsigned int next_row = row_index + 1;
+        unsigned char below_type = get_tile_id(sandbox[next_row][column_index]);
+
+        if (below_type == AIR || below_type == WATER)
+        {
+            _swap_tiles(row_index, column_index, next_row, column_index, sandbox);
+            row_index = next_row;
+            continue;
+        }
+
+        unsigned int left_column = column_index - 1;
+        unsigned int right_column = column_index + 1;
+
+        bool can_slide_left = left_column != -1 && get_tile_id(sandbox[next_row][left_column]) == AIR;
+        bool can_slide_right = right_column != width && get_tile_id(sandbox[next_row][right_column]) == AIR;
+
+        if (can_slide_left && can_slide_right)
+        {
+            can_slide_left = _flip_coin(row_index, column_index);
+        }
+
+        if (can_slide_left)
+        {
+            _swap_tiles(row_index, column_index, next_row, left_column, sandbox);
+            column_index = left_column;
+        }
+        else if (can_slide_right)
+        {
+            _swap_tiles(row_index, column_index, next_row, right_column, sandbox);
+            column_index = right_column;
+        }
+        else
+        {
+            return;
+        }
+
+        row_index = next_row;
+    }
+}
+
+
+/*
+ * Progress of pouring connected bodies of liquid or gas back into the
+ * sandbox, one body at a time, during settle_sandbox().
+ *
+ * Each body pours into a pool: the cells it can reach and the cells open to
+ * fill among them. A body reaching another pool joins it, so every cell is
+ * only reached once, however many bodies end up in the same place.
+ *
+ * Depths count rows downwards for liquids and upwards for gases, so the same
+ * code pours either, and the deepest open cell is always the next to fill.
+ */
+struct Pour
+{
+    unsigned char **sandbox;
+    unsigned int height;
+    unsigned int width;
+    bool is_gas;
+
+    // Pool being poured into, and the pool each cell was reached by. Pools
+    // that were joined point to the pool they joined, through pool_parents.
+    unsigned int pool;
+    unsigned int *reached;
+    unsigned int *pool_parents;
+    unsigned int *stack;
+
+    // Every pool keeps the open cells it reached, and the cells it filled
+    // but has not yet risen above, in heaps with the deepest cell on top.
+    // Heaps hold cell indices plus one, leaving 0 for an empty heap.
+    unsigned int *open_roots;
+    unsigned int *filled_roots;
+    unsigned int *heap_lefts;
+    unsigned int *heap_rights;
+    unsigned char *heap_ranks;
+};
+
+
+/*
+ * Return whether the given tile is a gas, rising through the air.
+ *
+ * @param tile - Tile to check.
+ *
+ * @return - True for tiles with lift but no gravity.
+ */
+static bool _is_gas(unsigned char tile)
+{
+    return _tile_has_lift(tile) && !_tile_has_gravity(tile);
+}
+
+
+/*
+ * Return whether the given tile belongs to what is being poured.
+ *
+ * Helper function to settle_sandbox.
+ *
+ * @param pour - Pour in progress.
+ * @param tile - Tile to check.
+ *
+ * @return - True for gases while pouring gases, and liquids otherwise.
+ */
+static bool _is_poured(const struct Pour *pour, unsigned char tile)
+{
+    return pour -> is_gas ? _is_gas(tile) : _tile_has_flow(tile);
+}
+
+
+/*
+ * Return whether what is being poured may pass through the given tile,
+ * which it may for air and its own kind. Gases also bubble up through
+ * liquids.
+ *
+ * Helper function to settle_sandbox.
+ *
+ * @param pour - Pour in progress.
+ * @param tile - Tile to check.
+ *
+ * @return - True if the tile can be passed through.
+ */
+static bool _is_passable(const struct Pour *pour, unsigned char tile)
+{
+    return get_tile_id(tile) == AIR
+        || _is_poured(pour, tile)
+        || (pour -> is_gas && _tile_has_flow(tile));
+}
+
+
+/*
+ * Return the depth of the given cell, for what is being poured.
+ *
+ * Helper function to settle_sandbox.
+ *
+ * @param pour - Pour in progress.
+ * @param cell - Index of cell to measure.
+ *
+ * @return - Row counted from the top for liquids, or the bottom for gases.
+ */
+static unsigned int _get_pour_depth(const struct Pour *pour, unsigned int cell)
+{
+    unsigned int row = cell / pour -> width;
+
+    return pour -> is_gas ? pour -> height - 1 - row : row;
+}
+
+
+/*
+ * Merge two heaps of cells, keeping the deepest cell on top. Heaps are
+ * leftist, so merging takes time logarithmic in their sizes.
+ *
+ * Helper function to settle_sandbox.
+ *
+ * @param pour - Pour the heaps belong to.
+ * @param one, other - Roots of heaps to merge.
+ *
+ * @return - Root of merged heap.
+ */
+static unsigned int _merge_heaps(struct Pour *pour, unsigned int one, unsigned int other)
+{
+    if (one == 0 || other == 0)
+    {
+        return one + other;
+    }
+
+    if (_get_pour_depth(pour, other - 1) > _get_pour_depth(pour, one - 1))
+    {
+        unsigned int deeper = other;
+        other = one;
+        one = deeper;
+    }
+
+    unsigned int cell = one - 1;
+    unsigned int left = pour -> heap_lefts[cell];
+    unsigned int right = _merge_heaps(pour, pour -> heap_rights[cell], other);
+
+    unsigned char left_rank = left == 0 ? 0 : pour -> heap_ranks[left - 1];
+    unsigned char right_rank = pour -> heap_ranks[right - 1];
+
+    if (left_rank < right_rank)
+    {
+        pour -> heap_lefts[cell] = right;
+        pour -> heap_rights[cell] = left;
+        pour -> heap_ranks[cell] = left_rank + 1;
+    }
+    else
+    {
+        pour -> heap_lefts[cell] = left;
+        pour -> heap_rights[cell] = right;
+        pour -> heap_ranks[cell] = right_rank + 1;
+    }
+
+    return one;
+}
+
+
+/*
+ * Add a cell to a heap.
+ *
+ * Helper function to settle_sandbox.
+ *
+ * @param pour - Pour the heap belongs to.
+ * @param root - Root of heap, updated to the root after adding.
+ * @param cell - Index of cell to add, which must not be in any heap.
+ */
+static void _push_heap(struct Pour *pour, unsigned int *root, unsigned int cell)
+{
+    pour -> heap_lefts[cell] = 0;
+    pour -> heap_rights[cell] = 0;
+    pour -> heap_ranks[cell] = 1;
+
+    *root = _merge_heaps(pour, *root, cell + 1);
+}
+
+
+/*
+ * Remove the deepest cell from a heap.
+ *
+ * Helper function to settle_sandbox.
+ *
+ * @param pour - Pour the heap belongs to.
+ * @param root - Root of non-empty heap, updated to the root after removing.
+ *
+ * @return - Index of removed cell.
+ */
+static unsigned int _pop_heap(struct Pour *pour, unsigned int *root)
+{
+    unsigned int cell = *root - 1;
+    *root = _merge_heaps(pour, pour -> heap_lefts[cell], pour -> heap_rights[cell]);
+
+    return cell;
+}
+
+
+/*
+ * Return the pool the given pool has joined, if any.
+ *
+ * Helper function to settle_sandbox.
+ *
+ * @param pour - Pour in progress.
+ * @param pool - Pool to look up.
+ *
+ * @return - Pool that has not joined any other.
+ */
+static unsigned int _find_pool(struct Pour *pour, unsigned int pool)
+{
+    unsigned int joined = pool;
+
+    while (pour -> pool_parents[joined] != joined)
+    {
+        joined = pour -> pool_parents[joined];
+    }
+
+    // Point everything along the way straight at it for next time.
+    while (pour -> pool_parents[pool] != joined)
+    {
+        unsigned int parent = pour -> pool_parents[pool];
+        pour -> pool_parents[pool] = joined;
+        pool = parent;
+    }
+
+    return joined;
+}
+
+
+/*
+ * Mark the given cell as reached by the pool being poured into, unless it
+ * cannot be passed through or was reached already. A cell reached by another
+ * pool has that pool join this one, taking everything it reached along.
+ *
+ * Helper function to settle_sandbox.
+ *
+ * @param pour - Pour in progress.
+ * @param cell - Index of cell to reach, or past the sandbox to do nothing.
+ *
+ * @return - True if the cell was newly reached.
+ */
+static bool _claim_cell(struct Pour *pour, unsigned int cell)
+{
+    unsigned int width = pour -> width;
+    unsigned int pool = pour -> pool;
+
+    if (cell >= pour -> height * width || !_is_passable(pour, pour -> sandbox[cell / width][cell % width]))
+    {
+        return false;
+    }
+
+    if (pour -> reached[cell] != 0)
+    {
+        unsigned int other = _find_pool(pour, pour -> reached[cell]);
+
+        if (other != pool)
+        {
+            pour -> pool_parents[other] = pool;
+            pour -> open_roots[pool] = _merge_heaps(pour, pour -> open_roots[pool], pour -> open_roots[other]);
+            pour -> filled_roots[pool] = _merge_heaps(pour, pour -> filled_roots[pool], pour -> filled_roots[other]);
+        }
+
+        return false;
+    }
+
+    pour -> reached[cell] = pool;
+    return true;
+}
+
+
+/*
+ * Reach the given cell and everything reachable from it with the pool being
+ * poured into, moving the way its tiles would move one at a time: falling,
+ * sliding sideways over whatever holds them up, and rising through their
+ * own kind to its surface. Empty cells reached become open to fill.
+ *
+ * Helper function to settle_sandbox.
+ *
+ * @param pour - Pour in progress.
+ * @param cell - Index of cell to reach, or past the sandbox to do nothing.
+ */
+static void _reach_cell(struct Pour *pour, unsigned int cell)
+{
+    unsigned int height = pour -> height;
+    unsigned int width = pour -> width;
+    unsigned int area = height * width;
+
+    if (!_claim_cell(pour, cell))
+    {
+        return;
+    }
+
+    unsigned int stack_size = 0;
+    pour -> stack[stack_size++] = cell;
+
+    while (stack_size > 0)
+    {
+        cell = pour -> stack[--stack_size];
+        unsigned int row = cell / width;
+        unsigned int col = cell % width;
+        unsigned char tile = pour -> sandbox[row][col];
+
+        if (get_tile_id(tile) == AIR)
+        {
+            _push_heap(pour, &pour -> open_roots[pour -> pool], cell);
+        }
+
+        bool is_at_bottom = pour -> is_gas ? row == 0 : row + 1 == height;
+        bool is_at_top = pour -> is_gas ? row + 1 == height : row == 0;
+        unsigned int below = pour -> is_gas ? cell - width : cell + width;
+        unsigned int above = pour -> is_gas ? cell + width : cell - width;
+        bool is_supported = is_at_bottom || get_tile_id(pour -> sandbox[below / width][below % width]) != AIR;
+
+        // Falling, sliding, and rising through its own kind.
+        unsigned int neighbours[4] = {
+            is_at_bottom ? area : below,
+            is_supported && col > 0 ? cell - 1 : area,
+            is_supported && col + 1 < width ? cell + 1 : area,
+            _is_poured(pour, tile) && !is_at_top ? above : area
+        };
+
+        for (unsigned int i = 0; i < 4; i++)
+        {
+            if (_claim_cell(pour, neighbours[i]))
+            {
+                pour -> stack[stack_size++] = neighbours[i];
+            }
+        }
+    }
+}
+
+
+/*
+ * Fill the deepest open cell of the pool being poured into with the given
+ * tile. The level only rises above filled cells once no open cell as deep
+ * is left, so nothing spills over a brim before the level reaches it.
+ *
+ * Helper function to settle_sandbox.
+ *
+ * @param pour - Pour in progress.
+ * @param tile - Tile to fill the cell with.
+ *
+ * @return - False if no open cell is left.
+ */
+static bool _fill_open_cell(struct Pour *pour, unsigned char tile)
+{
+    unsigned int width = pour -> width;
+    unsigned int area = pour -> height * width;
+    unsigned int *open_root = &pour -> open_roots[pour -> pool];
+    unsigned int *filled_root = &pour -> filled_roots[pour -> pool];
+
+    while (*filled_root != 0
+            && (*open_root == 0
+                || _get_pour_depth(pour, *open_root - 1) < _get_pour_depth(pour, *filled_root - 1)))
+    {
+        // Whatever is above a filled cell can now be reached by rising, and
+        // slide sideways, now that it is held up.
+        unsigned int filled = _pop_heap(pour, filled_root);
+        unsigned int row = filled / width;
+        bool is_at_top = pour -> is_gas ? row + 1 == pour -> height : row == 0;
+
+        if (!is_at_top)
+        {
+            unsigned int above = pour -> is_gas ? filled + width : filled - width;
+
+            _reach_cell(pour, above);
+
+            if (pour -> reached[above] != 0)
+            {
+                _reach_cell(pour, above % width > 0 ? above - 1 : area);
+                _reach_cell(pour, above % width + 1 < width ? above + 1 : area);
+            }
+        }
+    }
+
+    if (*open_root == 0)
+    {
+        return false;
+    }
+
+    unsigned int cell = _pop_heap(pour, open_root);
+    pour -> sandbox[cell / width][cell % width] = tile;
+    _push_heap(pour, filled_root, cell);
+
+    return true;
+}
+
+
+/*
+ * Pour a connected body of liquid or gas back into the sandbox it was lifted
+ * out of, from its own lowest reachable level upwards, so it only spills
+ * into a neighbouring basin once its level reaches the brim between them.
+ * Lower tile IDs are poured first.
+ *
+ * Helper function to settle_sandbox.
+ *
+ * @param pour - Pour in progress.
+ * @param body - Label of the body, naming the pool it starts.
+ * @param cells - Indices of cells the body was lifted out of.
+ * @param tiles - IDs of the tiles lifted out of these cells.
+ * @param size - Number of cells in the body.
+ */
+static void _pour_body(struct Pour *pour,
+        unsigned int body,
+        const unsigned int *cells,
+        const unsigned char *tiles,
+        unsigned int size)
+{
+    unsigned int counts[16] = {0};
+
+    for (unsigned int i = 0; i < size; i++)
+    {
+        counts[tiles[i]]++;
+    }
+
+    pour -> pool = body;
+    pour -> pool_parents[body] = body;
+
+    for (unsigned int i = 0; i < size; i++)
+    {
+        _reach_cell(pour, cells[i]);
+    }
+
+    // Should the body run out of places to go, put what remains in the
+    // deepest empty cells anywhere rather than lose it.
+    unsigned int area = pour -> height * pour -> width;
+    unsigned int next_cell = 0;
+
+    for (unsigned char id = 0; id < 16; id++)
+    {
+        for (unsigned int i = 0; i < counts[id]; i++)
+        {
+            while (!_fill_open_cell(pour, id) && next_cell < area)
+            {
+                unsigned int depth = pour -> height - 1 - next_cell / pour -> width;
+                unsigned int row = pour -> is_gas ? pour -> height - 1 - depth : depth;
+                unsigned char *tile = &pour -> sandbox[row][next_cell % pour -> width];
+                next_cell++;
+
+                if (get_tile_id(*tile) == AIR)
+                {
+                    *tile = id;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+
+/*
+ * Perform a slide on the given tile coordinates within the sandbox, if possible.
+ *
+ * A slide is possible if the tile in question has room to move to the left
+ * or to the right one tile, without going out of bounds.
+ *
+ * If both are possible, perform one at random.
+ *
+ * This function does NOT check under what conditions a tile should slide.
+ *
+ * Helper function to do_liquid_flow and do_lift.
+ *
+ * @param sandbox - Sandbox to potentialyl mutate by moving tiles for sliding.
+ * @param height, width - Dimensions of given sandbox.
+ * @param row_index, column_index - Coordinates of tile to slide.
+ */
+void _slide_left_or_right(unsigned char **sandbox,
+        unsigned int height,
+        unsigned int width,
+        unsigned int row_index,
+        unsigned int column_index)
+{
+    // Gather info about what's to the left and right.
+    unsigned int left_column = column_index - 1;
+    unsigned int right_column = column_index + 1;
+
+    // Test to see where we can move...
+    // Only slide a direction if there's an empty space, and it's not OOB.
+    bool can_slide_left = false;
+    bool can_slide_right = false;
+
+    if (left_column != -1 && get_tile_id(sandbox[row_index][left_column]) == AIR)
+    {
+        can_slide_left = true;
+    }
+
+    if (right_column != width && get_tile_id(sandbox[row_index][right_column]) == AIR)
+    {
+        can_slide_right = true;
+    }
+
+    // If we can flow both directions, choose one at random on a coin flip.
+    if (can_slide_left && can_slide_right)
+    {
+        bool heads = _flip_coin(row_index, column_index);
+
+        if (heads)
+        {
+            _swap_tiles(row_index, column_index, row_index, left_column, sandbox);
+        }
+        else
+        {
+            _swap_tiles(row_index, column_index, row_index, right_column, sandbox);
+        }
+        return;
+    }
+
+    // If only one option is available, do that.
+    if (can_slide_left)
+    {
+        _swap_tiles(row_index, column_index, row_index, left_column, sandbox);
+        return;
+    }
+
+    if (can_slide_right)
+    {
+        _swap_tiles(row_index, column_index, row_index, right_column, sandbox);
+        return;
+    }
+}
+
+
+/*
+ * Return the row a sliding tile leans against as it slides.
+ *
+ * Liquids slide along a floor beneath them, gases slide along a ceiling above
+ * them. The returned row may be out of bounds (equal to height or -1 for
+ * liquids and gases respectively), meaning the edge of the sandbox is the
+ * support.
+ *
+ * @param tile - Tile to find support row of.
+ * @param row_index - Row the tile is located on.
+ * @param is_slider - Set to whether the tile slides at all.
+ *
+ * @return - Row index of the floor or ceiling of the tile.
+ */
+static unsigned int _get_support_row(unsigned char tile, unsigned int row_index, bool *is_slider)
+{
+    *is_slider = true;
+
+    if (_tile_has_flow(tile))
+    {
+        return row_index + 1;
+    }
+
+    if (_tile_has_lift(tile) && !_tile_has_gravity(tile))
+    {
+        return row_index - 1;
+    }
+
+    *is_slider = false;
+    return row_index;
+}
+
+
+/*
+ * Return whether the given sliding tile rests against its support, meaning
+ * sliding left or right is the only move left for it to make.
+ *
+ * For liquids, this means sitting on a solid floor it cannot sink through.
+ * For gases, this means sitting under a solid ceiling it cannot rise through.
+ *
+ * @param tile - Sliding tile to check.
+ * @param support_tile - Tile at the support row, ignored if support is OOB.
+ * @param support_in_bounds - Whether the support row lies inside the sandbox.
+ *
+ * @return - True if the tile can only slide, false otherwise.
+ */
+static bool _is_resting_on_support(unsigned char tile, unsigned char support_tile, bool support_in_bounds)
+{
+    if (!support_in_bounds)
+    {
+        return true;
+    }
+
+    if (!_is_solid(support_tile))
+    {
+        return false;
+    }
+
+    // Gravity sinks non-water tiles through water, and lift rises through it.
+    if (get_tile_id(support_tile) == WATER)
+    {
+        return _tile_has_flow(tile) && get_tile_id(tile) == WATER;
+    }
+
+    return true;
+}
+
+
+/*
+ * Process a horizontal run of identical resting liquid or gas tiles starting
+ * at the given coordinates as a single unit, if possible.
+ *
+ * Sliding tile-by-tile from left to right, the inner tiles of a run never see
+ * air beside them except where a neighbour has just moved, so only the ends of
+ * a run ever change. With air to the left, the whole run shifts left by one.
+ * With air only to the right, the rightmost tile steps out. With air on both
+ * sides, the run shifts left and the last tile picks a side on a coin flip.
+ *
+ * The resulting row segment is written in one go and every tile of the run is
+ * marked as updated.
+ *
+ * @param sandbox - Sandbox to mutate by sliding the run.
+ * @param height, width - Dimensions of given sandbox.
+ * @param row_index, column_index - Coordinates of leftmost tile of the run.
+ * @param column_end - Column the run must end before.
+ *
+ * @return - Number of tiles processed as a run, or 0 if the tile at the given
+ * coordinates must be processed on its own.
+ */
+static unsigned int _slide_run(unsigned char **sandbox,
+        unsigned int height,
+        unsigned int width,
+        unsigned int row_index,
+        unsigned int column_index,
+        unsigned int column_end)
+{
+    struct SandboxInfo *info = get_sandbox_info(sandbox);
+    unsigned char *row = sandbox[row_index];
+    unsigned char run_tile = row[column_index];
+    unsigned char run_type = get_tile_id(run_tile);
+
+    bool is_slider = false;
+    unsigned int support_row = _get_support_row(run_tile, row_index, &is_slider);
+    bool support_in_bounds = support_row != -1 && support_row != height;
+
+    if (!is_slider)
+    {
+        return 0;
+    }
+
+    unsigned char *support = support_in_bounds ? sandbox[support_row] : NULL;
+
+    // Gather the run of identical, unprocessed, resting tiles.
+    unsigned int run_end = column_index;
+
+    while (run_end < column_end)
+    {
+        unsigned char tile = row[run_end];
+
+        if (get_tile_id(tile) != run_type
+                || is_tile_static(tile)
+                || _is_tile_moved(info, row_index, run_end)
+                || !_is_resting_on_support(tile, support_in_bounds ? support[run_end] : 0, support_in_bounds))
+        {
+            break;
+        }
+
+        run_end++;
+    }
+
+    // From here on, run_end is the rightmost tile of the run.
+    if (run_end == column_index)
+    {
+        return 0;
+    }
+    run_end--;
+
+    unsigned int left_column = column_index - 1;
+    unsigned int right_column = run_end + 1;
+
+    // An end tile with open air diagonally across its support would fall or
+    // rise into it, rather than slide. Leave such tiles to be processed alone.
+    bool can_slide_left = left_column != -1 && get_tile_id(row[left_column]) == AIR;
+    bool can_slide_right = right_column != width && get_tile_id(row[right_column]) == AIR;
+
+    if (support_in_bounds && left_column != -1 && get_tile_id(support[left_column]) == AIR)
+    {
+        return 0;
+    }
+
+    if (support_in_bounds && right_column != width && get_tile_id(support[right_column]) == AIR)
+    {
+        if (run_end == column_index)
+        {
+            return 0;
+        }
+
+        run_end--;
+        right_column--;
+        can_slide_right = false;
+    }
+
+    unsigned int run_length = run_end - column_index + 1;
+
+    // Decide where the run ends up. A run with air on both sides first shifts
+    // left, then its last tile chooses again between left and right.
+    bool shift_left = can_slide_left;
+    bool step_right = can_slide_right;
+
+    if (can_slide_left && can_slide_right)
+    {
+        step_right = !_flip_coin(row_index, run_end);
+    }
+
+    info -> frame_stats.swaps += (shift_left ? run_length : 0) + (step_right ? 1 : 0);
+
+    // Tiles in the middle of the run are identical, so shifting the run only
+    // changes tiles at its ends. Only those are written and marked as moved.
+    unsigned char old_left = left_column != -1 ? row[left_column] : AIR;
+    unsigned char old_run_end = row[run_end];
+    unsigned char old_before_end = row[run_end - (run_end > column_index)];
+    unsigned char old_right = right_column != width ? row[right_column] : AIR;
+
+    if (shift_left)
+    {
+        unsigned char air = row[left_column];
+        row[left_column] = run_tile;
+        _mark_tile_moved(info, row_index, left_column);
+
+        if (step_right)
+        {
+            // For a single tile, this undoes the write to the left just above.
+            row[run_end - 1] = air;
+            _mark_tile_moved(info, row_index, run_end - 1);
+        }
+
+        row[run_end] = air;
+        _mark_tile_moved(info, row_index, run_end);
+    }
+
+    if (step_right)
+    {
+        unsigned char air = row[right_column];
+        row[right_column] = run_tile;
+        _mark_tile_moved(info, row_index, right_column);
+
+        row[run_end] = air;
+        _mark_tile_moved(info, row_index, run_end);
+    }
+
+    if (shift_left)
+    {
+        _record_change(info, row_index, left_column, old_left, row[left_column]);
+    }
+
+    if (shift_left && step_right && run_end > column_index)
+    {
+        _record_change(info, row_index, run_end - 1, old_before_end, row[run_end - 1]);
+    }
+
+    _record_change(info, row_index, run_end, old_run_end, row[run_end]);
+
+    if (step_right)
+    {
+        _record_change(info, row_index, right_column, old_right, row[right_column]);
+    }
+
+    return run_length;
+}
+
+
+/*
+ * Simulate the tile at the given coordinates for the current frame, along
+ * with the rest of its run if it starts a run of resting liquid or gas.
+ *
+ * @param sandbox - Sandbox containing tile.
+ * @param height, width - Dimensions of sandbox.
+ * @param chunk - Chunk containing tile.
+ * @param row, col - Coordinates of tile.
+ * @param row_start, column_start - Coordinates of chunk's top left tile.
+ * @param column_end - Column just past the chunk's last.
+ *
+ * @return - Number of tiles of the row handled, starting from the given one.
+ */
+static unsigned int _process_tile(unsigned char **sandbox,
+        unsigned int height,
+        unsigned int width,
+        struct Chunk *chunk,
+        unsigned int row,
+        unsigned int col,
+        unsigned int row_start,
+        unsigned int column_start,
+        unsigned int column_end)
+{
+    unsigned char current_tile = sandbox[row][col];
+    unsigned char tile_type = get_tile_id(current_tile);
+    bool is_static = is_tile_static(current_tile);
+
+    // Do not simulate an empty tile.
+    if (tile_type == AIR)
+    {
+        return 1;
+    }
+
+    // Do not simulate a static tile.
+    if (is_static)
+    {
+        return 1;
+    }
+
+    // Do not simulate a tile that has already moved this frame.
+    // The chunk is known, so its bit is looked up directly.
+    unsigned int bit_index = (row - row_start) * CHUNK_SIZE + (col - column_start);
+
+    if (chunk -> frame_stamp == SANDBOX_LIFETIME && (chunk -> moved_tiles[bit_index / 8] >> (bit_index % 8)) & 1)
+    {
+        return 1;
+    }
+
+    get_sandbox_info(sandbox) -> frame_stats.tiles_visited++;
+
+    // Runs of resting liquid or gas only ever change at their ends,
+    // so process them as one unit rather than tile by tile.
+    unsigned int run_length = _slide_run(sandbox, height, width, row, col, column_end);
+
+    if (run_length > 0)
+    {
+        return run_length;
+    }
+
+    // Tiles are only marked once they move, so tiles at rest are read
+    // without ever being written to.
+
+    // Perform gravity on the tiles that need it.
+    if (_tile_has_gravity(current_tile))
+    {
+        do_gravity(sandbox, height, width, row, col);
+    }
+
+    // Perform flow on tiles that need it.
+    if (_tile_has_flow(current_tile))
+    {
+        do_liquid_flow(sandbox, height, width, row, col);
+    }
+
+    if (_tile_has_lift(current_tile))
+    {
+        do_lift(sandbox, height, width, row, col);
+    }
+
+    return 1;
+}
+
+
+/*
+ * Perform one iteration of simulation on the tiles of a single chunk, applying
+ * any tile interactions, flow, gravity, etc.
+ *
+ * Tiles within the chunk may move into, and be moved by, the ring of tiles
+ * bordering the chunk, but no further.
+ *
+ * A dense chunk visits every one of its tiles, a sparse chunk only those woken
+ * since its last visit. Every tile either moves whenever it has somewhere to
+ * move to, or never moves at all, and where it can move to only depends on the
+ * tiles next to it. A tile left alone by a visit, and nothing around it having
+ * changed since, would therefore be left alone again, so both modes give the
+ * same result.
+ *
+ * @param sandbox - Sandbox containing chunk to simulate.
+ * @param height, width - Dimensions of sandbox.
+ * @param chunk_row, chunk_column - Coordinates of chunk within the sandbox,
+ * in chunks.
+ */
+static void _process_chunk(unsigned char **sandbox,
+        unsigned int height,
+        unsigned int width,
+        unsigned int chunk_row,
+        unsigned int chunk_column)
+{
+    unsigned int row_start = chunk_row * CHUNK_SIZE;
+    unsigned int column_start = chunk_column * CHUNK_SIZE;
+    unsigned int row_end = row_start + CHUNK_SIZE < height ? row_start + CHUNK_SIZE : height;
+    unsigned int column_end = column_start + CHUNK_SIZE < width ? column_start + CHUNK_SIZE : width;
+
+    struct SandboxInfo *info = get_sandbox_info(sandbox);
+    struct Chunk *chunk = &info -> chunks[chunk_row * info -> chunk_columns + chunk_column];
+
+    if (!chunk -> is_sparse)
+    {
+        // Woken bits are left alone, which only costs a sparse chunk extra
+        // visits once it turns sparse.
+        for (unsigned int row = row_start; row < row_end; row++)
+        {
+            for (unsigned int col = column_start; col < column_end;)
+            {
+                col += _process_tile(sandbox, height, width, chunk, row, col, row_start, column_start, column_end);
+            }
+        }
+        return;
+    }
+
+    // Bits are read as processing goes, since moving tiles wake the tiles
+    // after them as well as before them.
+    for (unsigned int bit_index = 0; bit_index < CHUNK_SIZE * CHUNK_SIZE;)
+    {
+        unsigned char *woken_byte = &chunk -> woken_tiles[bit_index / 8];
+
+        if ((*woken_byte >> (bit_index % 8)) == 0)
+        {
+            bit_index = (bit_index / 8 + 1) * 8;
+            continue;
+        }
+
+        if (!((*woken_byte >> (bit_index % 8)) & 1))
+        {
+            bit_index++;
+            continue;
+        }
+
+        unsigned int row = row_start + bit_index / CHUNK_SIZE;
+        unsigned int col = column_start + bit_index % CHUNK_SIZE;
+
+        // A tile which moved here this frame is visited next frame, so it
+        // stays awake until then.
+        if (row < row_end && col < column_end && _is_tile_moved(info, row, col))
+        {
+            bit_index++;
+            continue;
+        }
+
+        *woken_byte &= ~(1 << (bit_index % 8));
+
+        if (row >= row_end || col >= column_end)
+        {
+            bit_index++;
+            continue;
+        }
+
+        bit_index += _process_tile(sandbox, height, width, chunk, row, col, row_start, column_start, column_end);
+    }
+}
+
+
+/*
+ * Copy a chunk and the ring of tiles bordering it out of, or back into, the
+ * sandbox. Positions of the window lying outside the sandbox read as air and
+ * are never written.
+ *
+ * Tiles that have moved this frame carry WINDOW_MOVED_FLAG within the window.
+ *
+ * @param sandbox - Sandbox containing chunk.
+ * @param height, width - Dimensions of sandbox.
+ * @param chunk_row, chunk_column - Coordinates of chunk, in chunks.
+ * @param window - CHUNK_WINDOW_AREA tiles to copy from or into.
+ * @param should_write - Whether to copy window into sandbox, or sandbox into
+ * window.
+ *
+ * @return - Number of non-air tiles within the chunk itself.
+ */
+static unsigned int _copy_chunk_window(unsigned char **sandbox,
+        unsigned int height,
+        unsigned int width,
+        unsigned int chunk_row,
+        unsigned int chunk_column,
+        unsigned char *window,
+        bool should_write)
+{
+    struct SandboxInfo *info = get_sandbox_info(sandbox);
+    unsigned int non_air_tiles = 0;
+
+    for (unsigned int window_row = 0; window_row < CHUNK_WINDOW_SIZE; window_row++)
+    {
+        // Start a tile above and to the left of the chunk itself.
+        unsigned int row = chunk_row * CHUNK_SIZE + window_row - 1;
+
+        for (unsigned int window_column = 0; window_column < CHUNK_WINDOW_SIZE; window_column++)
+        {
+            unsigned int column = chunk_column * CHUNK_SIZE + window_column - 1;
+            unsigned char *window_tile = &window[window_row * CHUNK_WINDOW_SIZE + window_column];
+
+            // Unsigned wrap-around makes row/column -1 out of bounds as well.
+            if (row >= height || column >= width)
+            {
+                if (!should_write)
+                {
+                    *window_tile = AIR;
+                }
+                continue;
+            }
+
+            if (should_write)
+            {
+                _record_change(info, row, column, sandbox[row][column], *window_tile & ~WINDOW_MOVED_FLAG);
+                sandbox[row][column] = *window_tile & ~WINDOW_MOVED_FLAG;
+
+                if (*window_tile & WINDOW_MOVED_FLAG)
+                {
+                    _mark_tile_moved(info, row, column);
+                }
+                continue;
+            }
+
+            *window_tile = sandbox[row][column];
+
+            if (_is_tile_moved(info, row, column))
+            {
+                *window_tile |= WINDOW_MOVED_FLAG;
+            }
+
+            bool is_border = window_row == 0 || window_column == 0
+                || window_row == CHUNK_WINDOW_SIZE - 1 || window_column == CHUNK_WINDOW_SIZE - 1;
+
+            if (!is_border && get_tile_id(*window_tile) != AIR)
+            {
+                non_air_tiles++;
+            }
+        }
+    }
+
+    return non_air_tiles;
+}
+
+
+/*
+ * Perform one iteration of simulation on a single chunk, replaying the result
+ * from the chunk cache whenever the same chunk window was processed under the
+ * same RNG key before.
+ *
+ * @param sandbox - Sandbox containing chunk to simulate.
+ * @param height, width - Dimensions of sandbox.
+ * @param chunk_row, chunk_column - Coordinates of chunk, in chunks.
+ */
+static void _process_chunk_cached(unsigned char **sandbox,
+        unsigned int height,
+        unsigned int width,
+        unsigned int chunk_row,
+        unsigned int chunk_column)
+{
+    unsigned char window[CHUNK_WINDOW_AREA];
+    unsigned char result[CHUNK_WINDOW_AREA];
+
+    unsigned int non_air_tiles = _copy_chunk_window(sandbox, height, width, chunk_row, chunk_column, window, false);
+
+    // Air is never simulated, so an empty chunk has nothing to do or cache.
+    if (non_air_tiles == 0)
+    {
+        return;
+    }
+
+    struct ChunkCacheKey key;
+    key.seed = SANDBOX_SEED;
+    key.rng_phase = get_rng_phase(SANDBOX_LIFETIME);
+    key.chunk_row = chunk_row;
+    key.chunk_column = chunk_column;
+    key.height = height;
+    key.width = width;
+
+    if (chunk_cache_lookup(&key, window, result))
+    {
+        _copy_chunk_window(sandbox, height, width, chunk_row, chunk_column, result, true);
+        return;
+    }
+
+    _process_chunk(sandbox, height, width, chunk_row, chunk_column);
+
+    _copy_chunk_window(sandbox, height, width, chunk_row, chunk_column, result, false);
+    chunk_cache_store(&key, window, result);
+}
+
+
+/*
+ * Perform one iteration of simulation on a single chunk during the frame given
+ * by SANDBOX_LIFETIME, unless the chunk is too far from the view to be updated
+ * this frame.
+ *
+ * @param sandbox - Sandbox containing chunk to simulate.
+ * @param height, width - Dimensions of sandbox.
+ * @param view - Part of the sandbox being looked at, or NULL.
+ * @param chunk_row, chunk_column - Coordinates of chunk, in chunks.
+ * @param use_cache - Whether to go through the chunk cache.
+ *
+ * @return - True if the chunk was processed, false if it was skipped.
+ */
+static bool _process_chunk_in_view(unsigned char **sandbox,
+        unsigned int height,
+        unsigned int width,
+        const struct SandboxView *view,
+        unsigned int chunk_row,
+        unsigned int chunk_column,
+        bool use_cache)
+{
+    unsigned int interval = get_chunk_update_interval(view, chunk_row, chunk_column);
+
+    // Stagger chunks sharing an interval across different frames.
+    unsigned int offset = chunk_row * 7 + chunk_column * 13;
+
+    struct SandboxInfo *info = get_sandbox_info(sandbox);
+
+    if ((SANDBOX_LIFETIME + offset) % interval != 0)
+    {
+        info -> frame_stats.skipped_chunks++;
+        return false;
+    }
+
+    struct Chunk *chunk = &info -> chunks[chunk_row * info -> chunk_columns + chunk_column];
+
+    if (chunk -> is_sparse)
+    {
+        info -> frame_stats.sparse_chunks++;
+    }
+    else
+    {
+        info -> frame_stats.dense_chunks++;
+    }
+
+    if (use_cache)
+    {
+        _process_chunk_cached(sandbox, height, width, chunk_row, chunk_column);
+    }
+    else
+    {
+        _process_chunk(sandbox, height, width, chunk_row, chunk_column);
+    }
+
+    // Pick the mode for the chunk's next frame from how busy this one was.
+    unsigned int moved_tiles = _count_moved_tiles(chunk);
+
+    if (chunk -> is_sparse && moved_tiles > DENSE_MOVED_THRESHOLD)
+    {
+        chunk -> is_sparse = false;
+    }
+    else if (!chunk -> is_sparse && moved_tiles < SPARSE_MOVED_THRESHOLD)
+    {
+        chunk -> is_sparse = true;
+    }
+
+    return true;
+}
+
+
+/*
+ * Return the size of the bookkeeping of a sandbox, including its row pointers.
+ *
+ * @param height - Height of sandbox.
+ *
+ * @return - Bytes of bookkeeping.
+ */
+static size_t _get_info_bytes(unsigned int height)
+{
+    return sizeof(struct SandboxInfo) + height * sizeof(unsigned char *);
+}
+
+
+/*
+ * Return the size of the chunks of a sandbox.
+ *
+ * @param info - Bookkeeping of sandbox.
+ *
+ * @return - Bytes of chunks.
+ */
+static size_t _get_chunks_bytes(const struct SandboxInfo *info)
+{
+    return info -> chunk_rows * info -> chunk_columns * sizeof(struct Chunk);
+}
+
+
+/*
+ * Create the bookkeeping and chunks of a sandbox around a block holding its
+ * tiles, without looking at the tiles.
+ *
+ * @param tiles - Every tile of the sandbox, row by row.
+ * @param height, width - Dimensions of sandbox.
+ *
+ * @return - Newly created sandbox, with its hashes and woken tiles yet to be
+ * set, or NULL if there was not enough memory, in which case the tiles are
+ * left to the caller.
+ */
+static unsigned char **_create_sandbox_around(unsigned char *tiles, unsigned int height, unsigned int width)
+{
+    // Allocate memory for the sandbox's bookkeeping, followed directly by a
+    // pointer for each row. Callers only ever see the row pointers. Counters
+    // and hashes start out at 0.
+    struct SandboxInfo *info = (struct SandboxInfo *) allocate_memory(MEMORY_GRID, _get_info_bytes(height));
+
+    if (info == NULL)
+    {
+        return NULL;
+    }
+
+    unsigned char **new_sandbox = (unsigned char **) (info + 1);
+
+    // Rows point into the tiles one after another, so the tiles can also be
+    // handed out as a single block.
+    info -> tiles = tiles;
+
+    for (unsigned int row_index = 0; row_index < height; row_index++)
+    {
+        new_sandbox[row_index] = info -> tiles + (size_t) row_index * width;
+    }
+
+    info -> height = height;
+    info -> width = width;
+    info -> chunk_rows = (height + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    info -> chunk_columns = (width + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    info -> chunks = (struct Chunk *) allocate_memory(MEMORY_CHUNKS, _get_chunks_bytes(info));
+
+    if (info -> chunks == NULL)
+    {
+        release_memory(MEMORY_GRID, info, _get_info_bytes(height));
+        return NULL;
+    }
+
+    info -> change_feed = NULL;
+    info -> world_hash = 0;
+    info -> state_epoch = 1;
+    info -> next_chunk = 0;
+    info -> is_mapped = false;
+
+    info -> grid_subsystem = MEMORY_GRID;
+    info -> chunk_subsystem = MEMORY_CHUNKS;
+
+    // No chunk has had a tile move yet.
+    _clear_moved_tiles(new_sandbox);
+
+    return new_sandbox;
+}
+
+
+// ----- PUBLIC FUNCTIONS -----
+
+
+unsigned char **create_sandbox(unsigned int height, unsigned int width)
+{
+    // Allocate memory for every tile at once, setting each tile to 0, which
+    // corresponds to non-static air.
+    unsigned char *tiles = (unsigned char *) allocate_memory(MEMORY_GRID, (size_t) height * width + 1);
+    unsigned char **new_sandbox = tiles != NULL ? _create_sandbox_around(tiles, height, width) : NULL;
+
+    if (new_sandbox == NULL)
+    {
+        release_memory(MEMORY_GRID, tiles, (size_t) height * width + 1);
+        return NULL;
+    }
+
+    // Every tile has yet to be visited.
+    wake_sandbox(new_sandbox);
+
+    return new_sandbox;
+}
+
+
+unsigned char **map_sandbox(const char *path,
+        size_t offset,
+        unsigned int height,
+        unsigned int width,
+        const unsigned long long *chunk_hashes)
+{
+    unsigned char *tiles = (unsigned char *) map_file(MEMORY_GRID, path, offset, (size_t) height * width + 1);
+
+    if (tiles == NULL)
+    {
+        return NULL;
+    }
+
+    unsigned char **new_sandbox = _create_sandbox_around(tiles, height, width);
+
+    if (new_sandbox == NULL)
+    {
+        unmap_file(MEMORY_GRID, tiles, (size_t) height * width + 1);
+        return NULL;
+    }
+
+    struct SandboxInfo *info = get_sandbox_info(new_sandbox);
+    info -> is_mapped = true;
+
+    if (chunk_hashes == NULL)
+    {
+        wake_sandbox(new_sandbox);
+        return new_sandbox;
+    }
+
+    // Taking the hashes as given leaves the tiles untouched until they are
+    // first simulated. Every chunk still counts as modified, as rehashing
+    // it would, so the first state saved copies it.
+    for (unsigned int i = 0; i < info -> chunk_rows * info -> chunk_columns; i++)
+    {
+        info -> chunks[i].hash = chunk_hashes[i];
+        info -> chunks[i].modified_epoch = info -> state_epoch;
+        info -> world_hash ^= chunk_hashes[i];
+    }
+
+    _wake_every_tile(info);
+
+    return new_sandbox;
+}
+
+
+void sandbox_free(unsigned char **sandbox, unsigned int height, unsigned int width)
+{
+    struct SandboxInfo *info = get_sandbox_info(sandbox);
+
+    // Closing the feed frees it.
+    set_change_feed(sandbox, CHANGES_TILES, 0);
+
+    // First, free the tiles every row points into.
+    // Then, free the bookkeeping which the array of row pointers is part of.
+    if (info -> is_mapped)
+    {
+        unmap_file(info -> grid_subsystem, info -> tiles, (size_t) height * width + 1);
+    }
+    else
+    {
+        release_memory(info -> grid_subsystem, info -> tiles, (size_t) height * width + 1);
+    }
+
+    release_memory(info -> chunk_subsystem, info -> chunks, _get_chunks_bytes(info));
+    release_memory(info -> grid_subsystem, info, _get_info_bytes(height));
+}
+
+
+void set_sandbox_memory_subsystem(unsigned char **sandbox, enum memory_subsystem subsystem)
+{
+    struct SandboxInfo *info = get_sandbox_info(sandbox);
+
+    retrack_memory(info -> grid_subsystem, subsystem, info, _get_info_bytes(info -> height));
+    retrack_memory(info -> grid_subsystem, subsystem, info -> tiles, (size_t) info -> height * info -> width + 1);
+    retrack_memory(info -> chunk_subsystem, subsystem, info -> chunks, _get_chunks_bytes(info));
+
+    info -> grid_subsystem = subsystem;
+    info -> chunk_subsystem = subsystem;
+}
+
+
+struct SandboxInfo *get_sandbox_info(unsigned char **sandbox)
+{
+    // Bookkeeping sits directly in front of the row pointers.
+    return ((struct SandboxInfo *) sandbox) - 1;
+}
+
+
+struct SandboxStats get_sandbox_stats(unsigned char **sandbox)
+{
+    return get_sandbox_info(sandbox) -> last_stats;
+}
+
+
+void edit_tile(unsigned char **sandbox, unsigned int row_index, unsigned int column_index, unsigned char tile)
+{
+    struct SandboxInfo *info = get_sandbox_info(sandbox);
+
+    _record_change(info, row_index, column_index, sandbox[row_index][column_index], tile);
+    sandbox[row_index][column_index] = tile;
+    _wake_tiles_around(info, row_index, column_index);
+}
+
+
+unsigned long long get_world_hash(unsigned char **sandbox)
+{
+    return get_sandbox_info(sandbox) -> world_hash;
+}
+
+
+unsigned long long get_tile_key(unsigned long tile_index, unsigned char tile)
+{
+    // Air is left out, so an empty sandbox hashes to 0 without any work.
+    if (tile == AIR)
+    {
+        return 0;
+    }
+
+    // Keys are mixed from the index and tile on demand, rather than looked
+    // up in a table as large as the sandbox times every possible tile.
+    unsigned long long key = ((unsigned long long) tile_index << 8 | tile) + 0x9e3779b97f4a7c15ULL;
+
+    // Finalizer of SplitMix64.
+    key = (key ^ (key >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    key = (key ^ (key >> 27)) * 0x94d049bb133111ebULL;
+    key ^= key >> 31;
+
+    return key;
+}
+
+
+void wake_tile(unsigned char **sandbox, unsigned int row_index, unsigned int column_index)
+{
+    struct SandboxInfo *info = get_sandbox_info(sandbox);
+
+    if (info -> change_feed != NULL)
+    {
+        _mark_changes_dirty(info);
+    }
+
+    _rehash_chunk(sandbox, row_index / CHUNK_SIZE, column_index / CHUNK_SIZE);
+    _wake_tiles_around(info, row_index, column_index);
+}
+
+
+void wake_region(unsigned char **sandbox,
+        unsigned int row_index,
+        unsigned int column_index,
+        unsigned int region_height,
+        unsigned int region_width)
+{
+    struct SandboxInfo *info = get_sandbox_info(sandbox);
+
+    if (region_height == 0 || region_width == 0)
+    {
+        return;
+    }
+
+    if (info -> change_feed != NULL && info -> change_feed -> granularity == CHANGES_TILES)
+    {
+        _mark_changes_dirty(info);
+    }
+
+    unsigned int chunk_row_last = (row_index + region_height - 1) / CHUNK_SIZE;
+    unsigned int chunk_column_last = (column_index + region_width - 1) / CHUNK_SIZE;
+
+    for (unsigned int chunk_row = row_index / CHUNK_SIZE; chunk_row <= chunk_row_last; chunk_row++)
+    {
+        for (unsigned int chunk_column = column_index / CHUNK_SIZE; chunk_column <= chunk_column_last; chunk_column++)
+        {
+            _rehash_chunk(sandbox, chunk_row, chunk_column);
+
+            if (info -> change_feed != NULL && info -> change_feed -> granularity == CHANGES_CHUNKS)
+            {
+                struct Chunk *chunk = &info -> chunks[chunk_row * info -> chunk_columns + chunk_column];
+                _record_chunk_change(info -> change_feed, chunk, chunk_row, chunk_column);
+            }
+        }
+    }
+
+    // Wake the region along with a border of one tile, a whole chunk at a
+    // time, as tiles next to the region may now be free to move.
+    unsigned int row_first = row_index > 0 ? row_index - 1 : 0;
+    unsigned int row_last = row_index + region_height < info -> height ? row_index + region_height : info -> height - 1;
+    unsigned int column_first = column_index > 0 ? column_index - 1 : 0;
+    unsigned int column_last = column_index + region_width < info -> width ? column_index + region_width : info -> width - 1;
+
+    for (unsigned int chunk_row = row_first / CHUNK_SIZE; chunk_row <= row_last / CHUNK_SIZE; chunk_row++)
+    {
+        for (unsigned int chunk_column = column_first / CHUNK_SIZE; chunk_column <= column_last / CHUNK_SIZE; chunk_column++)
+        {
+            struct Chunk *chunk = &info -> chunks[chunk_row * info -> chunk_columns + chunk_column];
+            memset(chunk -> woken_tiles, 0xFF, sizeof(chunk -> woken_tiles));
+        }
+    }
+}
+
+
+void wake_sandbox(unsigned char **sandbox)
+{
+    struct SandboxInfo *info = get_sandbox_info(sandbox);
+
+    for (unsigned int chunk_row = 0; chunk_row < info -> chunk_rows; chunk_row++)
+    {
+        for (unsigned int chunk_column = 0; chunk_column < info -> chunk_columns; chunk_column++)
+        {
+            _rehash_chunk(sandbox, chunk_row, chunk_column);
+        }
+    }
+
+    _wake_every_tile(info);
+}
+
+
+void set_change_feed(unsigned char **sandbox, enum change_granularity granularity, unsigned int capacity)
+{
+    struct SandboxInfo *info = get_sandbox_info(sandbox);
+    struct ChangeFeed *feed = info -> change_feed;
+
+    // Record numbers carry on from the old feed, so cursors into it are left
+    // behind rather than reading records of another feed.
+    unsigned long head = feed != NULL ? feed -> head + 1 : 0;
+
+    if (feed != NULL)
+    {
+        release_memory(MEMORY_PLANES, feed -> records, feed -> capacity * sizeof(struct TileChange));
+        release_memory(MEMORY_PLANES, feed, sizeof(struct ChangeFeed));
+        info -> change_feed = NULL;
+    }
+
+    if (capacity == 0)
+    {
+        return;
+    }
+
+    feed = (struct ChangeFeed *) allocate_memory(MEMORY_PLANES, sizeof(struct ChangeFeed));
+    feed -> granularity = granularity;
+    feed -> records = (struct TileChange *) allocate_memory(MEMORY_PLANES, capacity * sizeof(struct TileChange));
+    feed -> capacity = capacity;
+    feed -> head = head;
+    feed -> dirty_since = head;
+
+    // Chunks may have been stamped by an earlier feed during this frame.
+    unsigned int num_chunks = info -> chunk_rows * info -> chunk_columns;
+
+    for (unsigned int i = 0; i < num_chunks; i++)
+    {
+        info -> chunks[i].change_stamp = 0;
+    }
+
+    info -> change_feed = feed;
+}
+
+
+unsigned long get_change_cursor(unsigned char **sandbox)
+{
+    struct ChangeFeed *feed = get_sandbox_info(sandbox) -> change_feed;
+
+    return feed != NULL ? feed -> head : 0;
+}
+
+
+bool read_changes(unsigned char **sandbox,
+        unsigned long *cursor,
+        struct TileChange *changes,
+        unsigned int max_changes,
+        unsigned int *num_read)
+{
+    struct ChangeFeed *feed = get_sandbox_info(sandbox) -> change_feed;
+    *num_read = 0;
+
+    // Without a feed, nothing can be said about what changed.
+    if (feed == NULL)
+    {
+        return false;
+    }
+
+    // Records older than the capacity have since been written over.
+    if (*cursor < feed -> dirty_since || *cursor > feed -> head || feed -> head - *cursor > feed -> capacity)
+    {
+        *cursor = feed -> head;
+        return false;
+    }
+
+    while (*cursor < feed -> head && *num_read < max_changes)
+    {
+        changes[(*num_read)++] = feed -> records[*cursor % feed -> capacity];
+        (*cursor)++;
+    }
+
+    return true;
+}
+
+
+
+void copy_sandbox(unsigned char **destination,
+        unsigned char **source,
+        unsigned int height,
+        unsigned int width)
+{
+    struct SandboxInfo *destination_info = get_sandbox_info(destination);
+    struct SandboxInfo *source_info = get_sandbox_info(source);
+
+    // Tiles of both are single blocks, so copy them in one go.
+    memcpy(destination_info -> tiles, source_info -> tiles, (size_t) height * width);
+
+    // Same tiles make for same hashes, which need not be computed again.
+    unsigned int num_chunks = source_info -> chunk_rows * source_info -> chunk_columns;
+
+    for (unsigned int i = 0; i < num_chunks; i++)
+    {
+        destination_info -> chunks[i].hash = source_info -> chunks[i].hash;
+        destination_info -> chunks[i].modified_epoch = destination_info -> state_epoch;
+    }
+
+    destination_info -> world_hash = source_info -> world_hash;
+
+    _wake_every_tile(destination_info);
+}
+
+
+
+struct SandboxState *create_sandbox_state(unsigned char **sandbox)
+{
+    struct SandboxInfo *info = get_sandbox_info(sandbox);
+    struct SandboxState *state = (struct SandboxState *) allocate_memory(MEMORY_REWIND, sizeof(struct SandboxState));
+
+    // Every chunk's copy starts out as air, hashing to 0. Every chunk of the
+    // sandbox counts as modified from when it was created or mapped, so the
+    // first save copies all of them.
+    state -> sandbox = sandbox;
+    state -> tiles = (unsigned char *) allocate_memory(MEMORY_REWIND, (size_t) info -> height * info -> width + 1);
+    state -> chunk_hashes = (unsigned long long *) allocate_memory(MEMORY_REWIND, info -> chunk_rows * info -> chunk_columns * sizeof(unsigned long long));
+    state -> world_hash = 0;
+    state -> lifetime = SANDBOX_LIFETIME;
+    state -> seed = SANDBOX_SEED;
+    state -> rng_period = SANDBOX_RNG_PERIOD;
+    state -> epoch = 0;
+
+    return state;
+}
+
+
+void free_sandbox_state(struct SandboxState *state)
+{
+    struct SandboxInfo *info = get_sandbox_info(state -> sandbox);
+
+    release_memory(MEMORY_REWIND, state -> tiles, (size_t) info -> height * info -> width + 1);
+    release_memory(MEMORY_REWIND, state -> chunk_hashes, info -> chunk_rows * info -> chunk_columns * sizeof(unsigned long long));
+    release_memory(MEMORY_REWIND, state, sizeof(struct SandboxState));
+}
+
+
+bool save_sandbox_state(struct SandboxState *state, struct StateCopyCost *cost)
+{
+    if (is_sandbox_mid_frame(state -> sandbox))
+    {
+        return false;
+    }
+
+    clock_t start_time = clock();
+    struct SandboxInfo *info = get_sandbox_info(state -> sandbox);
+    unsigned int num_chunks = info -> chunk_rows * info -> chunk_columns;
+    struct StateCopyCost work = {0, 0, 0};
+
+    for (unsigned int i = 0; i < num_chunks; i++)
+    {
+        // Chunks untouched since the last save still match their copy.
+        if (info -> chunks[i].modified_epoch <= state -> epoch)
+        {
+            continue;
+        }
+
+        work.bytes_copied += _copy_chunk_tiles(info, i, info -> tiles, state -> tiles);
+        work.chunks_copied++;
+        state -> chunk_hashes[i] = info -> chunks[i].hash;
+    }
+
+    state -> world_hash = info -> world_hash;
+    state -> lifetime = SANDBOX_LIFETIME;
+    state -> seed = SANDBOX_SEED;
+    state -> rng_period = SANDBOX_RNG_PERIOD;
+
+    // Changes from now on belong to the next epoch.
+    state -> epoch = info -> state_epoch++;
+
+    if (cost != NULL)
+    {
+        work.elapsed_ms = (clock() - start_time) * 1000.0 / CLOCKS_PER_SEC;
+        *cost = work;
+    }
+
+    return true;
+}
+
+
+bool restore_sandbox_state(struct SandboxState *state, struct StateCopyCost *cost)
+{
+    if (is_sandbox_mid_frame(state -> sandbox))
+    {
+        return false;
+    }
+
+    clock_t start_time = clock();
+    struct SandboxInfo *info = get_sandbox_info(state -> sandbox);
+    unsigned int num_chunks = info -> chunk_rows * info -> chunk_columns;
+    struct StateCopyCost work = {0, 0, 0};
+
+    for (unsigned int i = 0; i < num_chunks; i++)
+    {
+        struct Chunk *chunk = &info -> chunks[i];
+
+        if (chunk -> modified_epoch <= state -> epoch)
+        {
+            continue;
+        }
+
+        work.bytes_copied += _copy_chunk_tiles(info, i, state -> tiles, info -> tiles);
+        work.chunks_copied++;
+
+        chunk -> hash = state -> chunk_hashes[i];
+        chunk -> modified_epoch = info -> state_epoch;
+
+        // Tiles next to the restored chunk may have somewhere new to move to,
+        // so wake the chunks around it as well.
+        unsigned int chunk_row = i / info -> chunk_columns;
+        unsigned int chunk_column = i % info -> chunk_columns;
+
+        for (unsigned int row = chunk_row > 0 ? chunk_row - 1 : 0; row <= chunk_row + 1 && row < info -> chunk_rows; row++)
+        {
+            for (unsigned int col = chunk_column > 0 ? chunk_column - 1 : 0; col <= chunk_column + 1 && col < info -> chunk_columns; col++)
+            {
+                struct Chunk *neighbour = &info -> chunks[row * info -> chunk_columns + col];
+                memset(neighbour -> woken_tiles, 0xFF, sizeof(neighbour -> woken_tiles));
+            }
+        }
+    }
+
+    info -> world_hash = state -> world_hash;
+    SANDBOX_LIFETIME = state -> lifetime;
+    SANDBOX_SEED = state -> seed;
+    SANDBOX_RNG_PERIOD = state -> rng_period;
+
+    // Frames about to be simulated again have left stale bits behind, which
+    // would otherwise count as current.
+    _clear_moved_tiles(state -> sandbox);
+
+    if (info -> change_feed != NULL)
+    {
+        for (unsigned int i = 0; i < num_chunks; i++)
+        {
+            info -> chunks[i].change_stamp = 0;
+        }
+
+        if (work.chunks_copied > 0)
+        {
+            _mark_changes_dirty(info);
+        }
+    }
+
+    if (cost != NULL)
+    {
+        work.elapsed_ms = (clock() - start_time) * 1000.0 / CLOCKS_PER_SEC;
+        *cost = work;
+    }
+
+    return true;
+}
+
+void process_sandbox(unsigned char **sandbox, unsigned int height, unsigned int width)
+{
+    process_sandbox_in_view(sandbox, height, width, NULL);
+}
+
+
+void process_sandbox_in_view(unsigned char **sandbox,
+        unsigned int height,
+        unsigned int width,
+        const struct SandboxView *view)
+{
+    process_sandbox_budgeted(sandbox, height, width, view, -1);
+}
+
+
+bool process_sandbox_budgeted(unsigned char **sandbox,
+        unsigned int height,
+        unsigned int width,
+        const struct SandboxView *view,
+        double budget_ms)
+{
+    unsigned int chunk_rows = (height + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    unsigned int chunk_columns = (width + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    unsigned int num_chunks = chunk_rows * chunk_columns;
+    bool use_cache = is_chunk_cache_enabled();
 
-    switch (tile_type)
+    clock_t start_time = clock();
+
+    struct SandboxInfo *info = get_sandbox_info(sandbox);
+
+    // Iterate through whole sandbox chunk by chunk, applying updates where
+    // necessary, picking up wherever the last call on it left off.
+    while (info -> next_chunk < num_chunks)
     {
-        // Air refers to the empty tile, it does not receive lift.
-        case AIR:
-            return false;
+        unsigned int chunk_row = info -> next_chunk / chunk_columns;
+        unsigned int chunk_column = info -> next_chunk % chunk_columns;
+        info -> next_chunk++;
 
-        case SAND:
-            return false;
+        if (!_process_chunk_in_view(sandbox, height, width, view, chunk_row, chunk_column, use_cache))
+        {
+            continue;
+        }
 
-        case WATER:
-            return false;
+        // At least one chunk is processed per call, so frames always finish.
+        double elapsed_ms = (clock() - start_time) * 1000.0 / CLOCKS_PER_SEC;
 
-        case WOOD:
+        if (budget_ms >= 0 && elapsed_ms >= budget_ms && info -> next_chunk < num_chunks)
+        {
             return false;
+        }
+    }
 
-        case STEAM:
-            return true;
+    info -> next_chunk = 0;
+    info -> frame_stats.frames = 1;
+    info -> frame_stats.world_hash = info -> world_hash;
+    info -> last_stats = info -> frame_stats;
+    memset(&info -> frame_stats, 0, sizeof(info -> frame_stats));
 
-        case FIRE:
-            return true;
+    // For every frame of processing, the sandbox grows older.
+    SANDBOX_LIFETIME++;
 
-        default:
-            return false;
-    }
+    return true;
 }
 
 
-/*
- * Return whether or not a tile is "solid".
- *
- * A tile is considered solid if it capable of acting as a "floor".
- * Intuitively, this means you could sensibly stand on the tile.
- *
- * For example, air is not solid, but sand is. Fire is not solid, but wood is.
- *
- */
-static bool _is_solid(unsigned char tile)
+bool is_sandbox_mid_frame(unsigned char **sandbox)
 {
-    unsigned char tile_type = get_tile_id(tile);
+    return get_sandbox_info(sandbox) -> next_chunk != 0;
+}
 
-    switch (tile_type)
+
+unsigned int get_sandbox_frame_progress(unsigned char **sandbox)
+{
+    return get_sandbox_info(sandbox) -> next_chunk;
+}
+
+void process_sandbox_blocked(unsigned char **sandbox,
+        unsigned int height,
+        unsigned int width,
+        const struct SandboxView *view,
+        unsigned int num_frames)
+{
+    // Finish off any frame left partially processed first.
+    if (is_sandbox_mid_frame(sandbox))
     {
-        case AIR:
-            return false;
+        process_sandbox_budgeted(sandbox, height, width, view, -1);
+    }
 
-        case SAND:
-            return true;
+    unsigned int chunk_rows = (height + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    unsigned int chunk_columns = (width + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    bool use_cache = is_chunk_cache_enabled();
+    unsigned int start_time = SANDBOX_LIFETIME;
 
-        case WATER:
-            return true;
+    if (num_frames == 0)
+    {
+        return;
+    }
 
-        case WOOD:
-            return true;
+    // Processing a row of chunks in some frame only has to wait on the rows
+    // next to it: the row above in the same frame, and the row below in the
+    // frame before. Visiting (row, frame) pairs in increasing order of
+    // row + 2 * frame satisfies both, and so gives the same result as
+    // processing whole frames one after another.
+    //
+    // Rather than sweeping the whole sandbox once per frame, this sweeps down
+    // it once, with each frame trailing two rows of chunks behind the one
+    // before it. Only the 2 * num_frames rows of chunks around the sweep are
+    // touched at any one time, which keeps them in cache between frames.
+    unsigned int num_orders = chunk_rows + 2 * (num_frames - 1);
+
+    for (unsigned int order = 0; order < num_orders; order++)
+    {
+        for (unsigned int frame = 0; frame < num_frames && 2 * frame <= order; frame++)
+        {
+            unsigned int chunk_row = order - 2 * frame;
 
-        case STEAM:
-            return false;
+            if (chunk_row >= chunk_rows)
+            {
+                continue;
+            }
 
-        case FIRE:
-            return false;
+            // Chunks consult the frame they belong to for their random
+            // choices and updated flags.
+            SANDBOX_LIFETIME = start_time + frame;
 
-        default:
-            return false;
+            for (unsigned int chunk_column = 0; chunk_column < chunk_columns; chunk_column++)
+            {
+                _process_chunk_in_view(sandbox, height, width, view, chunk_row, chunk_column, use_cache);
+            }
+        }
     }
+
+    SANDBOX_LIFETIME = start_time + num_frames;
+
+    struct SandboxInfo *info = get_sandbox_info(sandbox);
+    info -> frame_stats.frames = num_frames;
+    info -> frame_stats.world_hash = info -> world_hash;
+    info -> last_stats = info -> frame_stats;
+    memset(&info -> frame_stats, 0, sizeof(info -> frame_stats));
 }
 
 
-/*
- * Perform a slide on the given tile coordinates within the sandbox, if possible.
- *
- * A slide is possible if the tile in question has room to move to the left
- * or to the right one tile, without going out of bounds.
- *
- * If both are possible, perform one at random.
- *
- * This function does NOT check under what conditions a tile should slide.
- *
- * Helper function to do_liquid_flow and do_lift.
- *
- * @param sandbox - Sandbox to potentialyl mutate by moving tiles for sliding.
- * @param height, width - Dimensions of given sandbox.
- * @param row_index, column_index - Coordinates of tile to slide.
- */
-void _slide_left_or_right(unsigned char **sandbox,
+struct StepResult step_sandbox_until(unsigned char **sandbox,
         unsigned int height,
         unsigned int width,
-        unsigned int row_index,
-        unsigned int column_index)
+        const struct StopCriteria *criteria)
 {
-    // Gather info about what's to the left and right.
-    unsigned int left_column = column_index - 1;
-    unsigned int right_column = column_index + 1;
+    struct SandboxInfo *info = get_sandbox_info(sandbox);
+    struct StepResult result = {STOP_MAX_FRAMES, 0, 0};
+    unsigned int still_frames = 0;
 
-    // Test to see where we can move...
-    // Only slide a direction if there's an empty space, and it's not OOB.
-    bool can_slide_left = false;
-    bool can_slide_right = false;
+    clock_t start_time = clock();
 
-    if (left_column != -1 && get_tile_id(sandbox[row_index][left_column]) == AIR)
+    while (true)
     {
-        can_slide_left = true;
-    }
+        unsigned long long hash_before = info -> world_hash;
 
-    if (right_column != width && get_tile_id(sandbox[row_index][right_column]) == AIR)
-    {
-        can_slide_right = true;
-    }
+        process_sandbox(sandbox, height, width);
+        result.frames++;
+        result.elapsed_ms = (clock() - start_time) * 1000.0 / CLOCKS_PER_SEC;
 
-    // If we can flow both directions, choose one at random on a coin flip.
-    if (can_slide_left && can_slide_right)
-    {
-        bool heads = _flip_coin();
+        // Chunks replayed from the chunk cache make no swaps, but still
+        // change the hash when tiles move.
+        struct SandboxStats stats = info -> last_stats;
+        bool is_still = stats.swaps == 0 && stats.world_hash == hash_before;
+        still_frames = is_still ? still_frames + 1 : 0;
 
-        if (heads)
+        if (criteria -> should_stop != NULL && criteria -> should_stop(sandbox, &stats, criteria -> context))
         {
-            _swap_tiles(row_index, column_index, row_index, left_column, sandbox);
+            result.reason = STOP_PREDICATE;
+        }
+        else if (criteria -> still_frames > 0 && still_frames >= criteria -> still_frames)
+        {
+            result.reason = STOP_SETTLED;
+        }
+        else if (stats.tiles_visited < criteria -> active_tiles_below)
+        {
+            result.reason = STOP_FEW_ACTIVE_TILES;
+        }
+        else if (criteria -> max_frames > 0 && result.frames >= criteria -> max_frames)
+        {
+            result.reason = STOP_MAX_FRAMES;
+        }
+        else if (criteria -> max_ms > 0 && result.elapsed_ms >= criteria -> max_ms)
+        {
+            result.reason = STOP_TIME_LIMIT;
         }
         else
         {
-            _swap_tiles(row_index, column_index, row_index, right_column, sandbox);
+            continue;
         }
-        return;
-    }
-
-    // If only one option is available, do that.
-    if (can_slide_left)
-    {
-        _swap_tiles(row_index, column_index, row_index, left_column, sandbox);
-        return;
-    }
 
-    if (can_slide_right)
-    {
-        _swap_tiles(row_index, column_index, row_index, right_column, sandbox);
-        return;
+        return result;
     }
 }
 
 
-// ----- PUBLIC FUNCTIONS -----
+const char *get_stop_reason_name(enum stop_reason reason)
+{
+    return STOP_REASON_NAMES[reason];
+}
 
 
-unsigned char **create_sandbox(unsigned int height, unsigned int width)
+
+unsigned int get_chunk_update_interval(const struct SandboxView *view,
+        unsigned int chunk_row,
+        unsigned int chunk_column)
 {
-    // Allocate memory for each row.
-    unsigned char **new_sandbox = (unsigned char **) malloc(height * sizeof(unsigned char *));
+    if (view == NULL || view -> height == 0 || view -> width == 0)
+    {
+        return 1;
+    }
 
-    // Then allocate memory for each tile within each row, setting each tile to
-    // 0, which corresponds to non-static air.
-    for (unsigned int row_index = 0; row_index < height; row_index++)
+    // Chunks overlapped by the view, inclusive.
+    unsigned int view_top = view -> row / CHUNK_SIZE;
+    unsigned int view_bottom = (view -> row + view -> height - 1) / CHUNK_SIZE;
+    unsigned int view_left = view -> column / CHUNK_SIZE;
+    unsigned int view_right = (view -> column + view -> width - 1) / CHUNK_SIZE;
+
+    // Distance in chunks from the view, counting diagonal steps as one.
+    unsigned int vertical_distance = 0;
+    unsigned int horizontal_distance = 0;
+
+    if (chunk_row < view_top)
+    {
+        vertical_distance = view_top - chunk_row;
+    }
+    else if (chunk_row > view_bottom)
     {
-        new_sandbox[row_index] = (unsigned char *) calloc(width, sizeof(unsigned char));
+        vertical_distance = chunk_row - view_bottom;
     }
 
-    return new_sandbox;
-}
+    if (chunk_column < view_left)
+    {
+        horizontal_distance = view_left - chunk_column;
+    }
+    else if (chunk_column > view_right)
+    {
+        horizontal_distance = chunk_column - view_right;
+    }
 
+    unsigned int distance = vertical_distance > horizontal_distance ? vertical_distance : horizontal_distance;
 
-void sandbox_free(unsigned char **sandbox, unsigned int height, unsigned int width)
-{
-    // First, free each row as an array of bytes.
-    // Then, free the array of pointers that pointed to each array of bytes.
-    for (unsigned int row_index = 0; row_index < height; row_index++)
+    if (distance <= LOD_NEAR_MARGIN)
     {
-        free(sandbox[row_index]);
+        return 1;
     }
 
-    free(sandbox);
-}
+    if (distance <= LOD_MID_MARGIN)
+    {
+        return LOD_MID_INTERVAL;
+    }
 
+    return LOD_FAR_INTERVAL;
+}
 
-void process_sandbox(unsigned char **sandbox, unsigned int height, unsigned int width)
+void settle_sandbox(unsigned char **sandbox, unsigned int height, unsigned int width)
 {
-    // Iterate through whole sandbox, applying updates where necessary.
-    for (unsigned int row = 0; row < height; row++)
+    unsigned int area = height * width;
+
+    // Toppling swaps tiles, which are not part of any frame's work.
+    struct SandboxInfo *info = get_sandbox_info(sandbox);
+    unsigned long frame_swaps = info -> frame_stats.swaps;
+
+    unsigned char *grains = (unsigned char *) arena_allocate(&SCRATCH, height * sizeof(unsigned char));
+    unsigned char *others = (unsigned char *) arena_allocate(&SCRATCH, height * sizeof(unsigned char));
+
+    // Columns are independent of one another, so compact each on its own.
+    for (unsigned int col = 0; col < width; col++)
+    {
+        _compact_column(sandbox, height, col, grains, others);
+    }
+
+    // Compacted columns may stand taller than their neighbours. Topple them
+    // from the bottom up, so every grain lands on tiles already at rest.
+    for (unsigned int row = height; row-- > 0;)
     {
         for (unsigned int col = 0; col < width; col++)
         {
-            unsigned char current_tile = sandbox[row][col];
-            unsigned char tile_type = get_tile_id(current_tile);
-            bool is_static = is_tile_static(current_tile);
-            bool is_updated = is_tile_updated(current_tile, SANDBOX_LIFETIME);
-
-            // Do not simulate an empty tile.
-            if (tile_type == AIR)
+            if (_is_granular(sandbox[row][col]))
             {
-                continue;
+                _topple_grain(sandbox, height, width, row, col);
             }
+        }
+    }
 
-            // Do not simulate a static tile.
-            if (is_static)
-            {
-                continue;
-            }
+    // Label every connected body of liquid, then of gas, to lift out and
+    // pour back in one at a time.
+    unsigned int *labels = (unsigned int *) arena_allocate(&SCRATCH, area * sizeof(unsigned int));
+    unsigned int *stack = (unsigned int *) arena_allocate(&SCRATCH, area * sizeof(unsigned int));
+    unsigned int num_bodies = 0;
+    unsigned int num_liquid_bodies = 0;
+
+    struct Pour pour = {sandbox, height, width, false};
+
+    for (unsigned int phase = 0; phase < 2; phase++)
+    {
+        pour.is_gas = phase == 1;
 
-            // Do not simulate a tile that has already been updated.
-            if (is_updated)
+        for (unsigned int start = 0; start < area; start++)
+        {
+            if (labels[start] != 0 || !_is_poured(&pour, sandbox[start / width][start % width]))
             {
                 continue;
             }
 
-            // Reaching this point means an update-check MUST occur, even if
-            // it results in nothing changing, so we mark the tile as updated.
-            // Take care to mutate the array element, NOT the stack-variable.
-            set_tile_updated(&sandbox[row][col], SANDBOX_LIFETIME);
-           
+            num_bodies++;
+            labels[start] = num_bodies;
 
-            // Perform gravity on the tiles that need it.
-            if (_tile_has_gravity(current_tile))
-            {
-                do_gravity(sandbox, height, width, row, col);
-            }
+            unsigned int stack_size = 0;
+            stack[stack_size++] = start;
 
-            // Perform flow on tiles that need it.
-            if (_tile_has_flow(current_tile))
+            while (stack_size > 0)
             {
-                do_liquid_flow(sandbox, height, width, row, col);
+                unsigned int cell = stack[--stack_size];
+                unsigned int row = cell / width;
+                unsigned int col = cell % width;
+
+                // Up, down, left, right.
+                unsigned int neighbours[4] = {
+                    row > 0 ? cell - width : area,
+                    row + 1 < height ? cell + width : area,
+                    col > 0 ? cell - 1 : area,
+                    col + 1 < width ? cell + 1 : area
+                };
+
+                for (unsigned int i = 0; i < 4; i++)
+                {
+                    unsigned int neighbour = neighbours[i];
+
+                    if (neighbour == area
+                            || labels[neighbour] != 0
+                            || !_is_poured(&pour, sandbox[neighbour / width][neighbour % width]))
+                    {
+                        continue;
+                    }
+
+                    labels[neighbour] = num_bodies;
+                    stack[stack_size++] = neighbour;
+                }
             }
+        }
+
+        if (!pour.is_gas)
+        {
+            num_liquid_bodies = num_bodies;
+        }
+    }
+
+    // Lift every body out, gathering the cells of each together, along with
+    // the deepest row of each.
+    unsigned int *body_ends = (unsigned int *) arena_allocate(&SCRATCH, (num_bodies + 1) * sizeof(unsigned int));
+    unsigned int *body_depths = (unsigned int *) arena_allocate(&SCRATCH, (num_bodies + 1) * sizeof(unsigned int));
+    unsigned int *cells = (unsigned int *) arena_allocate(&SCRATCH, area * sizeof(unsigned int));
+    unsigned char *tiles = (unsigned char *) arena_allocate(&SCRATCH, area * sizeof(unsigned char));
+
+    for (unsigned int cell = 0; cell < area; cell++)
+    {
+        unsigned int label = labels[cell];
+
+        if (label != 0)
+        {
+            unsigned int row = cell / width;
+            unsigned int depth = label > num_liquid_bodies ? height - 1 - row : row;
+
+            body_ends[label]++;
+            body_depths[label] = depth > body_depths[label] ? depth : body_depths[label];
+        }
+    }
+
+    // Count where each body's cells begin, which becomes where they end
+    // once gathered.
+    for (unsigned int label = 1, begin = 0; label <= num_bodies; label++)
+    {
+        unsigned int size = body_ends[label];
+        body_ends[label] = begin;
+        begin += size;
+    }
+
+    for (unsigned int cell = 0; cell < area; cell++)
+    {
+        unsigned int label = labels[cell];
+
+        if (label != 0)
+        {
+            unsigned char *tile = &sandbox[cell / width][cell % width];
+            cells[body_ends[label]] = cell;
+            tiles[body_ends[label]] = get_tile_id(*tile);
+            body_ends[label]++;
+            *tile = AIR;
+        }
+    }
+
+    // Pour liquids back in, then gases, deepest bodies first. Cells reached
+    // while pouring are tracked in labels, which is no longer needed.
+    unsigned int *body_order = (unsigned int *) arena_allocate(&SCRATCH, (num_bodies + 1) * sizeof(unsigned int));
+    unsigned int *depth_heads = (unsigned int *) arena_allocate(&SCRATCH, height * sizeof(unsigned int));
+
+    pour.reached = labels;
+    pour.pool_parents = (unsigned int *) arena_allocate(&SCRATCH, (num_bodies + 1) * sizeof(unsigned int));
+    pour.stack = stack;
+    pour.open_roots = (unsigned int *) arena_allocate(&SCRATCH, (num_bodies + 1) * sizeof(unsigned int));
+    pour.filled_roots = (unsigned int *) arena_allocate(&SCRATCH, (num_bodies + 1) * sizeof(unsigned int));
+    pour.heap_lefts = (unsigned int *) arena_allocate(&SCRATCH, area * sizeof(unsigned int));
+    pour.heap_rights = (unsigned int *) arena_allocate(&SCRATCH, area * sizeof(unsigned int));
+    pour.heap_ranks = (unsigned char *) arena_allocate(&SCRATCH, area * sizeof(unsigned char));
+
+    for (unsigned int phase = 0; phase < 2; phase++)
+    {
+        pour.is_gas = phase == 1;
+        memset(pour.reached, 0, area * sizeof(unsigned int));
+
+        unsigned int first = pour.is_gas ? num_liquid_bodies + 1 : 1;
+        unsigned int last = pour.is_gas ? num_bodies : num_liquid_bodies;
 
-            if (_tile_has_lift(current_tile))
+        // List the bodies by depth, linked through body_order.
+        memset(depth_heads, 0, height * sizeof(unsigned int));
+
+        for (unsigned int label = first; label <= last; label++)
+        {
+            body_order[label] = depth_heads[body_depths[label]];
+            depth_heads[body_depths[label]] = label;
+        }
+
+        for (unsigned int depth = height; depth-- > 0;)
+        {
+            for (unsigned int label = depth_heads[depth]; label != 0; label = body_order[label])
             {
-                do_lift(sandbox, height, width, row, col);
+                unsigned int begin = body_ends[label - 1];
+                _pour_body(&pour, label, &cells[begin], &tiles[begin], body_ends[label] - begin);
             }
-
-            // A swap could have just happened, so update the tile again to
-            // prevent updating a swapped tile.
-            set_tile_updated(&sandbox[row][col], SANDBOX_LIFETIME);
         }
     }
 
-    // For every frame of processing, the sandbox grows older.
-    SANDBOX_LIFETIME++;
+    reset_arena(&SCRATCH);
+
+    // Toppling grains marked tiles as moved, which would hold them back
+    // during the next frame.
+    _clear_moved_tiles(sandbox);
+    wake_sandbox(sandbox);
+
+    info -> frame_stats.swaps = frame_swaps;
 }
 
 
-unsigned char get_tile_id(unsigned char tile)
+void free_settle_scratch(void)
 {
-    // Use a mask of (0000 1111) to extract the first 4 bits.
-    unsigned char tile_mask = 0x0f;
-    unsigned char tile_id = tile_mask & tile;
+    free_arena(&SCRATCH);
+}
 
-    return tile_id;
+
+unsigned int get_rng_key(unsigned int current_time)
+{
+    return _mix_bits(SANDBOX_SEED ^ _mix_bits(get_rng_phase(current_time) + 1));
 }
 
 
-bool is_tile_updated(unsigned char tile, unsigned int current_time)
+unsigned int get_rng_phase(unsigned int current_time)
 {
-    // Shift the updated bit flag to the front, and compare.
-    unsigned char time_parity = get_time_parity(current_time);
-    unsigned char updated_flag = get_updated_flag(tile);
+    if (SANDBOX_RNG_PERIOD == SANDBOX_UNBOUNDED_RNG_PERIOD)
+    {
+        return current_time;
+    }
 
-    return updated_flag == time_parity;
+    return current_time % SANDBOX_RNG_PERIOD;
 }
 
 
-void set_tile_updated(unsigned char *tile, unsigned int current_time)
+unsigned char get_tile_id(unsigned char tile)
 {
-    unsigned char time_parity = get_time_parity(current_time);
-
-    // Masks of (0111 1111) and (1000 0000) for off/on switching of first bit.
-    unsigned char turn_off = 127;
-    unsigned char turn_on = 128;
+    // Use a mask of (0000 1111) to extract the first 4 bits.
+    unsigned char tile_mask = 0x0f;
+    unsigned char tile_id = tile_mask & tile;
 
-    // In the case of 0, we're updating a bit flag of 1 to 0, so we AND.
-    // In the case of 1, we're updating a bit flag of 0 to 1, so we OR.
-    if (time_parity == 0)
-    {
-        *tile &= turn_off;
-    }
-    else
-    {
-        *tile |= turn_on;
-    }
+    return tile_id;
 }
 
 
@@ -514,7 +3014,7 @@ void do_gravity(unsigned char **sandbox,
     // to go down at random by flipping a coin.
     if (can_slide_left && can_slide_right)
     {
-        bool heads = _flip_coin();
+        bool heads = _flip_coin(row_index, column_index);
 
         if (heads)
         {
@@ -624,7 +3124,7 @@ void do_lift(unsigned char **sandbox,
         // If we have a choice of left or right ascension, pick one at random.
         if (can_ascend_left && can_ascend_right)
         {
-            bool heads = _flip_coin();
+            bool heads = _flip_coin(row_index, column_index);
 
             if (heads)
             {
@@ -659,19 +3159,6 @@ void do_lift(unsigned char **sandbox,
 }
 
 
-unsigned char get_time_parity(unsigned int current_time)
-{
-    // Use a mask of (0000 ... 0001) to extract the first bit, granting parity.
-    return current_time & 1;
-}
-
-bool get_updated_flag(unsigned char tile)
-{
-    // The updated flag is the last bit of a tile.
-    return tile >> 7;
-}
-
-
 void print_sandbox(unsigned char **sandbox, unsigned int height, unsigned int width)
 {
     if (sandbox == NULL)
@@ -687,20 +3174,8 @@ void print_sandbox(unsigned char **sandbox, unsigned int height, unsigned int wi
         {
             unsigned char current_tile = sandbox[row][col];
 
-            if (get_tile_id(current_tile) == AIR)
-            {
-                putchar('-');
-            }
-
-            else if (get_tile_id(current_tile) == SAND)
-            {
-                putchar('O');
-            }
-
-            else if (get_tile_id(current_tile) == WATER)
-            {
-                putchar('_');
-            }
+            // Tiles not implemented yet print as '?'.
+            putchar("-O_#~^??????????"[get_tile_id(current_tile)]);
 
             if (col == width - 1)
             {
@@ -10,22 +10,315 @@
  * The first 4 significant bits are reserved for tile flags.
  * The last 4 bits represent a tile ID number, from 0 to 15.
  *
+ * Alongside its tiles, every sandbox keeps bookkeeping for each of the
+ * CHUNK_SIZE x CHUNK_SIZE chunks it is divided into, such as which tiles have
+ * moved during the current frame.
+ *
  */
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <stdbool.h>
 #include <math.h>
+#include <time.h>
+#include "memory.h"
 
 
 // Define the constant tile IDs 0 to 15.
 enum tile_id {AIR, SAND, WATER, WOOD, STEAM, FIRE};
 
 
+// Side length, in tiles, of the square chunks a sandbox is processed in.
+#define CHUNK_SIZE 16
+
+// Chunks within LOD_NEAR_MARGIN chunks of the view are updated every frame,
+// those within LOD_MID_MARGIN every LOD_MID_INTERVAL frames, and those further
+// away every LOD_FAR_INTERVAL frames.
+#define LOD_NEAR_MARGIN 1
+#define LOD_MID_MARGIN 4
+#define LOD_MID_INTERVAL 4
+#define LOD_FAR_INTERVAL 16
+
+// Chunks are either dense, visiting every tile each frame, or sparse, visiting
+// only tiles woken by movement next to them. A dense chunk in which fewer than
+// SPARSE_MOVED_THRESHOLD tiles moved during a frame turns sparse, and a sparse
+// chunk in which more than DENSE_MOVED_THRESHOLD tiles moved turns dense.
+// In between, chunks keep their mode, so they do not flip back and forth.
+#define SPARSE_MOVED_THRESHOLD 16
+#define DENSE_MOVED_THRESHOLD 64
+
+// Value of SANDBOX_RNG_PERIOD for a per-frame RNG key that never repeats,
+// derived from the whole of SANDBOX_LIFETIME.
+#define SANDBOX_UNBOUNDED_RNG_PERIOD 0
+
+
+// Bookkeeping kept for every chunk of a sandbox.
+struct Chunk
+{
+    // Frame during which moved_tiles was last written to. Bits written during
+    // any other frame are stale, and count as unset.
+    unsigned int frame_stamp;
+
+    // One bit per tile position of the chunk, row by row, set once a tile has
+    // moved into or out of that position during frame_stamp.
+    unsigned char moved_tiles[CHUNK_SIZE * CHUNK_SIZE / 8];
+
+    // One bit per tile position of the chunk, set whenever the position or
+    // one next to it changes, and cleared once a sparse chunk visits it.
+    // Tiles never woken cannot have anywhere new to move to.
+    unsigned char woken_tiles[CHUNK_SIZE * CHUNK_SIZE / 8];
+
+    // Whether only woken tiles are visited, rather than every tile.
+    bool is_sparse;
+
+    // Frame during which the chunk was last recorded in a change feed of
+    // CHANGES_CHUNKS granularity.
+    unsigned int change_stamp;
+
+    // XOR of the keys of every tile within the chunk, as given by
+    // get_tile_key().
+    unsigned long long hash;
+
+    // Value of the sandbox's state_epoch when a tile of the chunk last
+    // changed.
+    unsigned long modified_epoch;
+};
+
+
+// How finely a change feed describes the changes made to a sandbox.
+enum change_granularity
+{
+    // Every tile changed, with its value before and after.
+    CHANGES_TILES,
+
+    // Every chunk changed during a frame, once per frame.
+    CHANGES_CHUNKS
+};
+
+
+// A single record of a change feed. For CHANGES_CHUNKS, row and column are
+// those of the chunk, and the tiles are left as AIR.
+struct TileChange
+{
+    unsigned int row;
+    unsigned int column;
+    unsigned char old_tile;
+    unsigned char new_tile;
+};
+
+
+// Ring buffer of changes made to a sandbox, read by any number of consumers
+// each keeping their own cursor.
+struct ChangeFeed
+{
+    enum change_granularity granularity;
+
+    // Records, with the one numbered n stored at n % capacity.
+    struct TileChange *records;
+    unsigned int capacity;
+
+    // Number of the next record to write.
+    unsigned long head;
+
+    // Cursors before this number missed a change too large to record, and
+    // must treat the whole sandbox as changed.
+    unsigned long dirty_since;
+};
+
+
+// Counters describing the work done to simulate a sandbox.
+struct SandboxStats
+{
+    // Number of frames the counters cover.
+    unsigned int frames;
+
+    // Chunks processed in either mode, and chunks skipped for being far away
+    // from the view.
+    unsigned int dense_chunks;
+    unsigned int sparse_chunks;
+    unsigned int skipped_chunks;
+
+    // Non-air, non-static tiles simulated.
+    unsigned long tiles_visited;
+
+    // Swaps of neighbouring tiles made, counting runs of tiles shifted at
+    // once as the swaps shifting them tile by tile would take. Chunks
+    // replayed from the chunk cache make no swaps.
+    unsigned long swaps;
+
+    // Hash of the whole sandbox once the counted frames were completed, as
+    // given by get_world_hash().
+    unsigned long long world_hash;
+};
+
+
+// Bookkeeping kept for a sandbox as a whole, stored directly in front of the
+// row pointers returned by create_sandbox().
+struct SandboxInfo
+{
+    unsigned int height;
+    unsigned int width;
+
+    // Dimensions of sandbox in chunks, rounding up.
+    unsigned int chunk_rows;
+    unsigned int chunk_columns;
+
+    // Every tile of the sandbox in a single block, row by row, which the row
+    // pointers point into.
+    unsigned char *tiles;
+
+    // Whether the tiles are mapped from a file by map_file(), rather than
+    // allocated.
+    bool is_mapped;
+
+    // Every chunk of the sandbox, row by row.
+    struct Chunk *chunks;
+
+    // Counters of the frame in progress, and of the last one completed.
+    struct SandboxStats frame_stats;
+    struct SandboxStats last_stats;
+
+    // Changes made to the sandbox, or NULL if they are not recorded.
+    struct ChangeFeed *change_feed;
+
+    // XOR of the hashes of every chunk.
+    unsigned long long world_hash;
+
+    // Number of times a SandboxState was saved from the sandbox, plus one.
+    unsigned long state_epoch;
+
+    // Index of the next chunk to process within the current frame, counting
+    // chunks row by row. Non-zero only while a frame is partially processed.
+    unsigned int next_chunk;
+
+    // Subsystems the sandbox's tiles and chunks are accounted to.
+    enum memory_subsystem grid_subsystem;
+    enum memory_subsystem chunk_subsystem;
+};
+
+
+// Saved copy of a sandbox to restore it to, such as to roll it back a few
+// frames and simulate them again.
+struct SandboxState
+{
+    // Sandbox the state is saved from and restored to.
+    unsigned char **sandbox;
+
+    // Copy of every tile, row by row, and of every chunk's hash.
+    unsigned char *tiles;
+    unsigned long long *chunk_hashes;
+    unsigned long long world_hash;
+
+    // Values of the sandbox's globals.
+    unsigned int lifetime;
+    unsigned int seed;
+    unsigned int rng_period;
+
+    // State epoch of the sandbox when the state was saved, or 0 if never.
+    // Chunks modified during a later epoch differ from the copy.
+    unsigned long epoch;
+};
+
+
+// Work done to save or restore a SandboxState.
+struct StateCopyCost
+{
+    // Chunks copied, being those changed since the state was saved, and
+    // bytes of tiles they hold.
+    unsigned int chunks_copied;
+    unsigned long bytes_copied;
+
+    // Milliseconds spent saving or restoring.
+    double elapsed_ms;
+};
+
+
+// Rectangle of a sandbox being looked at, in tiles.
+struct SandboxView
+{
+    unsigned int row;
+    unsigned int column;
+    unsigned int height;
+    unsigned int width;
+};
+
+
+// Reasons step_sandbox_until() stopped stepping.
+enum stop_reason
+{
+    // The predicate asked to stop.
+    STOP_PREDICATE,
+
+    // Enough frames in a row moved no tile.
+    STOP_SETTLED,
+
+    // A frame simulated fewer tiles than the limit.
+    STOP_FEW_ACTIVE_TILES,
+
+    // The limit of frames was reached.
+    STOP_MAX_FRAMES,
+
+    // The time limit was reached.
+    STOP_TIME_LIMIT,
+
+    NUM_STOP_REASONS
+};
+
+
+// Criteria for step_sandbox_until() to stop at, checked after every frame in
+// the order given. Criteria left at 0 or NULL are ignored.
+struct StopCriteria
+{
+    // Number of frames in a row to move no tile, making no swaps and leaving
+    // the world hash as it was.
+    unsigned int still_frames;
+
+    // Number of tiles a frame must simulate fewer of, as counted by
+    // tiles_visited, being those not yet at rest.
+    unsigned long active_tiles_below;
+
+    // Frames to step at most, and milliseconds to spend at most, as measured
+    // by clock().
+    unsigned int max_frames;
+    double max_ms;
+
+    // Called after every frame with its counters, returning true to stop.
+    bool (*should_stop)(unsigned char **sandbox, const struct SandboxStats *stats, void *context);
+
+    // Passed to should_stop.
+    void *context;
+};
+
+
+// Outcome of step_sandbox_until().
+struct StepResult
+{
+    enum stop_reason reason;
+
+    // Frames stepped, and milliseconds spent stepping them.
+    unsigned int frames;
+    double elapsed_ms;
+};
+
+
 // Amount of time that has passed, in frames of simulation, since the sandbox
 // has begun.
 extern unsigned int SANDBOX_LIFETIME;
 
+// Seed all random choices within the simulation are derived from.
+extern unsigned int SANDBOX_SEED;
+
+// Number of frames after which the per-frame RNG key repeats itself, or
+// SANDBOX_UNBOUNDED_RNG_PERIOD, the default, for a key that never repeats.
+//
+// Recurring patterns can only recur exactly if their random choices do too,
+// so the chunk cache only pays off with a short period, and enabling it sets
+// CHUNK_CACHE_RNG_PERIOD unless a period was set already. The price is that
+// every random choice then repeats with the period too, such as liquids
+// spreading in the same pattern, which longer periods make less visible.
+extern unsigned int SANDBOX_RNG_PERIOD;
+
 
 /*
  * Generate and allocate memory for an empty 2D sandbox of tiles with dimension
@@ -36,11 +329,47 @@ extern unsigned int SANDBOX_LIFETIME;
  * @param height - Vertical length of 2D sandbox.
  * @param width - Horizontal length of 2D sandbox.
  *
- * @return - Pointer to allocated 2D array of bytes representing a sandbox.
+ * @return - Pointer to allocated 2D array of bytes representing a sandbox, or
+ * NULL if there was not enough memory for it.
  */
 unsigned char **create_sandbox(unsigned int height, unsigned int width);
 
 
+/*
+ * Create a sandbox whose tiles are mapped copy-on-write from a file with
+ * map_file(), such as the tiles of a save file. Pages of tiles are shared
+ * with every other sandbox mapping the same file until written to, so each
+ * sandbox only holds its own copies of the pages where tiles changed.
+ *
+ * Such sandboxes are freed with sandbox_free() like any other, which leaves
+ * the file as it was.
+ *
+ * @param path - Path of file to map.
+ * @param offset - Offset in bytes of the tiles within the file, row by row.
+ * @param height, width - Dimensions of sandbox.
+ * @param chunk_hashes - Hash of each chunk of the tiles, row by row, as
+ * computed by a sandbox mapping the file before, or NULL to compute them.
+ * Given hashes spare reading every tile.
+ *
+ * @return - Newly created sandbox, or NULL if the file could not be mapped.
+ */
+unsigned char **map_sandbox(const char *path,
+        size_t offset,
+        unsigned int height,
+        unsigned int width,
+        const unsigned long long *chunk_hashes);
+
+
+/*
+ * Obtain the bookkeeping kept alongside the given sandbox.
+ *
+ * @param sandbox - Sandbox created by create_sandbox().
+ *
+ * @return - Pointer to the sandbox's bookkeeping.
+ */
+struct SandboxInfo *get_sandbox_info(unsigned char **sandbox);
+
+
 /*
  * Free all memory taken up by the given sandbox simulation.
  *
@@ -50,10 +379,244 @@ unsigned char **create_sandbox(unsigned int height, unsigned int width);
 void sandbox_free(unsigned char **sandbox, unsigned int height, unsigned int width);
 
 
+/*
+ * Account the memory of a sandbox, tiles and chunks alike, to a subsystem
+ * other than the grid, such as that of snapshots for a copy kept for display.
+ *
+ * @param sandbox - Sandbox to account.
+ * @param subsystem - Subsystem to account it to.
+ */
+void set_sandbox_memory_subsystem(unsigned char **sandbox, enum memory_subsystem subsystem);
+
+
+/*
+ * Obtain the counters of the most recently completed call to one of the
+ * process_sandbox() family of functions on the given sandbox.
+ *
+ * A frame split over several calls to process_sandbox_budgeted() counts as a
+ * single call, while process_sandbox_blocked() counts all of its frames.
+ *
+ * @param sandbox - Sandbox to obtain counters of.
+ *
+ * @return - Copy of the sandbox's counters.
+ */
+struct SandboxStats get_sandbox_stats(unsigned char **sandbox);
+
+
+/*
+ * Return a hash of every tile of the sandbox, in constant time.
+ *
+ * The hash is kept up to date as tiles change, and only depends on the tiles
+ * themselves. Sandboxes holding the same tiles have the same hash, however
+ * they came to hold them, which makes it suited to checking replays and
+ * simulations run elsewhere for desyncs.
+ *
+ * @param sandbox - Sandbox to hash.
+ *
+ * @return - Hash of sandbox, 0 for a sandbox of air.
+ */
+unsigned long long get_world_hash(unsigned char **sandbox);
+
+
+/*
+ * Return the key a tile contributes to the hashes of its chunk and sandbox,
+ * which are the XOR of the keys of each of their tiles.
+ *
+ * @param tile_index - Index of tile within sandbox, counting row by row.
+ * @param tile - Tile at that index.
+ *
+ * @return - Key of tile, 0 for air.
+ */
+unsigned long long get_tile_key(unsigned long tile_index, unsigned char tile);
+
+
+/*
+ * Write a tile into the sandbox from outside of the simulation, such as the
+ * user placing it, waking it like wake_tile() and recording it in the change
+ * feed.
+ *
+ * @param sandbox - Sandbox to write into.
+ * @param row_index, column_index - Coordinates of tile to write.
+ * @param tile - Tile to write.
+ */
+void edit_tile(unsigned char **sandbox, unsigned int row_index, unsigned int column_index, unsigned char tile);
+
+
+/*
+ * Notify the sandbox that the tile at the given coordinates was changed by
+ * something other than the simulation itself, having been written directly.
+ *
+ * Sparse chunks only visit tiles next to recent changes, so a tile written
+ * directly into the sandbox may otherwise never start moving.
+ *
+ * What the tile was before is unknown, so any change feed is marked as
+ * having everything changed, and the hash of the tile's chunk is computed
+ * anew. Prefer edit_tile() where possible.
+ *
+ * @param sandbox - Sandbox containing tile.
+ * @param row_index, column_index - Coordinates of changed tile.
+ */
+void wake_tile(unsigned char **sandbox, unsigned int row_index, unsigned int column_index);
+
+
+/*
+ * Notify the sandbox that the tiles within a rectangle were changed by
+ * something other than the simulation itself, like wake_tile() for each of
+ * them, but waking and hashing every chunk the rectangle touches only once.
+ *
+ * Any change feed of tiles is marked as having everything changed, while a
+ * change feed of chunks records each chunk touched.
+ *
+ * @param sandbox - Sandbox containing rectangle.
+ * @param row_index, column_index - Coordinates of top left tile of rectangle.
+ * @param region_height, region_width - Dimensions of rectangle, lying within
+ * the sandbox.
+ */
+void wake_region(unsigned char **sandbox,
+        unsigned int row_index,
+        unsigned int column_index,
+        unsigned int region_height,
+        unsigned int region_width);
+
+
+/*
+ * Notify the sandbox that any of its tiles may have been changed by something
+ * other than the simulation itself, like wake_tile() for every tile.
+ *
+ * Any change feed is marked as having everything changed, and every hash is
+ * computed anew.
+ *
+ * @param sandbox - Sandbox whose tiles to wake.
+ */
+void wake_sandbox(unsigned char **sandbox);
+
+
+/*
+ * Start recording every change made to the given sandbox, by the simulation
+ * or otherwise, replacing any change feed it already had.
+ *
+ * Consumers read changes with read_changes(), starting from the cursor given
+ * by get_change_cursor(). Changes too many or too large to record, such as
+ * settle_sandbox() rearranging everything at once, instead make every
+ * consumer treat the whole sandbox as changed.
+ *
+ * @param sandbox - Sandbox to record changes of.
+ * @param granularity - Whether to record tiles or chunks.
+ * @param capacity - Number of records kept. A consumer falling further behind
+ * than this misses changes, and must treat the whole sandbox as changed.
+ * If 0, changes stop being recorded.
+ */
+void set_change_feed(unsigned char **sandbox, enum change_granularity granularity, unsigned int capacity);
+
+
+/*
+ * Return a cursor for reading only changes made from now on.
+ *
+ * @param sandbox - Sandbox with a change feed.
+ *
+ * @return - Cursor for read_changes().
+ */
+unsigned long get_change_cursor(unsigned char **sandbox);
+
+
+/*
+ * Read the changes recorded since the given cursor, oldest first, and move
+ * the cursor past those read.
+ *
+ * @param sandbox - Sandbox with a change feed.
+ * @param cursor - Cursor to read from, moved past the changes read.
+ * @param changes - Filled with the changes read.
+ * @param max_changes - Maximum number of changes to read.
+ * @param num_read - Set to the number of changes read.
+ *
+ * @return - True if the changes read are all that changed, false if changes
+ * were missed and the whole sandbox must be treated as changed. The cursor
+ * is then moved to the latest change, with nothing read.
+ */
+bool read_changes(unsigned char **sandbox,
+        unsigned long *cursor,
+        struct TileChange *changes,
+        unsigned int max_changes,
+        unsigned int *num_read);
+
+
+/*
+ * Copy every tile of one sandbox into another of the same dimensions, along
+ * with their hashes.
+ *
+ * @param destination - Sandbox to overwrite.
+ * @param source - Sandbox to copy tiles from.
+ * @param height, width - Dimensions of both sandboxes.
+ */
+void copy_sandbox(unsigned char **destination,
+        unsigned char **source,
+        unsigned int height,
+        unsigned int width);
+
+
+/*
+ * Allocate a state the given sandbox can be saved to and restored from. A
+ * state holds a whole copy of the sandbox, so saving and restoring never
+ * allocates.
+ *
+ * @param sandbox - Sandbox to save states of.
+ *
+ * @return - State of sandbox, holding air until saved. The first save copies
+ * every chunk, however the sandbox was created.
+ */
+struct SandboxState *create_sandbox_state(unsigned char **sandbox);
+
+
+/*
+ * Free all memory used by a state created by create_sandbox_state().
+ *
+ * @param state - State to free.
+ */
+void free_sandbox_state(struct SandboxState *state);
+
+
+/*
+ * Save the current tiles of a state's sandbox into it, along with the
+ * sandbox's globals.
+ *
+ * Only chunks changed since the state was last saved are copied, so keeping
+ * a few states saved every frame, such as for rolling back, costs little
+ * more than the chunks which actually change.
+ *
+ * @param state - State to save into.
+ * @param cost - Set to the work done, unless NULL.
+ *
+ * @return - True if saved, false if a frame is in progress.
+ */
+bool save_sandbox_state(struct SandboxState *state, struct StateCopyCost *cost);
+
+
+/*
+ * Restore a state's sandbox to how it was when the state was saved, along
+ * with the sandbox's globals. Simulating it then goes exactly as it did
+ * after the state was saved.
+ *
+ * Only chunks changed since the state was saved are copied back.
+ *
+ * @param state - State to restore, which must have been saved.
+ * @param cost - Set to the work done, unless NULL.
+ *
+ * @return - True if restored, false if a frame is in progress.
+ */
+bool restore_sandbox_state(struct SandboxState *state, struct StateCopyCost *cost);
+
+
 /*
  * Perform one full iteration of simulation on the given sandbox, applying 
  * any tile interations, flow, gravity, etc.
  *
+ * The sandbox is processed one CHUNK_SIZE x CHUNK_SIZE chunk at a time, with
+ * chunks and the tiles within them visited row by row. Mostly still chunks
+ * skip over tiles with nowhere new to move to, see SPARSE_MOVED_THRESHOLD.
+ *
+ * Tiles changed directly rather than through the simulation must be passed
+ * to wake_tile() or wake_sandbox() before the next call.
+ *
  * @param sandbox - Sandbox to simulate.
  * @param height, width - Dimensions of sandbox.
  */
@@ -61,39 +624,213 @@ void process_sandbox(unsigned char **sandbox, unsigned int height, unsigned int
 
 
 /*
- * Return the ID number of a tile, ranging from 0 to 15.
+ * Perform one full iteration of simulation on the given sandbox, like
+ * process_sandbox(), but spend less time on chunks far away from the given
+ * view.
  *
- * @param tile - Tile number, represented as a byte, to fetch ID number of.
+ * Chunks near the view are updated every frame, chunks further away only
+ * every few frames, as decided by get_chunk_update_interval(). Tiles outside
+ * the view therefore move more slowly than those inside it.
  *
- * @return - Value from 0 to 15 representing the type of tile given.
+ * @param sandbox - Sandbox to simulate.
+ * @param height, width - Dimensions of sandbox.
+ * @param view - Part of the sandbox being looked at. If NULL, every chunk is
+ * updated every frame.
  */
-unsigned char get_tile_id(unsigned char tile);
+void process_sandbox_in_view(unsigned char **sandbox,
+        unsigned int height,
+        unsigned int width,
+        const struct SandboxView *view);
+
+
+/*
+ * Perform as much of one iteration of simulation on the given sandbox as fits
+ * in the given time budget, like process_sandbox_in_view().
+ *
+ * Chunks are processed until the budget runs out, at which point this function
+ * returns. The next call then resumes the very same frame from the next chunk
+ * onwards, so a frame split over several calls has the same result as one
+ * processed in a single call. At least one chunk is processed per call.
+ *
+ * While a frame is partially processed, the sandbox holds a mix of processed
+ * and unprocessed chunks, and should not be displayed. Each sandbox keeps its
+ * own progress, so others may be processed in between, as long as
+ * SANDBOX_LIFETIME and the other globals are theirs meanwhile.
+ *
+ * @param sandbox - Sandbox to simulate.
+ * @param height, width - Dimensions of sandbox.
+ * @param view - Part of the sandbox being looked at, or NULL.
+ * @param budget_ms - Time in milliseconds to spend processing. If negative,
+ * the frame is always completed.
+ *
+ * @return - True if the frame was completed, false if it is still partial.
+ */
+bool process_sandbox_budgeted(unsigned char **sandbox,
+        unsigned int height,
+        unsigned int width,
+        const struct SandboxView *view,
+        double budget_ms);
+
+
+/*
+ * Perform the given number of iterations of simulation on the given sandbox,
+ * with the same result as calling process_sandbox_in_view() that many times.
+ *
+ * Rather than sweeping the whole sandbox once per frame, a single sweep runs
+ * down the sandbox advancing all frames at once, with each frame trailing two
+ * rows of chunks behind the frame before it. Only those rows are worked on at
+ * any one time, so tiles stay in cache across frames rather than the whole
+ * sandbox streaming through memory every frame.
+ *
+ * Any frame left partially processed by process_sandbox_budgeted() is
+ * completed first, and does not count towards the given number of frames.
+ *
+ * @param sandbox - Sandbox to simulate.
+ * @param height, width - Dimensions of sandbox.
+ * @param view - Part of the sandbox being looked at, or NULL.
+ * @param num_frames - Number of frames to advance the sandbox by.
+ */
+void process_sandbox_blocked(unsigned char **sandbox,
+        unsigned int height,
+        unsigned int width,
+        const struct SandboxView *view,
+        unsigned int num_frames);
+
+
+/*
+ * Simulate the given sandbox one frame at a time, as with process_sandbox(),
+ * until any of the given criteria is met, such as once it has come to rest.
+ *
+ * At least one frame is always simulated, and at least one criterion must be
+ * given, or stepping never stops.
+ *
+ * @param sandbox - Sandbox to simulate.
+ * @param height, width - Dimensions of sandbox.
+ * @param criteria - Criteria to stop at.
+ *
+ * @return - Why stepping stopped, after how many frames and how long.
+ */
+struct StepResult step_sandbox_until(unsigned char **sandbox,
+        unsigned int height,
+        unsigned int width,
+        const struct StopCriteria *criteria);
+
+
+/*
+ * Return the name of a reason to stop stepping, such as for reports.
+ *
+ * @param reason - Reason to name.
+ *
+ * @return - Name of reason.
+ */
+const char *get_stop_reason_name(enum stop_reason reason);
+
+
+/*
+ * Return whether a frame of the given sandbox was left partially processed
+ * by process_sandbox_budgeted().
+ *
+ * @param sandbox - Sandbox to check.
+ *
+ * @return - True if a frame is in progress, false otherwise.
+ */
+bool is_sandbox_mid_frame(unsigned char **sandbox);
+
+
+/*
+ * Return how far process_sandbox_budgeted() has got through the current frame
+ * of the given sandbox.
+ *
+ * Edits made to the sandbox between calls land at this point of the frame, so
+ * replaying them at the same point reproduces the frame exactly.
+ *
+ * @param sandbox - Sandbox to check.
+ *
+ * @return - Number of chunks, counting row by row, the frame has moved past.
+ * 0 if no frame is in progress.
+ */
+unsigned int get_sandbox_frame_progress(unsigned char **sandbox);
+
+
+/*
+ * Return how often the chunk at the given chunk coordinates is updated by
+ * process_sandbox_in_view(), depending on its distance from the view.
+ *
+ * @param view - Part of the sandbox being looked at, or NULL.
+ * @param chunk_row, chunk_column - Coordinates of chunk, in chunks.
+ *
+ * @return - 1 if the chunk is updated every frame, otherwise the number of
+ * frames between updates of the chunk.
+ */
+unsigned int get_chunk_update_interval(const struct SandboxView *view,
+        unsigned int chunk_row,
+        unsigned int chunk_column);
+
+
+/*
+ * Bring the given sandbox directly to rest, rather than simulating the many
+ * frames it would take for everything to fall and level out.
+ *
+ * Within every column, granular tiles such as sand are compacted down onto
+ * the nearest fixed tile (such as wood) or the sandbox floor beneath them,
+ * and gases rise to the top, after which columns standing too tall topple
+ * into piles. Every connected body of liquid is then lifted out and poured
+ * back in from the lowest level it can reach by falling and sliding, so it
+ * only spills into a neighbouring basin once it rises to the brim between
+ * them, as it would when simulated. Gases are poured the same way, upwards.
+ *
+ * Compaction takes time proportional to the sandbox's area, toppling takes
+ * time proportional to how far grains tumble, and refilling takes time
+ * proportional to the area times the logarithm of the area reached. Scratch
+ * space is kept between calls, growing to fit the most any settle has needed.
+ *
+ * @param sandbox - Sandbox to bring to rest.
+ * @param height, width - Dimensions of sandbox.
+ */
+void settle_sandbox(unsigned char **sandbox, unsigned int height, unsigned int width);
+
+
+/*
+ * Release the scratch space kept between calls to settle_sandbox(), which
+ * grows to fit the largest sandbox settled.
+ */
+void free_settle_scratch(void);
 
 
 /*
- * Determine whether the given tile has already been updated or not in the
- * current pass of the sandbox, as determined by current_time.
+ * Return the key all random choices made during the given frame derive from.
  *
- * When a tile is updated, its updated flag is changed to match the parity of 
- * the time that has passed since the simulation began.
+ * Random choices are a pure function of this key and the position of the tile
+ * making them, rather than of some global generator state.
  *
- * @param tile - Tile to determine whether it has been updated or not.
  * @param current_time - Time that has passed in frames inside the simulation.
  *
- * @return - 1 if the tile has already been updated, 0 otherwise.
+ * @return - Key derived from SANDBOX_SEED and the frame's place within
+ * SANDBOX_RNG_PERIOD.
  */
-bool is_tile_updated(unsigned char tile, unsigned int current_time);
+unsigned int get_rng_key(unsigned int current_time);
 
 
 /*
- * Mutate the given tile's updated flag to show the tile has been updated.
- * This syncs the tile's flag to match the parity of the current simulation 
- * time.
+ * Return the place of a frame within SANDBOX_RNG_PERIOD, which frames with
+ * the same random choices share.
  *
- * @param tile - Pointer to tile to whose flag will be set.
  * @param current_time - Time that has passed in frames inside the simulation.
+ *
+ * @return - Frames since the period last started, or current_time itself if
+ * the period is unbounded.
+ */
+unsigned int get_rng_phase(unsigned int current_time);
+
+
+/*
+ * Return the ID number of a tile, ranging from 0 to 15.
+ *
+ * @param tile - Tile number, represented as a byte, to fetch ID number of.
+ *
+ * @return - Value from 0 to 15 representing the type of tile given.
  */
-void set_tile_updated(unsigned char *tile, unsigned int current_time);
+unsigned char get_tile_id(unsigned char tile);
 
 
 /*
@@ -185,35 +922,11 @@ void do_lift(unsigned char **sandbox,
         unsigned int column_index);
 
 
-/*
- * Determine the parity of the given current time.
- *
- * @param current_time - Time that has passed in frames since the sim began.
- *
- * @return - 0 if the time is even, 1 if the time is odd.
- */
-unsigned char get_time_parity(unsigned int current_time);
-
-
-/*
- * Obtain the updated flag from a tile, synced to the parity of the time from
- * when it was last updated.
- *
- * The updated flag on its own does NOT say whether the tile is currently
- * updated or not. The flag represents a parity, it is NOT a boolean.
- *
- * Use is_tile_updated() to determine whether a tile is updated or not.
- *
- * @param tile - Tile to get updated flag from.
- */
-bool get_updated_flag(unsigned char tile);
-
-
 /*
  * Print a string representation of a 2D sandbox to stdout.
  *
- * A sandbox is represented as a string by a '-' denoting air, 'O' sand, 
- * '_' water.
+ * A sandbox is represented as a string by a '-' denoting air, 'O' sand,
+ * '_' water, '#' wood, '~' steam, '^' fire and '?' any other tile.
  *
  * @param sandbox - Sandbox to print to stdout.
  * @param height, width - Dimensions of the given sandbox.
@@ -0,0 +1,635 @@
+/*
+ * Python extension module "sand", wrapping the sandbox simulation of
+ * sandbox.h for use from Python.
+ *
+ * A sand.Sandbox supports the buffer protocol, exposing its tiles as a
+ * writable height x width array of bytes without copying them:
+ *
+ *     import numpy, sand
+ *     world = sand.Sandbox(256, 256, seed=1)
+ *     world.paint(numpy.random.rand(256, 256) < 0.1, sand.SAND)
+ *     world.step(100)
+ *     tiles = numpy.asarray(world) & sand.TILE_ID_MASK
+ *
+ * Arrays taken this way are live views of the sandbox, and change as it is
+ * simulated. Sandbox.snapshot() makes an independent copy to view instead.
+ * Writing tiles through a view goes unnoticed by the simulation until
+ * Sandbox.wake() is called, unlike with paint(). A sandbox cannot be
+ * initialized again while any view of it is alive.
+ *
+ * Sandbox.step() releases the GIL while simulating. The simulation's clock
+ * and seed are globals of sandbox.h, so each sandbox keeps its own and swaps
+ * them in while it is simulated, with one sandbox simulated at a time.
+ *
+ */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include "sandbox.h"
+
+
+typedef struct
+{
+    PyObject_HEAD
+    unsigned char **sandbox;
+    unsigned int height;
+    unsigned int width;
+
+    // Values of the globals of sandbox.h while this sandbox is simulated.
+    unsigned int lifetime;
+    unsigned int seed;
+    unsigned int rng_period;
+
+    // Set while the GIL is released to simulate the sandbox, during which
+    // nothing else may change it.
+    bool is_busy;
+
+    // Number of buffers handed out through the buffer protocol and not yet
+    // released, during which the tiles must stay where they are.
+    Py_ssize_t num_exports;
+
+    // Shape and strides handed out through the buffer protocol.
+    Py_ssize_t shape[2];
+    Py_ssize_t strides[2];
+} SandboxObject;
+
+
+// Held while any sandbox has its values swapped into the globals of sandbox.h.
+static PyThread_type_lock SIMULATION_LOCK = NULL;
+
+
+// ----- PRIVATE FUNCTIONS -----
+
+
+/*
+ * Swap the given sandbox's clock and seed into the globals of sandbox.h,
+ * waiting until no other sandbox is being simulated. Must be called without
+ * holding the GIL.
+ *
+ * @param self - Sandbox about to be simulated.
+ */
+static void _begin_simulation(SandboxObject *self)
+{
+    PyThread_acquire_lock(SIMULATION_LOCK, WAIT_LOCK);
+
+    SANDBOX_LIFETIME = self -> lifetime;
+    SANDBOX_SEED = self -> seed;
+    SANDBOX_RNG_PERIOD = self -> rng_period;
+}
+
+
+/*
+ * Swap the globals of sandbox.h back out into the given sandbox, letting
+ * other sandboxes be simulated.
+ *
+ * @param self - Sandbox done being simulated.
+ */
+static void _end_simulation(SandboxObject *self)
+{
+    self -> lifetime = SANDBOX_LIFETIME;
+    self -> seed = SANDBOX_SEED;
+    self -> rng_period = SANDBOX_RNG_PERIOD;
+
+    PyThread_release_lock(SIMULATION_LOCK);
+}
+
+
+/*
+ * Raise an error if the given sandbox is being simulated by another thread.
+ *
+ * @param self - Sandbox about to be used.
+ *
+ * @return - True if the sandbox is free to use, false with an error set.
+ */
+static bool _check_not_busy(SandboxObject *self)
+{
+    if (self -> is_busy)
+    {
+        PyErr_SetString(PyExc_RuntimeError, "sandbox is being simulated by another thread");
+        return false;
+    }
+
+    return true;
+}
+
+
+/*
+ * Raise an error if the given sandbox was never initialized, such as by a
+ * subclass not calling Sandbox.__init__().
+ *
+ * @param self - Sandbox about to be used.
+ *
+ * @return - True if the sandbox has tiles, false with an error set.
+ */
+static bool _check_initialized(SandboxObject *self)
+{
+    if (self -> sandbox == NULL)
+    {
+        PyErr_SetString(PyExc_RuntimeError, "sandbox is not initialized");
+        return false;
+    }
+
+    return true;
+}
+
+
+static int Sandbox_init(SandboxObject *self, PyObject *args, PyObject *kwargs)
+{
+    static char *keywords[] = {"height", "width", "seed", NULL};
+    unsigned int height;
+    unsigned int width;
+    unsigned int seed = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "II|I", keywords, &height, &width, &seed))
+    {
+        return -1;
+    }
+
+    if (height == 0 || width == 0)
+    {
+        PyErr_SetString(PyExc_ValueError, "sandbox dimensions must be positive");
+        return -1;
+    }
+
+    // Initializing again frees the tiles, which views and simulating
+    // threads still point into.
+    if (!_check_not_busy(self))
+    {
+        return -1;
+    }
+
+    if (self -> num_exports > 0)
+    {
+        PyErr_SetString(PyExc_BufferError, "sandbox cannot be initialized again while it is viewed");
+        return -1;
+    }
+
+    unsigned char **sandbox = create_sandbox(height, width);
+
+    if (sandbox == NULL)
+    {
+        PyErr_NoMemory();
+        return -1;
+    }
+
+    if (self -> sandbox != NULL)
+    {
+        sandbox_free(self -> sandbox, self -> height, self -> width);
+    }
+
+    self -> sandbox = sandbox;
+    self -> height = height;
+    self -> width = width;
+    self -> lifetime = 0;
+    self -> seed = seed;
+    self -> rng_period = SANDBOX_RNG_PERIOD;
+    self -> is_busy = false;
+
+    self -> shape[0] = height;
+    self -> shape[1] = width;
+    self -> strides[0] = width;
+    self -> strides[1] = 1;
+
+    return 0;
+}
+
+
+static void Sandbox_dealloc(SandboxObject *self)
+{
+    if (self -> sandbox != NULL)
+    {
+        sandbox_free(self -> sandbox, self -> height, self -> width);
+    }
+
+    Py_TYPE(self) -> tp_free((PyObject *) self);
+}
+
+
+static int Sandbox_getbuffer(SandboxObject *self, Py_buffer *view, int flags)
+{
+    if (self -> sandbox == NULL)
+    {
+        PyErr_SetString(PyExc_BufferError, "sandbox is not initialized");
+        view -> obj = NULL;
+        return -1;
+    }
+
+    // Tiles are a single C contiguous block, which satisfies every request.
+    view -> obj = Py_NewRef((PyObject *) self);
+    view -> buf = get_sandbox_info(self -> sandbox) -> tiles;
+    view -> len = (Py_ssize_t) self -> height * self -> width;
+    view -> readonly = 0;
+    view -> itemsize = 1;
+    view -> format = (flags & PyBUF_FORMAT) ? "B" : NULL;
+    view -> shape = (flags & PyBUF_ND) ? self -> shape : NULL;
+    view -> ndim = view -> shape != NULL ? 2 : 1;
+    view -> strides = (flags & PyBUF_STRIDES) == PyBUF_STRIDES ? self -> strides : NULL;
+    view -> suboffsets = NULL;
+    view -> internal = NULL;
+
+    self -> num_exports++;
+
+    return 0;
+}
+
+
+static void Sandbox_releasebuffer(SandboxObject *self, Py_buffer *view)
+{
+    self -> num_exports--;
+}
+
+
+static PyObject *Sandbox_step(SandboxObject *self, PyObject *args)
+{
+    unsigned int num_frames = 1;
+
+    if (!PyArg_ParseTuple(args, "|I", &num_frames) || !_check_initialized(self) || !_check_not_busy(self))
+    {
+        return NULL;
+    }
+
+    self -> is_busy = true;
+
+    Py_BEGIN_ALLOW_THREADS
+    _begin_simulation(self);
+
+    for (unsigned int frame = 0; frame < num_frames; frame++)
+    {
+        process_sandbox(self -> sandbox, self -> height, self -> width);
+    }
+
+    _end_simulation(self);
+    Py_END_ALLOW_THREADS
+
+    self -> is_busy = false;
+
+    Py_RETURN_NONE;
+}
+
+
+static PyObject *Sandbox_step_until(SandboxObject *self, PyObject *args, PyObject *kwargs)
+{
+    static char *keywords[] = {"still_frames", "active_below", "max_frames", "max_ms", NULL};
+    struct StopCriteria criteria = {0};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|IkId", keywords, &criteria.still_frames,
+            &criteria.active_tiles_below, &criteria.max_frames, &criteria.max_ms) || !_check_initialized(self) || !_check_not_busy(self))
+    {
+        return NULL;
+    }
+
+    if (criteria.still_frames == 0 && criteria.active_tiles_below == 0 && criteria.max_frames == 0
+            && criteria.max_ms <= 0)
+    {
+        PyErr_SetString(PyExc_ValueError, "at least one criterion to stop at must be given");
+        return NULL;
+    }
+
+    self -> is_busy = true;
+
+    struct StepResult result;
+
+    Py_BEGIN_ALLOW_THREADS
+    _begin_simulation(self);
+    result = step_sandbox_until(self -> sandbox, self -> height, self -> width, &criteria);
+    _end_simulation(self);
+    Py_END_ALLOW_THREADS
+
+    self -> is_busy = false;
+
+    return Py_BuildValue("(sI)", get_stop_reason_name(result.reason), result.frames);
+}
+
+
+static PyObject *Sandbox_settle(SandboxObject *self, PyObject *unused)
+{
+    if (!_check_initialized(self) || !_check_not_busy(self))
+    {
+        return NULL;
+    }
+
+    self -> is_busy = true;
+
+    Py_BEGIN_ALLOW_THREADS
+    _begin_simulation(self);
+    settle_sandbox(self -> sandbox, self -> height, self -> width);
+    _end_simulation(self);
+    Py_END_ALLOW_THREADS
+
+    self -> is_busy = false;
+
+    Py_RETURN_NONE;
+}
+
+
+static PyObject *Sandbox_paint(SandboxObject *self, PyObject *args)
+{
+    PyObject *mask_object;
+    unsigned int tile;
+
+    if (!PyArg_ParseTuple(args, "OI", &mask_object, &tile) || !_check_initialized(self) || !_check_not_busy(self))
+    {
+        return NULL;
+    }
+
+    if (tile > 0xFF)
+    {
+        PyErr_SetString(PyExc_ValueError, "tile must fit in a byte");
+        return NULL;
+    }
+
+    Py_buffer mask;
+
+    if (PyObject_GetBuffer(mask_object, &mask, PyBUF_C_CONTIGUOUS) != 0)
+    {
+        return NULL;
+    }
+
+    if (mask.itemsize != 1 || mask.len != (Py_ssize_t) self -> height * self -> width)
+    {
+        PyBuffer_Release(&mask);
+        PyErr_SetString(PyExc_ValueError, "mask must hold one byte for every tile of the sandbox");
+        return NULL;
+    }
+
+    const unsigned char *mask_bytes = (const unsigned char *) mask.buf;
+    unsigned long num_painted = 0;
+
+    for (unsigned int row = 0; row < self -> height; row++)
+    {
+        for (unsigned int col = 0; col < self -> width; col++)
+        {
+            if (!mask_bytes[(size_t) row * self -> width + col])
+            {
+                continue;
+            }
+
+            edit_tile(self -> sandbox, row, col, tile);
+            num_painted++;
+        }
+    }
+
+    PyBuffer_Release(&mask);
+
+    return PyLong_FromUnsignedLong(num_painted);
+}
+
+
+static PyObject *Sandbox_snapshot(SandboxObject *self, PyObject *unused)
+{
+    if (!_check_initialized(self) || !_check_not_busy(self))
+    {
+        return NULL;
+    }
+
+    SandboxObject *copy = (SandboxObject *) PyObject_CallFunction((PyObject *) Py_TYPE(self),
+            "II", self -> height, self -> width);
+
+    if (copy == NULL)
+    {
+        return NULL;
+    }
+
+    if (!_check_initialized(copy))
+    {
+        Py_DECREF(copy);
+        return NULL;
+    }
+
+    copy_sandbox(copy -> sandbox, self -> sandbox, self -> height, self -> width);
+    copy -> lifetime = self -> lifetime;
+    copy -> seed = self -> seed;
+    copy -> rng_period = self -> rng_period;
+
+    return (PyObject *) copy;
+}
+
+
+static PyObject *Sandbox_stats(SandboxObject *self, PyObject *unused)
+{
+    if (!_check_initialized(self))
+    {
+        return NULL;
+    }
+
+    struct SandboxStats stats = get_sandbox_stats(self -> sandbox);
+
+    return Py_BuildValue("{s:I,s:I,s:I,s:I,s:k,s:k,s:K}",
+            "frames", stats.frames,
+            "dense_chunks", stats.dense_chunks,
+            "sparse_chunks", stats.sparse_chunks,
+            "skipped_chunks", stats.skipped_chunks,
+            "tiles_visited", stats.tiles_visited,
+            "swaps", stats.swaps,
+            "world_hash", stats.world_hash);
+}
+
+
+static PyObject *Sandbox_wake(SandboxObject *self, PyObject *unused)
+{
+    if (!_check_initialized(self) || !_check_not_busy(self))
+    {
+        return NULL;
+    }
+
+    wake_sandbox(self -> sandbox);
+
+    Py_RETURN_NONE;
+}
+
+
+static PyObject *Sandbox_get_height(SandboxObject *self, void *closure)
+{
+    return PyLong_FromUnsignedLong(self -> height);
+}
+
+
+static PyObject *Sandbox_get_width(SandboxObject *self, void *closure)
+{
+    return PyLong_FromUnsignedLong(self -> width);
+}
+
+
+static PyObject *Sandbox_get_lifetime(SandboxObject *self, void *closure)
+{
+    return PyLong_FromUnsignedLong(self -> lifetime);
+}
+
+
+static PyObject *Sandbox_get_seed(SandboxObject *self, void *closure)
+{
+    return PyLong_FromUnsignedLong(self -> seed);
+}
+
+
+static PyObject *Sandbox_get_world_hash(SandboxObject *self, void *closure)
+{
+    if (!_check_initialized(self))
+    {
+        return NULL;
+    }
+
+    return PyLong_FromUnsignedLongLong(get_world_hash(self -> sandbox));
+}
+
+
+static PyMethodDef SANDBOX_METHODS[] =
+{
+    {"step", (PyCFunction) Sandbox_step, METH_VARARGS,
+        "step(frames=1)\n\nSimulate the given number of frames, releasing the GIL meanwhile."},
+    {"step_until", (PyCFunction) Sandbox_step_until, METH_VARARGS | METH_KEYWORDS,
+        "step_until(still_frames=0, active_below=0, max_frames=0, max_ms=0.0)\n\n"
+        "Simulate frames until still_frames frames in a row move no tile, a frame simulates fewer\n"
+        "than active_below tiles, max_frames frames are simulated or max_ms milliseconds pass,\n"
+        "whichever comes first, ignoring criteria left at 0. At least one must be given.\n"
+        "Returns the name of the reason for stopping and the number of frames simulated."},
+    {"settle", (PyCFunction) Sandbox_settle, METH_NOARGS,
+        "settle()\n\nBring the sandbox directly to rest."},
+    {"paint", (PyCFunction) Sandbox_paint, METH_VARARGS,
+        "paint(mask, tile)\n\nSet every tile where the height x width byte or bool mask is nonzero.\n"
+        "Returns the number of tiles set."},
+    {"snapshot", (PyCFunction) Sandbox_snapshot, METH_NOARGS,
+        "snapshot()\n\nReturn an independent copy of the sandbox."},
+    {"stats", (PyCFunction) Sandbox_stats, METH_NOARGS,
+        "stats()\n\nReturn the counters of the last frame simulated as a dict."},
+    {"wake", (PyCFunction) Sandbox_wake, METH_NOARGS,
+        "wake()\n\nLet the simulation know tiles were written through a view of the sandbox."},
+    {NULL}
+};
+
+
+static PyGetSetDef SANDBOX_GETSETS[] =
+{
+    {"height", (getter) Sandbox_get_height, NULL, "Number of rows of tiles.", NULL},
+    {"width", (getter) Sandbox_get_width, NULL, "Number of columns of tiles.", NULL},
+    {"lifetime", (getter) Sandbox_get_lifetime, NULL, "Frames simulated so far.", NULL},
+    {"seed", (getter) Sandbox_get_seed, NULL, "Seed of all random choices.", NULL},
+    {"world_hash", (getter) Sandbox_get_world_hash, NULL, "Hash of every tile, kept up to date as they change.", NULL},
+    {NULL}
+};
+
+
+static PyBufferProcs SANDBOX_BUFFER_PROCS =
+{
+    (getbufferproc) Sandbox_getbuffer,
+    (releasebufferproc) Sandbox_releasebuffer,
+};
+
+
+static PyTypeObject SANDBOX_TYPE =
+{
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "sand.Sandbox",
+    .tp_doc = "Sandbox(height, width, seed=0)\n\n"
+        "A simulated sandbox of tiles, viewable as a height x width array of bytes.",
+    .tp_basicsize = sizeof(SandboxObject),
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_new = PyType_GenericNew,
+    .tp_init = (initproc) Sandbox_init,
+    .tp_dealloc = (destructor) Sandbox_dealloc,
+    .tp_methods = SANDBOX_METHODS,
+    .tp_getset = SANDBOX_GETSETS,
+    .tp_as_buffer = &SANDBOX_BUFFER_PROCS,
+};
+
+
+/*
+ * Build a dict describing the memory held by a subsystem.
+ *
+ * @param usage - Memory held.
+ *
+ * @return - New reference to the dict, or NULL on failure.
+ */
+static PyObject *_build_memory_usage(const struct MemoryUsage *usage)
+{
+    return Py_BuildValue("{s:k,s:k,s:k,s:k}",
+            "allocated", usage -> allocated,
+            "resident", usage -> resident,
+            "peak_allocated", usage -> peak_allocated,
+            "peak_resident", usage -> peak_resident);
+}
+
+
+static PyObject *sand_memory_stats(PyObject *module, PyObject *unused)
+{
+    struct MemoryStats stats = get_memory_stats();
+    PyObject *result = PyDict_New();
+
+    for (int i = 0; result != NULL && i <= NUM_MEMORY_SUBSYSTEMS; i++)
+    {
+        bool is_total = i == NUM_MEMORY_SUBSYSTEMS;
+        PyObject *usage = _build_memory_usage(is_total ? &stats.total : &stats.subsystems[i]);
+
+        if (usage == NULL || PyDict_SetItemString(result, is_total ? "total" : get_memory_subsystem_name(i), usage) < 0)
+        {
+            Py_XDECREF(usage);
+            Py_CLEAR(result);
+            break;
+        }
+
+        Py_DECREF(usage);
+    }
+
+    return result;
+}
+
+
+static PyMethodDef SAND_FUNCTIONS[] =
+{
+    {"memory_stats", (PyCFunction) sand_memory_stats, METH_NOARGS,
+        "memory_stats()\n\nReturn the bytes allocated and resident for each subsystem, and in total, with their\n"
+        "high-water marks, as a dict of dicts."},
+    {NULL, NULL, 0, NULL}
+};
+
+
+static struct PyModuleDef SAND_MODULE =
+{
+    PyModuleDef_HEAD_INIT,
+    .m_name = "sand",
+    .m_doc = "Falling sand simulation.",
+    .m_size = -1,
+    .m_methods = SAND_FUNCTIONS,
+};
+
+
+// ----- PUBLIC FUNCTIONS -----
+
+
+PyMODINIT_FUNC PyInit_sand(void)
+{
+    if (PyType_Ready(&SANDBOX_TYPE) < 0)
+    {
+        return NULL;
+    }
+
+    SIMULATION_LOCK = PyThread_allocate_lock();
+
+    if (SIMULATION_LOCK == NULL)
+    {
+        return PyErr_NoMemory();
+    }
+
+    PyObject *module = PyModule_Create(&SAND_MODULE);
+
+    if (module == NULL)
+    {
+        return NULL;
+    }
+
+    if (PyModule_AddObjectRef(module, "Sandbox", (PyObject *) &SANDBOX_TYPE) < 0
+            || PyModule_AddIntConstant(module, "AIR", AIR) < 0
+            || PyModule_AddIntConstant(module, "SAND", SAND) < 0
+            || PyModule_AddIntConstant(module, "WATER", WATER) < 0
+            || PyModule_AddIntConstant(module, "WOOD", WOOD) < 0
+            || PyModule_AddIntConstant(module, "STEAM", STEAM) < 0
+            || PyModule_AddIntConstant(module, "FIRE", FIRE) < 0
+            || PyModule_AddIntConstant(module, "TILE_ID_MASK", 0x0F) < 0)
+    {
+        Py_DECREF(module);
+        return NULL;
+    }
+
+    return module;
+}
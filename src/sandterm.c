@@ -0,0 +1,110 @@
+/*
+ * Terminal frontend simulating a sandbox the size of the terminal, such as on
+ * servers only reachable over SSH, without any window.
+ *
+ * Usage: sandterm [SEED] [FRAMES] [BYTES_PER_FRAME]
+ *
+ * The sandbox starts out as the world generated from SEED, or empty if SEED
+ * is not given, and has sand poured into its top middle. It runs for FRAMES
+ * frames, or until interrupted if FRAMES is not given or 0. At most
+ * BYTES_PER_FRAME bytes are written per frame if given, for slow links.
+ *
+ */
+
+#include <signal.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#include "terminal.h"
+#include "worldgen.h"
+
+// Terminal dimensions assumed when they cannot be queried.
+#define DEFAULT_TERMINAL_ROWS 24
+#define DEFAULT_TERMINAL_COLUMNS 80
+
+// Microseconds between frames, running at ~30 FPS.
+#define FRAME_DELAY_US 33000
+
+// Whether the frontend has been asked to stop.
+static volatile sig_atomic_t IS_INTERRUPTED = false;
+
+
+/*
+ * Stop the frontend once the current frame is drawn.
+ *
+ * @param signal_number - Signal received.
+ */
+static void _interrupt(int signal_number)
+{
+    IS_INTERRUPTED = true;
+}
+
+
+int main(int argc, char *argv[])
+{
+    bool has_seed = argc > 1;
+    unsigned int seed = has_seed ? strtoul(argv[1], NULL, 10) : 0;
+    unsigned int frames = argc > 2 ? strtoul(argv[2], NULL, 10) : 0;
+    unsigned long max_bytes = argc > 3 ? strtoul(argv[3], NULL, 10) : 0;
+
+    struct winsize terminal_size;
+    unsigned int terminal_rows = DEFAULT_TERMINAL_ROWS;
+    unsigned int terminal_columns = DEFAULT_TERMINAL_COLUMNS;
+
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &terminal_size) == 0 && terminal_size.ws_row > 1 && terminal_size.ws_col > 0)
+    {
+        terminal_rows = terminal_size.ws_row;
+        terminal_columns = terminal_size.ws_col;
+    }
+
+    // Leave the last row of the terminal for the shell prompt afterwards.
+    unsigned int height = 2 * (terminal_rows - 1);
+    unsigned int width = terminal_columns;
+    unsigned char **sandbox = create_sandbox(height, width);
+
+    if (sandbox == NULL)
+    {
+        fprintf(stderr, "Not enough memory for a %ux%u sandbox\n", width, height);
+        return 1;
+    }
+
+    if (has_seed)
+    {
+        generate_world(sandbox, height, width, seed, 0);
+    }
+
+    struct TerminalRenderer *renderer = create_terminal_renderer(sandbox, height, width, terminal_rows - 1, width, stdout);
+
+    if (renderer == NULL)
+    {
+        fprintf(stderr, "Not enough memory to render a %ux%u sandbox\n", width, height);
+        sandbox_free(sandbox, height, width);
+        return 1;
+    }
+
+    unsigned long total_bytes = 0;
+    unsigned int frame = 0;
+
+    signal(SIGINT, _interrupt);
+    signal(SIGTERM, _interrupt);
+
+    while (!IS_INTERRUPTED && (frames == 0 || frame < frames))
+    {
+        if (get_tile_id(sandbox[0][width / 2]) == AIR)
+        {
+            edit_tile(sandbox, 0, width / 2, SAND);
+        }
+
+        process_sandbox(sandbox, height, width);
+        total_bytes += draw_terminal_frame(renderer, max_bytes);
+        frame++;
+
+        usleep(FRAME_DELAY_US);
+    }
+
+    free_terminal_renderer(renderer);
+    sandbox_free(sandbox, height, width);
+
+    fprintf(stderr, "Drew %u frames of %ux%u sandbox in %lu bytes\n", frame, width, height, total_bytes);
+
+    return 0;
+}
@@ -0,0 +1,422 @@
+/*
+ * Implementation of save.h interface.
+ *
+ */
+
+#include "save.h"
+
+// Number of values stored after the magic bytes, before the tiles.
+#define SAVE_HEADER_VALUES 6
+
+// Offset in bytes of the tiles within a save file.
+#define SAVE_TILES_OFFSET (4 + SAVE_HEADER_VALUES * 4)
+
+static const char SAVE_MAGIC[4] = {'S', 'A', 'N', 'D'};
+
+
+// ----- PRIVATE FUNCTIONS -----
+
+
+/*
+ * Read a single value stored by pack_save_u32() from a file.
+ *
+ * @param file - File to read from.
+ * @param value - Set to the value read.
+ *
+ * @return - True if a whole value was read, false otherwise.
+ */
+static bool _read_u32(FILE *file, unsigned int *value)
+{
+    unsigned char bytes[4];
+
+    if (fread(bytes, 1, 4, file) != 4)
+    {
+        return false;
+    }
+
+    *value = unpack_save_u32(bytes);
+    return true;
+}
+
+
+/*
+ * Find the size of an open file, leaving its position as it was.
+ *
+ * @param file - File to measure.
+ *
+ * @return - Size of file in bytes, or -1 if it could not be measured.
+ */
+static long long _get_file_size(FILE *file)
+{
+    long position = ftell(file);
+
+    if (position < 0 || fseek(file, 0, SEEK_END) != 0)
+    {
+        return -1;
+    }
+
+    long size = ftell(file);
+
+    return fseek(file, position, SEEK_SET) == 0 ? size : -1;
+}
+
+
+/*
+ * Check whether a file is long enough to hold every tile its header gives.
+ *
+ * @param file_size - Size of file in bytes, or -1 if it is not known.
+ * @param header - Values of the file's header, in order.
+ *
+ * @return - True if the tiles all lie within the file, false otherwise.
+ */
+static bool _holds_all_tiles(long long file_size, const unsigned int header[SAVE_HEADER_VALUES])
+{
+    // Damaged dimensions can multiply to more than a signed 64 bit number
+    // holds.
+    return file_size >= SAVE_TILES_OFFSET
+            && (unsigned long long) (file_size - SAVE_TILES_OFFSET) >= (unsigned long long) header[1] * header[2];
+}
+
+
+/*
+ * Open a save file and move past its magic bytes, header and tiles.
+ *
+ * @param path - Path of file to open.
+ * @param header - Set to the values of the file's header, in order.
+ *
+ * @return - File positioned at its tiles, or NULL if it is not a save file.
+ */
+static FILE *_open_save(const char *path, unsigned int header[SAVE_HEADER_VALUES])
+{
+    FILE *file = fopen(path, "rb");
+
+    if (file == NULL)
+    {
+        return NULL;
+    }
+
+    char magic[4];
+    bool is_valid = fread(magic, 1, 4, file) == 4 && memcmp(magic, SAVE_MAGIC, 4) == 0;
+
+    for (unsigned int i = 0; is_valid && i < SAVE_HEADER_VALUES; i++)
+    {
+        is_valid = _read_u32(file, &header[i]);
+    }
+
+    if (!is_valid || header[0] != SAVE_VERSION)
+    {
+        fclose(file);
+        return NULL;
+    }
+
+    return file;
+}
+
+
+/*
+ * Check the tiles of a sandbox read from a save file against the world hash
+ * saved with them.
+ *
+ * @param path - Path of file the sandbox was read from.
+ * @param sandbox - Sandbox read from the file.
+ *
+ * @return - True if the tiles match their saved hash, or if the file has no
+ * hash to check against, false otherwise.
+ */
+static bool _is_hash_intact(const char *path, unsigned char **sandbox)
+{
+    unsigned int hash_length;
+    unsigned char *hash_bytes = load_save_section(path, SAVE_HASH_TAG, &hash_length);
+    // Files written before hashes were saved have nothing to check against.
+    bool is_intact = hash_bytes == NULL || (hash_length == 8 && unpack_save_u64(hash_bytes) == get_world_hash(sandbox));
+
+    free(hash_bytes);
+
+    return is_intact;
+}
+
+
+// ----- PUBLIC FUNCTIONS -----
+
+
+bool save_sandbox(const char *path, unsigned char **sandbox, unsigned int height, unsigned int width)
+{
+    FILE *file = fopen(path, "wb");
+
+    if (file == NULL)
+    {
+        return false;
+    }
+
+    unsigned int header[SAVE_HEADER_VALUES] = {SAVE_VERSION, height, width, SANDBOX_LIFETIME, SANDBOX_SEED, SANDBOX_RNG_PERIOD};
+    unsigned char header_bytes[SAVE_HEADER_VALUES * 4];
+
+    for (unsigned int i = 0; i < SAVE_HEADER_VALUES; i++)
+    {
+        pack_save_u32(&header_bytes[i * 4], header[i]);
+    }
+
+    bool is_written = fwrite(SAVE_MAGIC, 1, 4, file) == 4
+        && fwrite(header_bytes, 1, sizeof(header_bytes), file) == sizeof(header_bytes);
+
+    for (unsigned int row_index = 0; is_written && row_index < height; row_index++)
+    {
+        is_written = fwrite(sandbox[row_index], 1, width, file) == width;
+    }
+
+    // The hash section follows the tiles directly.
+    unsigned char hash_bytes[4 + 4 + 8];
+    memcpy(hash_bytes, SAVE_HASH_TAG, SAVE_TAG_LENGTH);
+    pack_save_u32(&hash_bytes[4], 8);
+    pack_save_u64(&hash_bytes[8], get_world_hash(sandbox));
+
+    is_written = is_written && fwrite(hash_bytes, 1, sizeof(hash_bytes), file) == sizeof(hash_bytes);
+
+    // Closing flushes whatever is left, which may fail too.
+    return fclose(file) == 0 && is_written;
+}
+
+
+unsigned char **load_sandbox(const char *path, unsigned int *height, unsigned int *width)
+{
+    unsigned int header[SAVE_HEADER_VALUES];
+    FILE *file = _open_save(path, header);
+
+    if (file == NULL)
+    {
+        return NULL;
+    }
+
+    // Damaged dimensions would otherwise allocate far more than the file
+    // could ever fill.
+    long long file_size = _get_file_size(file);
+    unsigned char **sandbox = NULL;
+
+    if (_holds_all_tiles(file_size, header))
+    {
+        sandbox = create_sandbox(header[1], header[2]);
+    }
+
+    if (sandbox == NULL)
+    {
+        fclose(file);
+        return NULL;
+    }
+
+    for (unsigned int row_index = 0; row_index < header[1]; row_index++)
+    {
+        if (fread(sandbox[row_index], 1, header[2], file) != header[2])
+        {
+            sandbox_free(sandbox, header[1], header[2]);
+            fclose(file);
+            return NULL;
+        }
+    }
+
+    fclose(file);
+
+    // Tiles were read in directly, so their hashes must be computed.
+    wake_sandbox(sandbox);
+
+    if (!_is_hash_intact(path, sandbox))
+    {
+        sandbox_free(sandbox, header[1], header[2]);
+        return NULL;
+    }
+
+    *height = header[1];
+    *width = header[2];
+    SANDBOX_LIFETIME = header[3];
+    SANDBOX_SEED = header[4];
+    SANDBOX_RNG_PERIOD = header[5];
+
+    return sandbox;
+}
+
+
+bool append_save_section(const char *path, const char *tag, const void *data, unsigned int length)
+{
+    FILE *file = fopen(path, "ab");
+
+    if (file == NULL)
+    {
+        return false;
+    }
+
+    unsigned char length_bytes[4];
+    pack_save_u32(length_bytes, length);
+
+    bool is_written = fwrite(tag, 1, SAVE_TAG_LENGTH, file) == SAVE_TAG_LENGTH
+        && fwrite(length_bytes, 1, 4, file) == 4
+        && fwrite(data, 1, length, file) == length;
+
+    return fclose(file) == 0 && is_written;
+}
+
+
+unsigned char *load_save_section(const char *path, const char *tag, unsigned int *length)
+{
+    unsigned int header[SAVE_HEADER_VALUES];
+    FILE *file = _open_save(path, header);
+
+    if (file == NULL)
+    {
+        return NULL;
+    }
+
+    long long file_size = _get_file_size(file);
+
+    if (!_holds_all_tiles(file_size, header))
+    {
+        fclose(file);
+        return NULL;
+    }
+
+    // Sections start after the tiles.
+    long long position = SAVE_TILES_OFFSET + (long long) header[1] * header[2];
+
+    char section_tag[SAVE_TAG_LENGTH];
+    unsigned int section_length;
+
+    while (position <= file_size && fseek(file, (long) position, SEEK_SET) == 0
+            && fread(section_tag, 1, SAVE_TAG_LENGTH, file) == SAVE_TAG_LENGTH && _read_u32(file, &section_length))
+    {
+        position += SAVE_TAG_LENGTH + 4;
+
+        // Damaged lengths running past the end of the file end the search.
+        if (section_length > file_size - position)
+        {
+            break;
+        }
+
+        if (memcmp(section_tag, tag, SAVE_TAG_LENGTH) != 0)
+        {
+            position += section_length;
+            continue;
+        }
+
+        // Allocate at least a byte, so empty sections are told apart from
+        // missing ones.
+        unsigned char *data = (unsigned char *) malloc((size_t) section_length + 1);
+
+        if (data == NULL || fread(data, 1, section_length, file) != section_length)
+        {
+            free(data);
+            break;
+        }
+
+        fclose(file);
+        *length = section_length;
+        return data;
+    }
+
+    fclose(file);
+    return NULL;
+}
+
+
+struct BaseMap *open_base_map(const char *path)
+{
+    unsigned int header[SAVE_HEADER_VALUES];
+    FILE *file = _open_save(path, header);
+
+    if (file == NULL)
+    {
+        return NULL;
+    }
+
+    // Mapped tiles past the end of the file cannot be read, so make sure
+    // they are all there.
+    bool is_complete = _holds_all_tiles(_get_file_size(file), header);
+
+    fclose(file);
+
+    unsigned char **sandbox = is_complete ? map_sandbox(path, SAVE_TILES_OFFSET, header[1], header[2], NULL) : NULL;
+
+    if (sandbox == NULL)
+    {
+        return NULL;
+    }
+
+    if (!_is_hash_intact(path, sandbox))
+    {
+        sandbox_free(sandbox, header[1], header[2]);
+        return NULL;
+    }
+
+    // Keep the hashes computed for this first sandbox for every instance.
+    struct SandboxInfo *info = get_sandbox_info(sandbox);
+    unsigned int num_chunks = info -> chunk_rows * info -> chunk_columns;
+
+    struct BaseMap *map = (struct BaseMap *) allocate_memory(MEMORY_GRID, sizeof(struct BaseMap));
+    map -> path = (char *) allocate_memory(MEMORY_GRID, strlen(path) + 1);
+    map -> chunk_hashes = (unsigned long long *) allocate_memory(MEMORY_GRID, num_chunks * sizeof(unsigned long long));
+
+    strcpy(map -> path, path);
+
+    for (unsigned int i = 0; i < num_chunks; i++)
+    {
+        map -> chunk_hashes[i] = info -> chunks[i].hash;
+    }
+
+    map -> height = header[1];
+    map -> width = header[2];
+    map -> lifetime = header[3];
+    map -> seed = header[4];
+    map -> rng_period = header[5];
+
+    sandbox_free(sandbox, header[1], header[2]);
+
+    return map;
+}
+
+
+unsigned char **instance_base_map(const struct BaseMap *map)
+{
+    return map_sandbox(map -> path, SAVE_TILES_OFFSET, map -> height, map -> width, map -> chunk_hashes);
+}
+
+
+void close_base_map(struct BaseMap *map)
+{
+    unsigned int num_chunks = ((map -> height + CHUNK_SIZE - 1) / CHUNK_SIZE) * ((map -> width + CHUNK_SIZE - 1) / CHUNK_SIZE);
+
+    release_memory(MEMORY_GRID, map -> chunk_hashes, num_chunks * sizeof(unsigned long long));
+    release_memory(MEMORY_GRID, map -> path, strlen(map -> path) + 1);
+    release_memory(MEMORY_GRID, map, sizeof(struct BaseMap));
+}
+
+
+void pack_save_u32(unsigned char *bytes, unsigned int value)
+{
+    for (unsigned int i = 0; i < 4; i++)
+    {
+        bytes[i] = (value >> (8 * i)) & 0xFF;
+    }
+}
+
+
+unsigned int unpack_save_u32(const unsigned char *bytes)
+{
+    unsigned int value = 0;
+
+    for (unsigned int i = 0; i < 4; i++)
+    {
+        value |= (unsigned int) bytes[i] << (8 * i);
+    }
+
+    return value;
+}
+
+
+void pack_save_u64(unsigned char *bytes, unsigned long long value)
+{
+    pack_save_u32(bytes, value & 0xFFFFFFFF);
+    pack_save_u32(&bytes[4], value >> 32);
+}
+
+
+unsigned long long unpack_save_u64(const unsigned char *bytes)
+{
+    return unpack_save_u32(bytes) | (unsigned long long) unpack_save_u32(&bytes[4]) << 32;
+}
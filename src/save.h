@@ -0,0 +1,186 @@
+#ifndef SAVE_H
+#define SAVE_H
+
+/*
+ * Reading and writing sandboxes to and from save files.
+ *
+ * A save file holds everything needed to continue a sandbox's simulation
+ * exactly where it left off, being its tiles along with SANDBOX_LIFETIME,
+ * SANDBOX_SEED and SANDBOX_RNG_PERIOD. Numbers are stored as 32 bit little
+ * endian values, laid out as follows:
+ *
+ * 1. The 4 bytes "SAND", followed by SAVE_VERSION.
+ * 2. Height, width, lifetime, seed and RNG period.
+ * 3. Height x width tiles, row by row, one byte each.
+ * 4. Any number of sections, each a 4 byte tag, a length in bytes, and that
+ *    many bytes of data. Readers skip sections they do not know.
+ *
+ * Save files are written with a "HASH" section holding the world hash of
+ * their tiles, as a 64 bit little endian value, which they are checked
+ * against when loaded.
+ *
+ * A save file may also be opened as a base map, such as a map hosting many
+ * sessions at once, to create any number of sandboxes from. Their tiles are
+ * mapped from the file rather than read, sharing every page of tiles none of
+ * them changed, so each only takes up memory for what changed within it.
+ *
+ */
+
+#include "sandbox.h"
+
+// Version of the save format written, and the only one read.
+#define SAVE_VERSION 1
+
+// Length in bytes of a section's tag.
+#define SAVE_TAG_LENGTH 4
+
+// Tag of the section holding the world hash of the saved tiles.
+#define SAVE_HASH_TAG "HASH"
+
+
+// Save file opened to create sandboxes from, sharing its tiles.
+struct BaseMap
+{
+    // Path of save file.
+    char *path;
+
+    unsigned int height;
+    unsigned int width;
+
+    // Saved values of SANDBOX_LIFETIME, SANDBOX_SEED and SANDBOX_RNG_PERIOD.
+    unsigned int lifetime;
+    unsigned int seed;
+    unsigned int rng_period;
+
+    // Hash of each chunk of the saved tiles, row by row, computed once for
+    // every sandbox.
+    unsigned long long *chunk_hashes;
+};
+
+
+/*
+ * Write the given sandbox to a new save file, replacing any existing one.
+ *
+ * @param path - Path of file to write.
+ * @param sandbox - Sandbox to save.
+ * @param height, width - Dimensions of sandbox.
+ *
+ * @return - True if the file was written, false otherwise.
+ */
+bool save_sandbox(const char *path, unsigned char **sandbox, unsigned int height, unsigned int width);
+
+
+/*
+ * Read a sandbox from a save file, restoring SANDBOX_LIFETIME, SANDBOX_SEED
+ * and SANDBOX_RNG_PERIOD to their saved values.
+ *
+ * @param path - Path of file to read.
+ * @param height, width - Set to the dimensions of the loaded sandbox.
+ *
+ * @return - Newly created sandbox, or NULL if the file could not be read or
+ * its tiles do not match their saved hash.
+ */
+unsigned char **load_sandbox(const char *path, unsigned int *height, unsigned int *width);
+
+
+/*
+ * Open a save file as a base map, checking its tiles against their saved
+ * hash once, for every sandbox created from it.
+ *
+ * The file must not change while the base map or any of its sandboxes are
+ * in use.
+ *
+ * @param path - Path of file to open.
+ *
+ * @return - Newly opened base map, or NULL if the file could not be read or
+ * its tiles do not match their saved hash.
+ */
+struct BaseMap *open_base_map(const char *path);
+
+
+/*
+ * Create a sandbox holding the tiles of a base map, as with map_sandbox(),
+ * without reading any of them. Unlike load_sandbox(), globals are left as
+ * they are.
+ *
+ * @param map - Base map to create sandbox from.
+ *
+ * @return - Newly created sandbox, freed with sandbox_free(), or NULL if the
+ * file could not be mapped.
+ */
+unsigned char **instance_base_map(const struct BaseMap *map);
+
+
+/*
+ * Close a base map. Sandboxes created from it are unaffected.
+ *
+ * @param map - Base map to close.
+ */
+void close_base_map(struct BaseMap *map);
+
+
+/*
+ * Add a section to the end of an existing save file.
+ *
+ * @param path - Path of file to add to.
+ * @param tag - SAVE_TAG_LENGTH characters naming the section.
+ * @param data - Contents of the section.
+ * @param length - Length of data in bytes.
+ *
+ * @return - True if the section was written, false otherwise.
+ */
+bool append_save_section(const char *path, const char *tag, const void *data, unsigned int length);
+
+
+/*
+ * Read the first section with the given tag from a save file.
+ *
+ * @param path - Path of file to read.
+ * @param tag - SAVE_TAG_LENGTH characters naming the section.
+ * @param length - Set to the length of the section in bytes.
+ *
+ * @return - Newly allocated copy of the section's contents, or NULL if the
+ * file holds no such section.
+ */
+unsigned char *load_save_section(const char *path, const char *tag, unsigned int *length);
+
+
+/*
+ * Store a value as 4 little endian bytes, as used throughout save files.
+ *
+ * @param bytes - Location to store value at.
+ * @param value - Value to store.
+ */
+void pack_save_u32(unsigned char *bytes, unsigned int value);
+
+
+/*
+ * Read a value stored by pack_save_u32().
+ *
+ * @param bytes - Location value is stored at.
+ *
+ * @return - Stored value.
+ */
+unsigned int unpack_save_u32(const unsigned char *bytes);
+
+
+/*
+ * Store a value as 8 little endian bytes, like pack_save_u32().
+ *
+ * @param bytes - Location to store value at.
+ * @param value - Value to store.
+ */
+void pack_save_u64(unsigned char *bytes, unsigned long long value);
+
+
+/*
+ * Read a value stored by pack_save_u64().
+ *
+ * @param bytes - Location value is stored at.
+ *
+ * @return - Stored value.
+ */
+unsigned long long unpack_save_u64(const unsigned char *bytes);
+
+
+#endif
@@ -0,0 +1,722 @@
+/*
+ * Implementation of stamp.h interface.
+ *
+ */
+
+#include "stamp.h"
+
+// Tile standing for transparency while encoding art. Its flags are unused,
+// so it is never found in sandboxes.
+#define TRANSPARENT_TILE 0xFF
+
+// Number of values stored after the magic bytes of a library file, and after
+// the name of each of its stamps.
+#define LIBRARY_HEADER_VALUES 2
+#define STAMP_HEADER_VALUES 3
+
+// Bytes each run takes up in a library file.
+#define RUN_BYTES 4
+
+static const char LIBRARY_MAGIC[4] = {'S', 'T', 'M', 'P'};
+
+// Characters drawing each tile in art, in order of tile ID, as printed by
+// print_sandbox().
+static const char ART_TILES[] = "-O_#~^";
+
+
+// A prefab stamp, drawn as art.
+struct Prefab
+{
+    const char *name;
+    const char *const *art;
+    unsigned int num_rows;
+};
+
+
+// Wooden hut, hollow inside.
+static const char *const HOUSE_ART[] =
+{
+    "    ###    ",
+    "  #######  ",
+    "###########",
+    " #-------# ",
+    " #-------# ",
+    " #-------# ",
+    "###########"
+};
+
+// Wooden funnel of sand, trickling through its neck into the chamber below.
+static const char *const HOURGLASS_ART[] =
+{
+    "###########",
+    "#OOOOOOOOO#",
+    " #OOOOOOO# ",
+    "  #OOOOO#  ",
+    "   #OOO#   ",
+    "    #-#    ",
+    "   #---#   ",
+    "  #-----#  ",
+    " #-------# ",
+    "#---------#",
+    "###########"
+};
+
+// Wooden basin of water, draining through a gap in its floor.
+static const char *const RESERVOIR_ART[] =
+{
+    "#            #",
+    "#____________#",
+    "#____________#",
+    "#____________#",
+    "#____________#",
+    "######-#######"
+};
+
+static const struct Prefab PREFABS[] =
+{
+    {"house", HOUSE_ART, sizeof(HOUSE_ART) / sizeof(HOUSE_ART[0])},
+    {"hourglass", HOURGLASS_ART, sizeof(HOURGLASS_ART) / sizeof(HOURGLASS_ART[0])},
+    {"reservoir", RESERVOIR_ART, sizeof(RESERVOIR_ART) / sizeof(RESERVOIR_ART[0])}
+};
+
+
+// ----- PRIVATE FUNCTIONS -----
+
+
+/*
+ * Return the number of bytes allocated for a stamp.
+ *
+ * @param height - Number of rows of stamp.
+ * @param num_runs - Number of runs of stamp.
+ *
+ * @return - Bytes allocated for stamp, along with its runs and row starts.
+ */
+static size_t _get_stamp_bytes(unsigned int height, unsigned int num_runs)
+{
+    return sizeof(struct Stamp) + (height + 1) * sizeof(unsigned int) + num_runs * sizeof(struct StampRun);
+}
+
+
+/*
+ * Allocate a stamp, with room for its runs and row starts in the same block.
+ *
+ * @param height, width - Dimensions of stamp.
+ * @param num_runs - Number of runs of stamp.
+ *
+ * @return - Newly allocated stamp with every run and row start 0, or NULL if
+ * there was no memory left.
+ */
+static struct Stamp *_allocate_stamp(unsigned int height, unsigned int width, unsigned int num_runs)
+{
+    struct Stamp *stamp = (struct Stamp *) allocate_memory(MEMORY_STAMPS, _get_stamp_bytes(height, num_runs));
+
+    if (stamp == NULL)
+    {
+        return NULL;
+    }
+
+    stamp -> height = height;
+    stamp -> width = width;
+    stamp -> num_runs = num_runs;
+    stamp -> row_starts = (unsigned int *) (stamp + 1);
+    stamp -> runs = (struct StampRun *) (stamp -> row_starts + height + 1);
+
+    return stamp;
+}
+
+
+/*
+ * Return the run a single tile is encoded as.
+ *
+ * @param tile - Tile to encode, or TRANSPARENT_TILE.
+ * @param is_air_transparent - Whether air is encoded as transparent.
+ *
+ * @return - Run of length 1 holding tile.
+ */
+static struct StampRun _get_tile_run(unsigned char tile, bool is_air_transparent)
+{
+    bool is_opaque = tile != TRANSPARENT_TILE && !(is_air_transparent && get_tile_id(tile) == AIR);
+
+    return (struct StampRun) {1, is_opaque ? get_tile_id(tile) : AIR, is_opaque};
+}
+
+
+/*
+ * Run-length encode a row of tiles.
+ *
+ * @param tiles - Tiles to encode, or TRANSPARENT_TILE.
+ * @param width - Number of tiles.
+ * @param is_air_transparent - Whether air is encoded as transparent.
+ * @param runs - Set to the runs of the row, or NULL to only count them.
+ *
+ * @return - Number of runs of the row.
+ */
+static unsigned int _encode_row(const unsigned char *tiles,
+        unsigned int width,
+        bool is_air_transparent,
+        struct StampRun *runs)
+{
+    unsigned int num_runs = 0;
+    unsigned int column = 0;
+
+    while (column < width)
+    {
+        struct StampRun run = _get_tile_run(tiles[column], is_air_transparent);
+        column++;
+
+        while (column < width && run.length < STAMP_MAX_RUN)
+        {
+            struct StampRun next = _get_tile_run(tiles[column], is_air_transparent);
+
+            if (next.tile != run.tile || next.is_opaque != run.is_opaque)
+            {
+                break;
+            }
+
+            run.length++;
+            column++;
+        }
+
+        if (runs != NULL)
+        {
+            runs[num_runs] = run;
+        }
+
+        num_runs++;
+    }
+
+    return num_runs;
+}
+
+
+/*
+ * Encode a rectangle of tiles into a new stamp.
+ *
+ * @param rows - Rows of tiles, top to bottom, or TRANSPARENT_TILE.
+ * @param column_index - Column of the first tile of each row to encode.
+ * @param height, width - Dimensions of rectangle.
+ * @param is_air_transparent - Whether air is encoded as transparent.
+ *
+ * @return - Newly created stamp, or NULL if there was no memory left.
+ */
+static struct Stamp *_encode_stamp(unsigned char *const *rows,
+        unsigned int column_index,
+        unsigned int height,
+        unsigned int width,
+        bool is_air_transparent)
+{
+    // Count the runs first, so the stamp is allocated once at its exact size.
+    unsigned int num_runs = 0;
+
+    for (unsigned int row = 0; row < height; row++)
+    {
+        num_runs += _encode_row(&rows[row][column_index], width, is_air_transparent, NULL);
+    }
+
+    struct Stamp *stamp = _allocate_stamp(height, width, num_runs);
+
+    if (stamp == NULL)
+    {
+        return NULL;
+    }
+
+    unsigned int run_index = 0;
+
+    for (unsigned int row = 0; row < height; row++)
+    {
+        stamp -> row_starts[row] = run_index;
+        run_index += _encode_row(&rows[row][column_index], width, is_air_transparent, &stamp -> runs[run_index]);
+    }
+
+    stamp -> row_starts[height] = run_index;
+
+    return stamp;
+}
+
+
+/*
+ * Clip a rectangle of a sandbox to the sandbox.
+ *
+ * @param height, width - Dimensions of sandbox.
+ * @param row_index, column_index - Coordinates of top left tile of rectangle.
+ * @param rectangle_height, rectangle_width - Dimensions of rectangle, set to
+ * the dimensions of the part of it within the sandbox.
+ *
+ * @return - True if any of the rectangle lies within the sandbox, false
+ * otherwise.
+ */
+static bool _clip_rectangle(unsigned int height,
+        unsigned int width,
+        unsigned int row_index,
+        unsigned int column_index,
+        unsigned int *rectangle_height,
+        unsigned int *rectangle_width)
+{
+    if (row_index >= height || column_index >= width)
+    {
+        return false;
+    }
+
+    if (*rectangle_height > height - row_index)
+    {
+        *rectangle_height = height - row_index;
+    }
+
+    if (*rectangle_width > width - column_index)
+    {
+        *rectangle_width = width - column_index;
+    }
+
+    return *rectangle_height > 0 && *rectangle_width > 0;
+}
+
+
+/*
+ * Grow a library to hold at least one more stamp.
+ *
+ * @param library - Library to grow.
+ *
+ * @return - True if the library has room for another stamp, false if there
+ * was no memory left.
+ */
+static bool _grow_library(struct StampLibrary *library)
+{
+    if (library -> num_stamps < library -> capacity)
+    {
+        return true;
+    }
+
+    unsigned int capacity = library -> capacity > 0 ? 2 * library -> capacity : 8;
+    char (*names)[STAMP_NAME_LENGTH] = allocate_memory(MEMORY_STAMPS, capacity * sizeof(*names));
+    struct Stamp **stamps = (struct Stamp **) allocate_memory(MEMORY_STAMPS, capacity * sizeof(*stamps));
+
+    if (names == NULL || stamps == NULL)
+    {
+        release_memory(MEMORY_STAMPS, names, capacity * sizeof(*names));
+        release_memory(MEMORY_STAMPS, stamps, capacity * sizeof(*stamps));
+        return false;
+    }
+
+    if (library -> num_stamps > 0)
+    {
+        memcpy(names, library -> names, library -> num_stamps * sizeof(*names));
+        memcpy(stamps, library -> stamps, library -> num_stamps * sizeof(*stamps));
+    }
+
+    release_memory(MEMORY_STAMPS, library -> names, library -> capacity * sizeof(*library -> names));
+    release_memory(MEMORY_STAMPS, library -> stamps, library -> capacity * sizeof(*library -> stamps));
+
+    library -> names = names;
+    library -> stamps = stamps;
+    library -> capacity = capacity;
+
+    return true;
+}
+
+
+/*
+ * Read a single stamp of a library file.
+ *
+ * @param file - File positioned at the start of a stamp.
+ * @param name - Set to the name of the stamp.
+ *
+ * @return - Newly created stamp, or NULL if none could be read.
+ */
+static struct Stamp *_read_stamp(FILE *file, char name[STAMP_NAME_LENGTH])
+{
+    unsigned char header_bytes[STAMP_HEADER_VALUES * 4];
+
+    if (fread(name, 1, STAMP_NAME_LENGTH, file) != STAMP_NAME_LENGTH
+            || fread(header_bytes, 1, sizeof(header_bytes), file) != sizeof(header_bytes))
+    {
+        return NULL;
+    }
+
+    name[STAMP_NAME_LENGTH - 1] = '\0';
+
+    unsigned int height = unpack_save_u32(&header_bytes[0]);
+    unsigned int width = unpack_save_u32(&header_bytes[4]);
+    unsigned int num_runs = unpack_save_u32(&header_bytes[8]);
+
+    // Every row has at least one run, and runs are never empty, which also
+    // keeps corrupt files from asking for absurd amounts of memory.
+    if (height == 0 || width == 0 || num_runs < height || num_runs / height > width)
+    {
+        return NULL;
+    }
+
+    struct Stamp *stamp = _allocate_stamp(height, width, num_runs);
+
+    if (stamp == NULL)
+    {
+        return NULL;
+    }
+
+    unsigned int row = 0;
+    unsigned int row_length = 0;
+    bool is_valid = true;
+
+    for (unsigned int i = 0; is_valid && i < num_runs; i++)
+    {
+        unsigned char run_bytes[RUN_BYTES];
+        is_valid = fread(run_bytes, 1, RUN_BYTES, file) == RUN_BYTES;
+
+        struct StampRun run = {run_bytes[0] | run_bytes[1] << 8, run_bytes[2], run_bytes[3] != 0};
+        is_valid = is_valid && run.length > 0 && run.tile == get_tile_id(run.tile) && row < height;
+
+        if (!is_valid)
+        {
+            break;
+        }
+
+        if (row_length == 0)
+        {
+            stamp -> row_starts[row] = i;
+        }
+
+        stamp -> runs[i] = run;
+        row_length += run.length;
+
+        // Runs never carry over into the next row.
+        is_valid = row_length <= width;
+
+        if (row_length == width)
+        {
+            row++;
+            row_length = 0;
+        }
+    }
+
+    if (!is_valid || row != height)
+    {
+        free_stamp(stamp);
+        return NULL;
+    }
+
+    stamp -> row_starts[height] = num_runs;
+
+    return stamp;
+}
+
+
+// ----- PUBLIC FUNCTIONS -----
+
+
+struct Stamp *copy_stamp(unsigned char **sandbox,
+        unsigned int height,
+        unsigned int width,
+        unsigned int row_index,
+        unsigned int column_index,
+        unsigned int stamp_height,
+        unsigned int stamp_width,
+        bool is_air_transparent)
+{
+    if (!_clip_rectangle(height, width, row_index, column_index, &stamp_height, &stamp_width))
+    {
+        return NULL;
+    }
+
+    return _encode_stamp(&sandbox[row_index], column_index, stamp_height, stamp_width, is_air_transparent);
+}
+
+
+struct Stamp *cut_stamp(unsigned char **sandbox,
+        unsigned int height,
+        unsigned int width,
+        unsigned int row_index,
+        unsigned int column_index,
+        unsigned int stamp_height,
+        unsigned int stamp_width,
+        bool is_air_transparent)
+{
+    if (!_clip_rectangle(height, width, row_index, column_index, &stamp_height, &stamp_width))
+    {
+        return NULL;
+    }
+
+    struct Stamp *stamp = _encode_stamp(&sandbox[row_index], column_index, stamp_height, stamp_width, is_air_transparent);
+
+    if (stamp == NULL)
+    {
+        return NULL;
+    }
+
+    for (unsigned int row = row_index; row < row_index + stamp_height; row++)
+    {
+        memset(&sandbox[row][column_index], AIR, stamp_width);
+    }
+
+    wake_region(sandbox, row_index, column_index, stamp_height, stamp_width);
+
+    return stamp;
+}
+
+
+struct Stamp *create_stamp_from_art(const char *const *art, unsigned int num_rows)
+{
+    unsigned int width = 0;
+
+    for (unsigned int row = 0; row < num_rows; row++)
+    {
+        unsigned int length = strlen(art[row]);
+        width = length > width ? length : width;
+    }
+
+    if (width == 0)
+    {
+        return NULL;
+    }
+
+    // Draw the art as tiles, so it is encoded like any rectangle of a sandbox.
+    unsigned char **rows = (unsigned char **) allocate_memory(MEMORY_STAMPS, num_rows * sizeof(unsigned char *));
+    unsigned char *tiles = (unsigned char *) allocate_memory(MEMORY_STAMPS, num_rows * width);
+    bool is_valid = rows != NULL && tiles != NULL;
+
+    for (unsigned int row = 0; is_valid && row < num_rows; row++)
+    {
+        rows[row] = &tiles[row * width];
+        memset(rows[row], TRANSPARENT_TILE, width);
+
+        for (unsigned int column = 0; is_valid && art[row][column] != '\0'; column++)
+        {
+            const char *art_tile = strchr(ART_TILES, art[row][column]);
+
+            if (art[row][column] == STAMP_ART_TRANSPARENT)
+            {
+                continue;
+            }
+
+            is_valid = art_tile != NULL;
+            rows[row][column] = is_valid ? art_tile - ART_TILES : TRANSPARENT_TILE;
+        }
+    }
+
+    struct Stamp *stamp = is_valid ? _encode_stamp(rows, 0, num_rows, width, false) : NULL;
+
+    release_memory(MEMORY_STAMPS, rows, num_rows * sizeof(unsigned char *));
+    release_memory(MEMORY_STAMPS, tiles, num_rows * width);
+
+    return stamp;
+}
+
+
+void paste_stamp(unsigned char **sandbox,
+        unsigned int height,
+        unsigned int width,
+        const struct Stamp *stamp,
+        int row_index,
+        int column_index)
+{
+    long long row_first = row_index > 0 ? row_index : 0;
+    long long row_end = (long long) row_index + stamp -> height < height ? (long long) row_index + stamp -> height : height;
+    long long column_first = column_index > 0 ? column_index : 0;
+    long long column_end = (long long) column_index + stamp -> width < width ? (long long) column_index + stamp -> width : width;
+
+    if (row_first >= row_end || column_first >= column_end)
+    {
+        return;
+    }
+
+    for (long long row = row_first; row < row_end; row++)
+    {
+        unsigned int stamp_row = row - row_index;
+        unsigned char *tiles = sandbox[row];
+        long long run_start = column_index;
+
+        for (unsigned int i = stamp -> row_starts[stamp_row]; i < stamp -> row_starts[stamp_row + 1]; i++)
+        {
+            const struct StampRun *run = &stamp -> runs[i];
+            long long run_end = run_start + run -> length;
+
+            // Transparent runs are skipped over without touching the tiles
+            // under them, and opaque runs filled whole.
+            if (run -> is_opaque && run_end > column_first)
+            {
+                long long fill_start = run_start > column_first ? run_start : column_first;
+                long long fill_end = run_end < column_end ? run_end : column_end;
+
+                memset(&tiles[fill_start], run -> tile, fill_end - fill_start);
+            }
+
+            if (run_end >= column_end)
+            {
+                break;
+            }
+
+            run_start = run_end;
+        }
+    }
+
+    wake_region(sandbox, row_first, column_first, row_end - row_first, column_end - column_first);
+}
+
+
+void free_stamp(struct Stamp *stamp)
+{
+    if (stamp != NULL)
+    {
+        release_memory(MEMORY_STAMPS, stamp, _get_stamp_bytes(stamp -> height, stamp -> num_runs));
+    }
+}
+
+
+struct StampLibrary *create_stamp_library(void)
+{
+    struct StampLibrary *library = (struct StampLibrary *) allocate_memory(MEMORY_STAMPS, sizeof(struct StampLibrary));
+
+    for (unsigned int i = 0; i < sizeof(PREFABS) / sizeof(PREFABS[0]); i++)
+    {
+        struct Stamp *stamp = create_stamp_from_art(PREFABS[i].art, PREFABS[i].num_rows);
+
+        if (!add_library_stamp(library, PREFABS[i].name, stamp))
+        {
+            free_stamp(stamp);
+        }
+    }
+
+    return library;
+}
+
+
+void free_stamp_library(struct StampLibrary *library)
+{
+    for (unsigned int i = 0; i < library -> num_stamps; i++)
+    {
+        free_stamp(library -> stamps[i]);
+    }
+
+    release_memory(MEMORY_STAMPS, library -> names, library -> capacity * sizeof(*library -> names));
+    release_memory(MEMORY_STAMPS, library -> stamps, library -> capacity * sizeof(*library -> stamps));
+    release_memory(MEMORY_STAMPS, library, sizeof(struct StampLibrary));
+}
+
+
+bool add_library_stamp(struct StampLibrary *library, const char *name, struct Stamp *stamp)
+{
+    if (stamp == NULL)
+    {
+        return false;
+    }
+
+    // Names are padded with 0s, as saved.
+    char library_name[STAMP_NAME_LENGTH] = {0};
+    snprintf(library_name, STAMP_NAME_LENGTH, "%s", name);
+
+    for (unsigned int i = 0; i < library -> num_stamps; i++)
+    {
+        if (strcmp(library -> names[i], library_name) == 0)
+        {
+            if (library -> stamps[i] != stamp)
+            {
+                free_stamp(library -> stamps[i]);
+            }
+
+            library -> stamps[i] = stamp;
+            return true;
+        }
+    }
+
+    if (!_grow_library(library))
+    {
+        return false;
+    }
+
+    memcpy(library -> names[library -> num_stamps], library_name, STAMP_NAME_LENGTH);
+    library -> stamps[library -> num_stamps] = stamp;
+    library -> num_stamps++;
+
+    return true;
+}
+
+
+const struct Stamp *find_library_stamp(const struct StampLibrary *library, const char *name)
+{
+    for (unsigned int i = 0; i < library -> num_stamps; i++)
+    {
+        if (strncmp(library -> names[i], name, STAMP_NAME_LENGTH) == 0)
+        {
+            return library -> stamps[i];
+        }
+    }
+
+    return NULL;
+}
+
+
+bool save_stamp_library(const char *path, const struct StampLibrary *library)
+{
+    FILE *file = fopen(path, "wb");
+
+    if (file == NULL)
+    {
+        return false;
+    }
+
+    unsigned char header_bytes[LIBRARY_HEADER_VALUES * 4];
+    pack_save_u32(&header_bytes[0], STAMP_LIBRARY_VERSION);
+    pack_save_u32(&header_bytes[4], library -> num_stamps);
+
+    bool is_written = fwrite(LIBRARY_MAGIC, 1, 4, file) == 4
+        && fwrite(header_bytes, 1, sizeof(header_bytes), file) == sizeof(header_bytes);
+
+    for (unsigned int i = 0; is_written && i < library -> num_stamps; i++)
+    {
+        const struct Stamp *stamp = library -> stamps[i];
+        unsigned char stamp_bytes[STAMP_HEADER_VALUES * 4];
+
+        pack_save_u32(&stamp_bytes[0], stamp -> height);
+        pack_save_u32(&stamp_bytes[4], stamp -> width);
+        pack_save_u32(&stamp_bytes[8], stamp -> num_runs);
+
+        is_written = fwrite(library -> names[i], 1, STAMP_NAME_LENGTH, file) == STAMP_NAME_LENGTH
+            && fwrite(stamp_bytes, 1, sizeof(stamp_bytes), file) == sizeof(stamp_bytes);
+
+        for (unsigned int j = 0; is_written && j < stamp -> num_runs; j++)
+        {
+            const struct StampRun *run = &stamp -> runs[j];
+            unsigned char run_bytes[RUN_BYTES] = {run -> length & 0xFF, run -> length >> 8, run -> tile, run -> is_opaque};
+
+            is_written = fwrite(run_bytes, 1, RUN_BYTES, file) == RUN_BYTES;
+        }
+    }
+
+    // Closing flushes whatever is left, which may fail too.
+    return fclose(file) == 0 && is_written;
+}
+
+
+bool load_stamp_library(const char *path, struct StampLibrary *library)
+{
+    FILE *file = fopen(path, "rb");
+
+    if (file == NULL)
+    {
+        return false;
+    }
+
+    char magic[4];
+    unsigned char header_bytes[LIBRARY_HEADER_VALUES * 4];
+
+    bool is_valid = fread(magic, 1, 4, file) == 4 && memcmp(magic, LIBRARY_MAGIC, 4) == 0
+        && fread(header_bytes, 1, sizeof(header_bytes), file) == sizeof(header_bytes)
+        && unpack_save_u32(&header_bytes[0]) == STAMP_LIBRARY_VERSION;
+
+    unsigned int num_stamps = is_valid ? unpack_save_u32(&header_bytes[4]) : 0;
+
+    for (unsigned int i = 0; is_valid && i < num_stamps; i++)
+    {
+        char name[STAMP_NAME_LENGTH];
+        struct Stamp *stamp = _read_stamp(file, name);
+
+        is_valid = add_library_stamp(library, name, stamp);
+
+        if (!is_valid)
+        {
+            free_stamp(stamp);
+        }
+    }
+
+    fclose(file);
+
+    return is_valid;
+}
@@ -0,0 +1,230 @@
+#ifndef STAMP_H
+#define STAMP_H
+
+/*
+ * Stamps of tiles copied or cut out of sandboxes and pasted back into them,
+ * such as a clipboard, and libraries of named stamps to reuse, starting out
+ * with prefab structures and machines.
+ *
+ * A stamp is stored run-length encoded, row by row, with each run either
+ * opaque, writing its tile over the sandbox, or transparent, leaving the
+ * sandbox's tiles as they were. Pasting fills each opaque run with memset(),
+ * without looking at the tiles it covers, then wakes and hashes every chunk
+ * it touched once, rather than editing the tiles one by one.
+ *
+ * Stamp libraries are saved to files starting with the 4 bytes "STMP" and
+ * STAMP_LIBRARY_VERSION, followed by the number of stamps. Each stamp is
+ * then its name, padded to STAMP_NAME_LENGTH bytes with 0s, its height, width
+ * and number of runs, and its runs, each as its length in 2 bytes, its tile
+ * and whether it is opaque. Numbers are little endian, with 4 bytes unless
+ * said otherwise.
+ *
+ */
+
+#include "sandbox.h"
+#include "save.h"
+
+// Version of the stamp library format written, and the only one read.
+#define STAMP_LIBRARY_VERSION 1
+
+// Length of stamp names, including the terminating 0.
+#define STAMP_NAME_LENGTH 32
+
+// Longest run of a stamp. Longer stretches of a row are split.
+#define STAMP_MAX_RUN 65535
+
+// Character marking transparent tiles in the art of prefabs, where other
+// tiles are drawn as by print_sandbox().
+#define STAMP_ART_TRANSPARENT ' '
+
+
+// Stretch of a stamp's row, all of one tile or all transparent.
+struct StampRun
+{
+    unsigned short length;
+    unsigned char tile;
+    bool is_opaque;
+};
+
+
+// Rectangle of tiles to paste into sandboxes.
+struct Stamp
+{
+    unsigned int height;
+    unsigned int width;
+
+    // Runs of every row in order, those of each row adding up to its width.
+    struct StampRun *runs;
+    unsigned int num_runs;
+
+    // Index in runs of the first run of each row, and of the end of the last
+    // row after them.
+    unsigned int *row_starts;
+};
+
+
+// Named stamps, such as those at hand in an editor.
+struct StampLibrary
+{
+    char (*names)[STAMP_NAME_LENGTH];
+    struct Stamp **stamps;
+    unsigned int num_stamps;
+    unsigned int capacity;
+};
+
+
+/*
+ * Copy the tiles of a rectangle of a sandbox into a new stamp. Tiles are
+ * copied without their flags, so they start moving once pasted.
+ *
+ * @param sandbox - Sandbox to copy from.
+ * @param height, width - Dimensions of sandbox.
+ * @param row_index, column_index - Coordinates of top left tile of rectangle.
+ * @param stamp_height, stamp_width - Dimensions of rectangle, clipped to the
+ * sandbox.
+ * @param is_air_transparent - Whether air is copied as transparent, so that
+ * pasting the stamp leaves the tiles around its contents in place.
+ *
+ * @return - Newly created stamp, or NULL if the rectangle is empty or could
+ * not be copied.
+ */
+struct Stamp *copy_stamp(unsigned char **sandbox,
+        unsigned int height,
+        unsigned int width,
+        unsigned int row_index,
+        unsigned int column_index,
+        unsigned int stamp_height,
+        unsigned int stamp_width,
+        bool is_air_transparent);
+
+
+/*
+ * Copy the tiles of a rectangle of a sandbox into a new stamp like
+ * copy_stamp(), then fill the rectangle with air.
+ *
+ * @param sandbox - Sandbox to cut from.
+ * @param height, width - Dimensions of sandbox.
+ * @param row_index, column_index - Coordinates of top left tile of rectangle.
+ * @param stamp_height, stamp_width - Dimensions of rectangle, clipped to the
+ * sandbox.
+ * @param is_air_transparent - Whether air is copied as transparent.
+ *
+ * @return - Newly created stamp, or NULL if the rectangle is empty or could
+ * not be copied, in which case nothing is cut.
+ */
+struct Stamp *cut_stamp(unsigned char **sandbox,
+        unsigned int height,
+        unsigned int width,
+        unsigned int row_index,
+        unsigned int column_index,
+        unsigned int stamp_height,
+        unsigned int stamp_width,
+        bool is_air_transparent);
+
+
+/*
+ * Create a stamp from rows of text, drawing each tile as print_sandbox()
+ * prints it, or as STAMP_ART_TRANSPARENT to leave it transparent. Rows
+ * shorter than the longest are transparent past their end.
+ *
+ * @param art - Rows of text, top to bottom.
+ * @param num_rows - Number of rows.
+ *
+ * @return - Newly created stamp, or NULL if the art is empty or holds
+ * characters other than tiles.
+ */
+struct Stamp *create_stamp_from_art(const char *const *art, unsigned int num_rows);
+
+
+/*
+ * Write the opaque tiles of a stamp into a sandbox, clipping whatever lies
+ * outside of it, then wake the rectangle pasted over like wake_region().
+ *
+ * @param sandbox - Sandbox to paste into.
+ * @param height, width - Dimensions of sandbox.
+ * @param stamp - Stamp to paste.
+ * @param row_index, column_index - Coordinates to paste the top left tile of
+ * the stamp at, which may lie outside of the sandbox.
+ */
+void paste_stamp(unsigned char **sandbox,
+        unsigned int height,
+        unsigned int width,
+        const struct Stamp *stamp,
+        int row_index,
+        int column_index);
+
+
+/*
+ * Free a stamp.
+ *
+ * @param stamp - Stamp to free, or NULL to do nothing.
+ */
+void free_stamp(struct Stamp *stamp);
+
+
+/*
+ * Create a library holding every prefab structure and machine.
+ *
+ * @return - Newly created library.
+ */
+struct StampLibrary *create_stamp_library(void);
+
+
+/*
+ * Free a library, along with each of its stamps.
+ *
+ * @param library - Library to free.
+ */
+void free_stamp_library(struct StampLibrary *library);
+
+
+/*
+ * Add a stamp to a library, replacing and freeing any stamp already going by
+ * its name.
+ *
+ * @param library - Library to add to.
+ * @param name - Name of stamp, cut short to fit STAMP_NAME_LENGTH.
+ * @param stamp - Stamp to add, freed along with the library from now on.
+ *
+ * @return - True if the stamp was added, false if there was no memory left,
+ * in which case the caller keeps it.
+ */
+bool add_library_stamp(struct StampLibrary *library, const char *name, struct Stamp *stamp);
+
+
+/*
+ * Find a stamp of a library by its name.
+ *
+ * @param library - Library to search.
+ * @param name - Name of stamp.
+ *
+ * @return - Stamp going by the name, or NULL if there is none.
+ */
+const struct Stamp *find_library_stamp(const struct StampLibrary *library, const char *name);
+
+
+/*
+ * Write every stamp of a library to a new file, replacing any existing one.
+ *
+ * @param path - Path of file to write.
+ * @param library - Library to save.
+ *
+ * @return - True if the file was written, false otherwise.
+ */
+bool save_stamp_library(const char *path, const struct StampLibrary *library);
+
+
+/*
+ * Read the stamps saved in a file into a library, replacing those of the same
+ * names.
+ *
+ * @param path - Path of file to read.
+ * @param library - Library to add stamps to.
+ *
+ * @return - True if every stamp was read, false otherwise, in which case the
+ * stamps read before the failure are kept.
+ */
+bool load_stamp_library(const char *path, struct StampLibrary *library);
+
+
+#endif
@@ -0,0 +1,430 @@
+/*
+ * Implementation of terminal.h interface.
+ *
+ */
+
+#include "terminal.h"
+
+// Bytes buffered before being written to the terminal.
+#define OUTPUT_BUFFER_SIZE 65536
+
+// Most bytes written for one cell: a cursor move, both colors and a half block.
+#define MAX_CELL_BYTES 64
+
+// Number of changes read from the feed at a time.
+#define CHANGE_BATCH 256
+
+// Tile shown by cells never drawn, matching no real tile.
+#define UNDRAWN 0xFF
+
+// Number of tile IDs, held by the low four bits of a tile.
+#define NUM_TILE_IDS 16
+
+// Upper half block, in UTF-8.
+#define HALF_BLOCK "\xe2\x96\x80"
+
+
+struct TerminalRenderer
+{
+    unsigned char **sandbox;
+    unsigned int height;
+    unsigned int width;
+
+    // Dimensions of the part of the terminal showing the sandbox, in cells.
+    unsigned int cell_rows;
+    unsigned int cell_columns;
+
+    // Tile IDs last written to each cell, upper then lower.
+    unsigned char *shown;
+
+    // Whether each chunk of the sandbox may have cells left to write.
+    bool *dirty_chunks;
+    unsigned int chunk_rows;
+    unsigned int chunk_columns;
+
+    // Visible chunk, counting row by row, the next frame starts from. Frames
+    // cut short by their byte budget carry on from the chunk they stopped
+    // at, so chunks changing every frame cannot starve those after them.
+    unsigned int next_chunk;
+
+    // Cursor into the sandbox's change feed.
+    unsigned long cursor;
+
+    FILE *output;
+    char *buffer;
+    unsigned int buffer_used;
+
+    // Bytes appended during the current frame.
+    unsigned long frame_bytes;
+
+    // Cell the terminal's cursor is at, and the colors it writes with, or -1
+    // if not known.
+    int cursor_row;
+    int cursor_column;
+    long foreground;
+    long background;
+};
+
+
+// Color of each tile ID, matching their textures. Tiles not implemented yet
+// are left black, drawn as air as they are in the window.
+static const unsigned int TILE_COLORS[NUM_TILE_IDS] =
+{
+    0x000000,
+    0xffde6b,
+    0x40c5ff,
+    0xbc9862,
+    0xe9e9e9,
+    0xff6b01
+};
+
+
+// ----- PRIVATE FUNCTIONS -----
+
+
+/*
+ * Write out the buffered bytes of a renderer.
+ *
+ * @param renderer - Renderer to flush the buffer of.
+ */
+static void _flush_buffer(struct TerminalRenderer *renderer)
+{
+    fwrite(renderer -> buffer, 1, renderer -> buffer_used, renderer -> output);
+    renderer -> buffer_used = 0;
+}
+
+
+/*
+ * Append bytes to the buffer of a renderer, writing it out first if full.
+ *
+ * @param renderer - Renderer to buffer bytes of.
+ * @param bytes - Bytes to append.
+ * @param num_bytes - Number of bytes to append.
+ */
+static void _append(struct TerminalRenderer *renderer, const char *bytes, unsigned int num_bytes)
+{
+    if (renderer -> buffer_used + num_bytes > OUTPUT_BUFFER_SIZE)
+    {
+        _flush_buffer(renderer);
+    }
+
+    memcpy(renderer -> buffer + renderer -> buffer_used, bytes, num_bytes);
+    renderer -> buffer_used += num_bytes;
+    renderer -> frame_bytes += num_bytes;
+}
+
+
+/*
+ * Encode the escape sequence setting a foreground or background color, unless
+ * the terminal already writes with it.
+ *
+ * @param bytes - Filled with the sequence.
+ * @param current - Color currently written with, set to color.
+ * @param color - Color to write with.
+ * @param layer - 38 for the foreground, 48 for the background.
+ *
+ * @return - Number of bytes encoded.
+ */
+static int _encode_color(char *bytes, long *current, unsigned int color, int layer)
+{
+    if (*current == (long) color)
+    {
+        return 0;
+    }
+
+    *current = color;
+
+    return sprintf(bytes, "\x1b[%d;2;%u;%u;%um", layer, color >> 16, (color >> 8) & 0xFF, color & 0xFF);
+}
+
+
+/*
+ * Encode a cell showing two tiles, along with any cursor move and color
+ * changes needed to write it, and update the terminal state to match.
+ *
+ * @param renderer - Renderer holding the terminal state.
+ * @param bytes - Filled with the encoded cell, at least MAX_CELL_BYTES long.
+ * @param cell_row, cell_column - Coordinates of cell.
+ * @param upper, lower - Tiles shown in the upper and lower halves of cell.
+ *
+ * @return - Number of bytes encoded.
+ */
+static int _encode_cell(struct TerminalRenderer *renderer,
+        char *bytes,
+        unsigned int cell_row,
+        unsigned int cell_column,
+        unsigned char upper,
+        unsigned char lower)
+{
+    int num_bytes = 0;
+
+    if (renderer -> cursor_row != (int) cell_row || renderer -> cursor_column != (int) cell_column)
+    {
+        num_bytes += sprintf(bytes, "\x1b[%u;%uH", cell_row + 1, cell_column + 1);
+    }
+
+    unsigned int upper_color = get_tile_color(upper);
+    unsigned int lower_color = get_tile_color(lower);
+
+    // A cell of one color is just a space, needing only a background.
+    if (upper_color == lower_color)
+    {
+        num_bytes += _encode_color(bytes + num_bytes, &renderer -> background, lower_color, 48);
+        bytes[num_bytes++] = ' ';
+    }
+    else
+    {
+        num_bytes += _encode_color(bytes + num_bytes, &renderer -> foreground, upper_color, 38);
+        num_bytes += _encode_color(bytes + num_bytes, &renderer -> background, lower_color, 48);
+        memcpy(bytes + num_bytes, HALF_BLOCK, sizeof(HALF_BLOCK) - 1);
+        num_bytes += sizeof(HALF_BLOCK) - 1;
+    }
+
+    renderer -> cursor_row = cell_row;
+    renderer -> cursor_column = cell_column + 1;
+
+    // Terminals differ in where the cursor goes after the last column.
+    if (cell_column + 1 >= renderer -> cell_columns)
+    {
+        renderer -> cursor_row = -1;
+    }
+
+    return num_bytes;
+}
+
+
+/*
+ * Mark the chunks changed since the last frame as dirty, or every chunk if
+ * the change feed cannot tell which.
+ *
+ * @param renderer - Renderer to mark chunks of.
+ */
+static void _read_dirty_chunks(struct TerminalRenderer *renderer)
+{
+    struct TileChange changes[CHANGE_BATCH];
+    unsigned int num_read;
+
+    do
+    {
+        if (!read_changes(renderer -> sandbox, &renderer -> cursor, changes, CHANGE_BATCH, &num_read))
+        {
+            memset(renderer -> dirty_chunks, true, renderer -> chunk_rows * renderer -> chunk_columns * sizeof(bool));
+            return;
+        }
+
+        for (unsigned int i = 0; i < num_read; i++)
+        {
+            renderer -> dirty_chunks[changes[i].row * renderer -> chunk_columns + changes[i].column] = true;
+        }
+    }
+    while (num_read == CHANGE_BATCH);
+}
+
+
+/*
+ * Write out the changed cells of a chunk, within a byte budget.
+ *
+ * @param renderer - Renderer to draw with.
+ * @param chunk_row, chunk_column - Coordinates of chunk.
+ * @param bytes_left - Bytes the frame may still write, reduced by those
+ * written, or NULL for no limit.
+ *
+ * @return - True if every changed cell was written, false if the budget ran
+ * out first.
+ */
+static bool _draw_chunk(struct TerminalRenderer *renderer,
+        unsigned int chunk_row,
+        unsigned int chunk_column,
+        unsigned long *bytes_left)
+{
+    // Chunks are an even number of tiles tall, so cells never straddle two.
+    unsigned int first_cell_row = chunk_row * CHUNK_SIZE / 2;
+    unsigned int end_cell_row = first_cell_row + CHUNK_SIZE / 2;
+    unsigned int first_column = chunk_column * CHUNK_SIZE;
+    unsigned int end_column = first_column + CHUNK_SIZE;
+
+    end_cell_row = end_cell_row < renderer -> cell_rows ? end_cell_row : renderer -> cell_rows;
+    end_column = end_column < renderer -> cell_columns ? end_column : renderer -> cell_columns;
+
+    for (unsigned int cell_row = first_cell_row; cell_row < end_cell_row; cell_row++)
+    {
+        unsigned char *upper_row = renderer -> sandbox[2 * cell_row];
+
+        // Sandboxes of odd height leave the last lower half empty.
+        unsigned char *lower_row = 2 * cell_row + 1 < renderer -> height ? renderer -> sandbox[2 * cell_row + 1] : NULL;
+
+        for (unsigned int col = first_column; col < end_column; col++)
+        {
+            unsigned char upper = get_tile_id(upper_row[col]);
+            unsigned char lower = lower_row != NULL ? get_tile_id(lower_row[col]) : AIR;
+            unsigned char *shown = &renderer -> shown[2 * (cell_row * renderer -> cell_columns + col)];
+
+            if (shown[0] == upper && shown[1] == lower)
+            {
+                continue;
+            }
+
+            // Keep the terminal state from before the cell, in case it does
+            // not fit in the budget.
+            int cursor_row = renderer -> cursor_row;
+            int cursor_column = renderer -> cursor_column;
+            long foreground = renderer -> foreground;
+            long background = renderer -> background;
+
+            char bytes[MAX_CELL_BYTES];
+            int num_bytes = _encode_cell(renderer, bytes, cell_row, col, upper, lower);
+
+            if (bytes_left != NULL)
+            {
+                if ((unsigned long) num_bytes > *bytes_left)
+                {
+                    renderer -> cursor_row = cursor_row;
+                    renderer -> cursor_column = cursor_column;
+                    renderer -> foreground = foreground;
+                    renderer -> background = background;
+                    return false;
+                }
+
+                *bytes_left -= num_bytes;
+            }
+
+            _append(renderer, bytes, num_bytes);
+            shown[0] = upper;
+            shown[1] = lower;
+        }
+    }
+
+    return true;
+}
+
+
+// ----- PUBLIC FUNCTIONS -----
+
+
+struct TerminalRenderer *create_terminal_renderer(unsigned char **sandbox,
+        unsigned int height,
+        unsigned int width,
+        unsigned int terminal_rows,
+        unsigned int terminal_columns,
+        FILE *output)
+{
+    unsigned int sandbox_cell_rows = (height + 1) / 2;
+    unsigned int cell_rows = terminal_rows < sandbox_cell_rows ? terminal_rows : sandbox_cell_rows;
+    unsigned int cell_columns = terminal_columns < width ? terminal_columns : width;
+    unsigned int num_cells = cell_rows * cell_columns;
+
+    unsigned int chunk_rows = (height + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    unsigned int chunk_columns = (width + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    unsigned int num_chunks = chunk_rows * chunk_columns;
+
+    struct TerminalRenderer *renderer = (struct TerminalRenderer *) allocate_memory(MEMORY_PLANES, sizeof(struct TerminalRenderer));
+    unsigned char *shown = (unsigned char *) allocate_memory(MEMORY_PLANES, 2 * num_cells);
+    bool *dirty_chunks = (bool *) allocate_memory(MEMORY_PLANES, num_chunks * sizeof(bool));
+    char *buffer = (char *) allocate_memory(MEMORY_PLANES, OUTPUT_BUFFER_SIZE);
+
+    if (renderer == NULL || shown == NULL || dirty_chunks == NULL || buffer == NULL)
+    {
+        release_memory(MEMORY_PLANES, renderer, sizeof(struct TerminalRenderer));
+        release_memory(MEMORY_PLANES, shown, 2 * num_cells);
+        release_memory(MEMORY_PLANES, dirty_chunks, num_chunks * sizeof(bool));
+        release_memory(MEMORY_PLANES, buffer, OUTPUT_BUFFER_SIZE);
+        return NULL;
+    }
+
+    renderer -> sandbox = sandbox;
+    renderer -> height = height;
+    renderer -> width = width;
+
+    renderer -> cell_rows = cell_rows;
+    renderer -> cell_columns = cell_columns;
+
+    renderer -> shown = shown;
+    memset(renderer -> shown, UNDRAWN, 2 * num_cells);
+
+    // Every chunk starts out dirty, so the first frame draws every cell.
+    renderer -> chunk_rows = chunk_rows;
+    renderer -> chunk_columns = chunk_columns;
+    renderer -> dirty_chunks = dirty_chunks;
+    memset(renderer -> dirty_chunks, true, num_chunks * sizeof(bool));
+    renderer -> next_chunk = 0;
+
+    set_change_feed(sandbox, CHANGES_CHUNKS, num_chunks * TERMINAL_FEED_RECORDS_PER_CHUNK);
+    renderer -> cursor = get_change_cursor(sandbox);
+
+    renderer -> output = output;
+    renderer -> buffer = buffer;
+    renderer -> buffer_used = 0;
+    renderer -> frame_bytes = 0;
+
+    renderer -> cursor_row = -1;
+    renderer -> cursor_column = -1;
+    renderer -> foreground = -1;
+    renderer -> background = -1;
+
+    // Hide the cursor and clear the terminal.
+    fputs("\x1b[?25l\x1b[2J", output);
+
+    return renderer;
+}
+
+
+void free_terminal_renderer(struct TerminalRenderer *renderer)
+{
+    // Reset colors, show the cursor again, and leave it below the sandbox.
+    fprintf(renderer -> output, "\x1b[0m\x1b[?25h\x1b[%u;1H\n", renderer -> cell_rows);
+    fflush(renderer -> output);
+
+    set_change_feed(renderer -> sandbox, CHANGES_CHUNKS, 0);
+
+    release_memory(MEMORY_PLANES, renderer -> shown, 2 * renderer -> cell_rows * renderer -> cell_columns);
+    release_memory(MEMORY_PLANES, renderer -> dirty_chunks, renderer -> chunk_rows * renderer -> chunk_columns * sizeof(bool));
+    release_memory(MEMORY_PLANES, renderer -> buffer, OUTPUT_BUFFER_SIZE);
+    release_memory(MEMORY_PLANES, renderer, sizeof(struct TerminalRenderer));
+}
+
+
+unsigned long draw_terminal_frame(struct TerminalRenderer *renderer, unsigned long max_bytes)
+{
+    _read_dirty_chunks(renderer);
+    renderer -> frame_bytes = 0;
+
+    unsigned long bytes_left = max_bytes;
+    unsigned int visible_chunk_rows = (2 * renderer -> cell_rows + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    unsigned int visible_chunk_columns = (renderer -> cell_columns + CHUNK_SIZE - 1) / CHUNK_SIZE;
+
+    unsigned int num_visible_chunks = visible_chunk_rows * visible_chunk_columns;
+
+    for (unsigned int i = 0; i < num_visible_chunks; i++)
+    {
+        unsigned int visible_chunk = (renderer -> next_chunk + i) % num_visible_chunks;
+        unsigned int chunk_row = visible_chunk / visible_chunk_columns;
+        unsigned int chunk_column = visible_chunk % visible_chunk_columns;
+        bool *is_dirty = &renderer -> dirty_chunks[chunk_row * renderer -> chunk_columns + chunk_column];
+
+        if (!*is_dirty)
+        {
+            continue;
+        }
+
+        // Chunks not written in full stay dirty, and are the first drawn by
+        // the next frame.
+        if (!_draw_chunk(renderer, chunk_row, chunk_column, max_bytes > 0 ? &bytes_left : NULL))
+        {
+            renderer -> next_chunk = visible_chunk;
+            break;
+        }
+
+        *is_dirty = false;
+    }
+
+    _flush_buffer(renderer);
+    fflush(renderer -> output);
+
+    return renderer -> frame_bytes;
+}
+
+
+unsigned int get_tile_color(unsigned char tile)
+{
+    return TILE_COLORS[get_tile_id(tile)];
+}
@@ -0,0 +1,84 @@
+#ifndef TERMINAL_H
+#define TERMINAL_H
+
+/*
+ * Rendering of sandboxes to ANSI terminals, such as over SSH, in 24-bit color.
+ *
+ * Each character cell shows two tiles, one above the other, as a half block
+ * colored with the upper tile over a background of the lower tile. After the
+ * first frame, only the cells that changed are written, along with the
+ * cursor moves and color changes needed to reach them. The chunks to compare
+ * are taken from the sandbox's change feed, so a still sandbox costs nothing
+ * to redraw, and a byte budget per frame keeps slow links from falling
+ * behind, leaving whatever did not fit for the next frames, which carry on
+ * from where it stopped.
+ *
+ */
+
+#include <stdio.h>
+#include "sandbox.h"
+
+// Number of chunk records the change feed of a rendered sandbox holds, per
+// chunk of the sandbox.
+#define TERMINAL_FEED_RECORDS_PER_CHUNK 2
+
+
+// A renderer drawing one sandbox to one terminal.
+struct TerminalRenderer;
+
+
+/*
+ * Start rendering a sandbox to a terminal, showing its top left corner.
+ *
+ * The sandbox is given a change feed of chunks, replacing any feed it had.
+ *
+ * @param sandbox - Sandbox to render.
+ * @param height, width - Dimensions of sandbox.
+ * @param terminal_rows, terminal_columns - Dimensions of terminal in
+ * character cells. Each cell shows two tiles of one column.
+ * @param output - Stream the terminal is written to.
+ *
+ * @return - Newly created renderer, or NULL if there was not enough memory
+ * for it, in which case nothing is written and the sandbox is left as it was.
+ */
+struct TerminalRenderer *create_terminal_renderer(unsigned char **sandbox,
+        unsigned int height,
+        unsigned int width,
+        unsigned int terminal_rows,
+        unsigned int terminal_columns,
+        FILE *output);
+
+
+/*
+ * Free a terminal renderer, leaving the terminal's colors and cursor as they
+ * were before it drew anything.
+ *
+ * @param renderer - Renderer to free.
+ */
+void free_terminal_renderer(struct TerminalRenderer *renderer);
+
+
+/*
+ * Write out every cell that changed since the last frame drawn, then flush
+ * the output.
+ *
+ * @param renderer - Renderer to draw with.
+ * @param max_bytes - Maximum number of bytes to write, or 0 for no limit.
+ * Cells that did not fit are written by the next frames.
+ *
+ * @return - Number of bytes written.
+ */
+unsigned long draw_terminal_frame(struct TerminalRenderer *renderer, unsigned long max_bytes);
+
+
+/*
+ * Return the 24-bit color a tile is drawn with, matching its texture.
+ *
+ * @param tile - Tile to color.
+ *
+ * @return - Color as 0xRRGGBB.
+ */
+unsigned int get_tile_color(unsigned char tile);
+
+
+#endif
@@ -1,8 +1,213 @@
 #include "sandbox.h"
+#include "chunk_cache.h"
 #include <unistd.h>
 
+// Blocks allocated and released through the counting allocator.
+static unsigned long NUM_ALLOCATIONS = 0;
+
+
+static void *_count_allocate(size_t bytes, void *context)
+{
+    NUM_ALLOCATIONS++;
+    return calloc(1, bytes);
+}
+
+
+static void _count_release(void *block, size_t bytes, void *context)
+{
+    NUM_ALLOCATIONS++;
+    free(block);
+}
+
+
+/*
+ * Step a busy sandbox, with the chunk cache, a change feed and rollback in
+ * use, and check that no frame allocates or frees anything once it is set up.
+ * SANDBOX_LIFETIME is left as it was.
+ *
+ * @return - True if stepping allocated nothing, false otherwise.
+ */
+static bool _check_steady_state_allocations(void)
+{
+    unsigned int height = 256;
+    unsigned int width = 256;
+    unsigned char **sandbox = create_sandbox(height, width);
+    unsigned int lifetime = SANDBOX_LIFETIME;
+
+    srand(1);
+
+    for (unsigned int row = 0; row < height; row++)
+    {
+        for (unsigned int col = 0; col < width; col++)
+        {
+            sandbox[row][col] = rand() % 3 == 0 ? rand() % 6 : AIR;
+        }
+    }
+
+    wake_sandbox(sandbox);
+    set_chunk_cache_enabled(true);
+    set_change_feed(sandbox, CHANGES_TILES, 4096);
+
+    struct SandboxState *state = create_sandbox_state(sandbox);
+    struct TileChange changes[256];
+    unsigned long cursor = get_change_cursor(sandbox);
+    unsigned int num_read;
+
+    unsigned long allocations_before = NUM_ALLOCATIONS;
+
+    for (unsigned int frame = 0; frame < 500; frame++)
+    {
+        if (frame % 50 == 0)
+        {
+            edit_tile(sandbox, 0, frame % width, SAND);
+            save_sandbox_state(state, NULL);
+        }
+
+        if (frame % 200 == 199)
+        {
+            restore_sandbox_state(state, NULL);
+        }
+
+        process_sandbox(sandbox, height, width);
+        read_changes(sandbox, &cursor, changes, 256, &num_read);
+    }
+
+    unsigned long steady_allocations = NUM_ALLOCATIONS - allocations_before;
+    printf("Steady state stepping allocated %lu times: %s\n", steady_allocations, steady_allocations == 0 ? "PASS" : "FAIL");
+
+    free_sandbox_state(state);
+    sandbox_free(sandbox, height, width);
+    set_chunk_cache_enabled(false);
+
+    // The demo after this stops after its first 15 frames.
+    SANDBOX_LIFETIME = lifetime;
+
+    return steady_allocations == 0;
+}
+
+
+/*
+ * Build a scene of two basins split by a wood ridge, the left one shallower,
+ * with water poured into the left one between the given rows.
+ *
+ * @param sandbox - Sandbox of at least 32 by 48 tiles, cleared to air.
+ * @param water_top - First row of water.
+ */
+static void _build_two_basins(unsigned char **sandbox, unsigned int water_top)
+{
+    for (unsigned int row = 0; row < 32; row++)
+    {
+        for (unsigned int col = 0; col < 48; col++)
+        {
+            bool is_floor = row >= 24 && col < 22;
+            bool is_ridge = row >= 12 && (col == 22 || col == 23);
+
+            if (is_floor || is_ridge)
+            {
+                sandbox[row][col] = WOOD;
+            }
+            else if (row >= water_top && row < 24 && col < 22)
+            {
+                sandbox[row][col] = WATER;
+            }
+        }
+    }
+
+    wake_sandbox(sandbox);
+}
+
+
+/*
+ * Count the water left of the right basin, up to and including the ridge.
+ *
+ * @param sandbox - Sandbox built by _build_two_basins().
+ *
+ * @return - Number of water tiles outside the right basin.
+ */
+static unsigned int _count_left_water(unsigned char **sandbox)
+{
+    unsigned int count = 0;
+
+    for (unsigned int row = 0; row < 32; row++)
+    {
+        for (unsigned int col = 0; col < 24; col++)
+        {
+            count += get_tile_id(sandbox[row][col]) == WATER;
+        }
+    }
+
+    return count;
+}
+
+
+/*
+ * Check that settling leaves water in the same basins as simulating until it
+ * comes to rest does, for a basin that holds all its water and one that
+ * overflows into its deeper neighbour. SANDBOX_LIFETIME is left as it was.
+ *
+ * @return - True if settling matched simulation, false otherwise.
+ */
+static bool _check_settle_matches_simulation(void)
+{
+    unsigned int height = 32;
+    unsigned int width = 48;
+    unsigned int lifetime = SANDBOX_LIFETIME;
+
+    // Water from row 18 fits below the ridge, from row 8 it overflows.
+    unsigned int water_tops[2] = {18, 8};
+    bool is_matching = true;
+
+    for (unsigned int i = 0; i < 2; i++)
+    {
+        unsigned char **settled = create_sandbox(height, width);
+        unsigned char **simulated = create_sandbox(height, width);
+
+        _build_two_basins(settled, water_tops[i]);
+        _build_two_basins(simulated, water_tops[i]);
+
+        settle_sandbox(settled, height, width);
+
+        for (unsigned int frame = 0; frame < 3000; frame++)
+        {
+            process_sandbox(simulated, height, width);
+        }
+
+        unsigned int settled_left = _count_left_water(settled);
+        unsigned int simulated_left = _count_left_water(simulated);
+
+        printf("Settled basin holds %u of %u simulated water tiles: %s\n",
+                settled_left,
+                simulated_left,
+                settled_left == simulated_left ? "PASS" : "FAIL");
+
+        is_matching = is_matching && settled_left == simulated_left;
+
+        sandbox_free(settled, height, width);
+        sandbox_free(simulated, height, width);
+    }
+
+    free_settle_scratch();
+    SANDBOX_LIFETIME = lifetime;
+
+    return is_matching;
+}
+
+
 int main(void)
 {
+    struct Allocator counting_allocator = {_count_allocate, _count_release, NULL};
+    set_allocator(&counting_allocator);
+
+    if (!_check_steady_state_allocations())
+    {
+        return 1;
+    }
+
+    if (!_check_settle_matches_simulation())
+    {
+        return 1;
+    }
+
     unsigned char **sandbox = create_sandbox(10, 10);
 
     /*
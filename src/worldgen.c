@@ -0,0 +1,456 @@
+/*
+ * Implementation of worldgen.h interface.
+ *
+ */
+
+#include "worldgen.h"
+
+// Seeds of each noise, mixed into the world's seed so they are unrelated.
+#define HILL_NOISE 0x68696c6c
+#define DUNE_NOISE 0x64756e65
+#define FOREST_NOISE 0x666f7273
+#define CAVE_NOISE 0x63617665
+#define TREE_HASH 0x74726565
+#define VENT_HASH 0x76656e74
+
+// Widths in tiles of hills and dunes, and size of caves.
+#define HILL_SCALE 96.0
+#define DUNE_SCALE 20.0
+#define FOREST_SCALE 64.0
+#define CAVE_SCALE 18.0
+
+// Noise above which ground is carved out into caves.
+#define CAVE_THRESHOLD 0.6
+
+// Fraction of the way down below which valleys are flooded.
+#define WATER_LINE 0.6
+
+// Rows of solid ground kept above caves, so the surface holds up.
+#define CAVE_ROOF 4
+
+// Columns per cell with at most one tree, and per cell with at most one vent.
+#define TREE_CELL 12
+#define VENT_CELL 40
+
+
+// Everything about a column of the world which does not depend on the row.
+struct ColumnProfile
+{
+    // Rows of the topmost wood ground tile and topmost sand tile.
+    unsigned int ground_row;
+    unsigned int sand_row;
+
+    // Whether steam rises from the caves of this column.
+    bool is_vent;
+};
+
+
+// A tree growing out of the ground of one tree cell.
+struct Tree
+{
+    bool exists;
+    int trunk_column;
+
+    // Rows of the ground the trunk grows from, and of the canopy's center.
+    int root_row;
+    int crown_row;
+
+    int canopy_radius;
+};
+
+
+// Work handed to each generating thread.
+struct WorldgenTask
+{
+    unsigned char **sandbox;
+    unsigned int height;
+    unsigned int width;
+    unsigned int seed;
+
+    // The thread generates every num_threads-th chunk, starting at first.
+    unsigned int first_chunk;
+    unsigned int num_threads;
+};
+
+
+// ----- PRIVATE FUNCTIONS -----
+
+
+/*
+ * Hash a seed and two coordinates into an unrelated value.
+ *
+ * @param seed - Seed of hash.
+ * @param x, y - Coordinates to hash.
+ *
+ * @return - Hash of seed and coordinates.
+ */
+static unsigned int _hash(unsigned int seed, int x, int y)
+{
+    unsigned int value = seed ^ ((unsigned int) x * 0x9e3779b9) ^ ((unsigned int) y * 0x85ebca6b);
+
+    // Finalizer of MurmurHash3.
+    value ^= value >> 16;
+    value *= 0x85ebca6b;
+    value ^= value >> 13;
+    value *= 0xc2b2ae35;
+    value ^= value >> 16;
+
+    return value;
+}
+
+
+/*
+ * Return a value between 0 and 1, hashed from a seed and two coordinates.
+ *
+ * @param seed - Seed of value.
+ * @param x, y - Coordinates of value.
+ *
+ * @return - Value in [0, 1).
+ */
+static double _lattice_value(unsigned int seed, int x, int y)
+{
+    return _hash(seed, x, y) / 4294967296.0;
+}
+
+
+/*
+ * Interpolate between two values, easing in and out.
+ *
+ * @param a, b - Values at 0 and 1.
+ * @param t - Point to interpolate at, in [0, 1].
+ *
+ * @return - Interpolated value.
+ */
+static double _ease(double a, double b, double t)
+{
+    t = t * t * (3 - 2 * t);
+    return a + (b - a) * t;
+}
+
+
+/*
+ * Sample smooth value noise with several octaves at the given point.
+ *
+ * @param seed - Seed of noise.
+ * @param x, y - Point to sample at, with features about 1 apart.
+ *
+ * @return - Noise in [0, 1).
+ */
+static double _noise(unsigned int seed, double x, double y)
+{
+    double total = 0;
+    double amplitude = 0.5;
+    double scale = 1;
+
+    for (unsigned int octave = 0; octave < 4; octave++)
+    {
+        double sample_x = x * scale;
+        double sample_y = y * scale;
+        int cell_x = (int) floor(sample_x);
+        int cell_y = (int) floor(sample_y);
+        double offset_x = sample_x - cell_x;
+        double offset_y = sample_y - cell_y;
+        unsigned int octave_seed = seed + octave * 0x27d4eb2d;
+
+        double top = _ease(_lattice_value(octave_seed, cell_x, cell_y), _lattice_value(octave_seed, cell_x + 1, cell_y), offset_x);
+        double bottom = _ease(_lattice_value(octave_seed, cell_x, cell_y + 1), _lattice_value(octave_seed, cell_x + 1, cell_y + 1), offset_x);
+
+        total += amplitude * _ease(top, bottom, offset_y);
+        amplitude /= 2;
+        scale *= 2;
+    }
+
+    // Amplitudes add up to just under 1.
+    return total / (1 - amplitude * 2);
+}
+
+
+/*
+ * Work out everything about a column of the world which does not depend on
+ * the row.
+ *
+ * @param seed - Seed of the world.
+ * @param height - Height of the world.
+ * @param column_index - Column to work out.
+ *
+ * @return - Profile of column.
+ */
+static struct ColumnProfile _get_column_profile(unsigned int seed, unsigned int height, unsigned int column_index)
+{
+    struct ColumnProfile profile;
+
+    // Hills put the ground between 35% and 80% of the way down.
+    double hill = _noise(seed ^ HILL_NOISE, column_index / HILL_SCALE, 0);
+    profile.ground_row = (unsigned int) (height * (0.35 + 0.45 * hill));
+
+    // Dunes pile up to 8 tiles of sand on the ground.
+    double dune = _noise(seed ^ DUNE_NOISE, column_index / DUNE_SCALE, 0);
+    unsigned int sand_depth = dune > 0.35 ? (unsigned int) ((dune - 0.35) * 12) : 0;
+    profile.sand_row = profile.ground_row > sand_depth ? profile.ground_row - sand_depth : 0;
+
+    // Each vent cell has a single vent column, if any.
+    unsigned int vent_cell = column_index / VENT_CELL;
+    unsigned int vent_hash = _hash(seed ^ VENT_HASH, vent_cell, 0);
+    profile.is_vent = vent_hash % 3 == 0 && column_index % VENT_CELL == 4 + (vent_hash >> 8) % (VENT_CELL - 8);
+
+    return profile;
+}
+
+
+/*
+ * Work out the tree growing in the given tree cell, if any.
+ *
+ * @param seed - Seed of the world.
+ * @param height, width - Dimensions of the world.
+ * @param cell - Tree cell to work out the tree of.
+ *
+ * @return - Tree of cell.
+ */
+static struct Tree _get_tree(unsigned int seed, unsigned int height, unsigned int width, int cell)
+{
+    struct Tree tree = {false, 0, 0, 0, 0};
+
+    if (cell < 0)
+    {
+        return tree;
+    }
+
+    unsigned int tree_hash = _hash(seed ^ TREE_HASH, cell, 0);
+    tree.trunk_column = cell * TREE_CELL + 2 + tree_hash % (TREE_CELL - 4);
+
+    // Trees only grow in forests, on dry ground.
+    if (tree.trunk_column >= (int) width
+            || (tree_hash >> 8) % 4 == 0
+            || _noise(seed ^ FOREST_NOISE, tree.trunk_column / FOREST_SCALE, 0) < 0.45)
+    {
+        return tree;
+    }
+
+    struct ColumnProfile profile = _get_column_profile(seed, height, tree.trunk_column);
+
+    if (profile.sand_row >= (unsigned int) (height * WATER_LINE))
+    {
+        return tree;
+    }
+
+    tree.exists = true;
+    tree.root_row = profile.sand_row;
+    tree.crown_row = (int) profile.sand_row - (int) (5 + (tree_hash >> 12) % 6);
+    tree.canopy_radius = 2 + (tree_hash >> 16) % 2;
+
+    return tree;
+}
+
+
+/*
+ * Return whether a tree covers the tile at the given coordinates.
+ *
+ * @param tree - Tree to check.
+ * @param row_index, column_index - Coordinates of tile.
+ *
+ * @return - True if the tile is part of the tree, false otherwise.
+ */
+static bool _is_in_tree(const struct Tree *tree, unsigned int row_index, unsigned int column_index)
+{
+    if (!tree -> exists)
+    {
+        return false;
+    }
+
+    int row_offset = (int) row_index - tree -> crown_row;
+    int column_offset = (int) column_index - tree -> trunk_column;
+
+    bool is_trunk = column_offset == 0 && row_offset >= 0 && (int) row_index < tree -> root_row;
+    bool is_canopy = row_offset * row_offset + column_offset * column_offset <= tree -> canopy_radius * tree -> canopy_radius;
+
+    return is_trunk || is_canopy;
+}
+
+
+/*
+ * Generate a tile from the profile of its column and the trees around it.
+ *
+ * @param seed - Seed of the world.
+ * @param height - Height of the world.
+ * @param profile - Profile of the tile's column.
+ * @param trees - Trees of the tile's tree cell and the cells either side.
+ * @param row_index, column_index - Coordinates of tile.
+ *
+ * @return - Generated tile.
+ */
+static unsigned char _generate_profiled_tile(unsigned int seed,
+        unsigned int height,
+        const struct ColumnProfile *profile,
+        const struct Tree trees[3],
+        unsigned int row_index,
+        unsigned int column_index)
+{
+    if (row_index >= profile -> ground_row)
+    {
+        // Caves stay below a roof of solid ground.
+        if (row_index >= profile -> ground_row + CAVE_ROOF
+                && _noise(seed ^ CAVE_NOISE, column_index / CAVE_SCALE, row_index / CAVE_SCALE) > CAVE_THRESHOLD)
+        {
+            return profile -> is_vent ? STEAM : AIR;
+        }
+
+        return WOOD;
+    }
+
+    if (row_index >= profile -> sand_row)
+    {
+        return SAND;
+    }
+
+    // A tree's canopy may reach into the cells next to its own.
+    for (unsigned int i = 0; i < 3; i++)
+    {
+        if (_is_in_tree(&trees[i], row_index, column_index))
+        {
+            return WOOD;
+        }
+    }
+
+    return row_index >= (unsigned int) (height * WATER_LINE) ? WATER : AIR;
+}
+
+
+/*
+ * Generate every tile of a chunk into a sandbox.
+ *
+ * @param task - Sandbox and world to generate.
+ * @param chunk_index - Index of chunk, counting row by row.
+ */
+static void _generate_chunk(const struct WorldgenTask *task, unsigned int chunk_index)
+{
+    unsigned int chunk_columns = (task -> width + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    unsigned int row_start = chunk_index / chunk_columns * CHUNK_SIZE;
+    unsigned int column_start = chunk_index % chunk_columns * CHUNK_SIZE;
+    unsigned int row_end = row_start + CHUNK_SIZE < task -> height ? row_start + CHUNK_SIZE : task -> height;
+    unsigned int column_end = column_start + CHUNK_SIZE < task -> width ? column_start + CHUNK_SIZE : task -> width;
+
+    // Work out each column and tree once for the whole chunk, including the
+    // trees of the cells either side.
+    struct ColumnProfile profiles[CHUNK_SIZE];
+    struct Tree trees[CHUNK_SIZE / TREE_CELL + 4];
+    int first_cell = (int) (column_start / TREE_CELL) - 1;
+    int last_cell = (int) ((column_end - 1) / TREE_CELL) + 1;
+
+    for (unsigned int col = column_start; col < column_end; col++)
+    {
+        profiles[col - column_start] = _get_column_profile(task -> seed, task -> height, col);
+    }
+
+    for (int cell = first_cell; cell <= last_cell; cell++)
+    {
+        trees[cell - first_cell] = _get_tree(task -> seed, task -> height, task -> width, cell);
+    }
+
+    for (unsigned int row = row_start; row < row_end; row++)
+    {
+        for (unsigned int col = column_start; col < column_end; col++)
+        {
+            task -> sandbox[row][col] = _generate_profiled_tile(task -> seed,
+                    task -> height,
+                    &profiles[col - column_start],
+                    &trees[col / TREE_CELL - 1 - first_cell],
+                    row,
+                    col);
+        }
+    }
+}
+
+
+/*
+ * Generate every chunk assigned to a thread.
+ *
+ * @param argument - Pointer to the thread's WorldgenTask.
+ *
+ * @return - NULL.
+ */
+static void *_generate_chunks(void *argument)
+{
+    const struct WorldgenTask *task = (const struct WorldgenTask *) argument;
+    unsigned int chunk_rows = (task -> height + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    unsigned int chunk_columns = (task -> width + CHUNK_SIZE - 1) / CHUNK_SIZE;
+
+    for (unsigned int i = task -> first_chunk; i < chunk_rows * chunk_columns; i += task -> num_threads)
+    {
+        _generate_chunk(task, i);
+    }
+
+    return NULL;
+}
+
+
+// ----- PUBLIC FUNCTIONS -----
+
+
+void generate_world(unsigned char **sandbox,
+        unsigned int height,
+        unsigned int width,
+        unsigned int seed,
+        unsigned int num_threads)
+{
+    if (num_threads == 0)
+    {
+        num_threads = WORLDGEN_DEFAULT_THREADS;
+    }
+
+    if (num_threads > WORLDGEN_MAX_THREADS)
+    {
+        num_threads = WORLDGEN_MAX_THREADS;
+    }
+
+    struct WorldgenTask tasks[WORLDGEN_MAX_THREADS];
+    pthread_t threads[WORLDGEN_MAX_THREADS];
+    bool is_started[WORLDGEN_MAX_THREADS];
+
+    // Threads write to separate chunks, so need no locking.
+    for (unsigned int i = 0; i < num_threads; i++)
+    {
+        struct WorldgenTask task = {sandbox, height, width, seed, i, num_threads};
+        tasks[i] = task;
+        is_started[i] = i > 0 && pthread_create(&threads[i], NULL, _generate_chunks, &tasks[i]) == 0;
+    }
+
+    // The calling thread takes the first share, along with that of any
+    // thread which failed to start.
+    for (unsigned int i = 0; i < num_threads; i++)
+    {
+        if (!is_started[i])
+        {
+            _generate_chunks(&tasks[i]);
+        }
+    }
+
+    for (unsigned int i = 1; i < num_threads; i++)
+    {
+        if (is_started[i])
+        {
+            pthread_join(threads[i], NULL);
+        }
+    }
+
+    // Every tile was written directly.
+    wake_sandbox(sandbox);
+}
+
+
+unsigned char generate_tile(unsigned int seed,
+        unsigned int height,
+        unsigned int width,
+        unsigned int row_index,
+        unsigned int column_index)
+{
+    struct ColumnProfile profile = _get_column_profile(seed, height, column_index);
+    struct Tree trees[3];
+    int cell = column_index / TREE_CELL;
+
+    for (int i = 0; i < 3; i++)
+    {
+        trees[i] = _get_tree(seed, height, width, cell - 1 + i);
+    }
+
+    return _generate_profiled_tile(seed, height, &profile, trees, row_index, column_index);
+}
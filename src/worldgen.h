@@ -0,0 +1,61 @@
+#ifndef WORLDGEN_H
+#define WORLDGEN_H
+
+/*
+ * Procedural generation of large sandboxes, such as for benchmarks and demos.
+ *
+ * Generated worlds have hilly ground of wood, as the only solid tile, under
+ * sand dunes, with caves carved out of it and steam vents rising from the
+ * cave floors. Lakes fill the valleys below a water line, and forests of
+ * wood trees grow on dry ground.
+ *
+ * Every tile is a function of the seed and its own coordinates alone, so
+ * chunks are generated independently across threads, and the same seed
+ * always generates the same world, however many threads generate it.
+ *
+ */
+
+#include <pthread.h>
+#include "sandbox.h"
+
+// Number of threads generating chunks, unless told otherwise.
+#define WORLDGEN_DEFAULT_THREADS 4
+
+// Maximum number of threads generating chunks.
+#define WORLDGEN_MAX_THREADS 64
+
+
+/*
+ * Fill a sandbox with a generated world, replacing every tile.
+ *
+ * @param sandbox - Sandbox to fill.
+ * @param height, width - Dimensions of sandbox.
+ * @param seed - Seed of the world. The same seed and dimensions always make
+ * the same world.
+ * @param num_threads - Number of threads to generate chunks with, or 0 for
+ * WORLDGEN_DEFAULT_THREADS.
+ */
+void generate_world(unsigned char **sandbox,
+        unsigned int height,
+        unsigned int width,
+        unsigned int seed,
+        unsigned int num_threads);
+
+
+/*
+ * Return the tile generated at the given coordinates of a world.
+ *
+ * @param seed - Seed of the world.
+ * @param height, width - Dimensions of the world.
+ * @param row_index, column_index - Coordinates of tile.
+ *
+ * @return - Generated tile.
+ */
+unsigned char generate_tile(unsigned int seed,
+        unsigned int height,
+        unsigned int width,
+        unsigned int row_index,
+        unsigned int column_index);
+
+
+#endif